@@ -0,0 +1,134 @@
+﻿#include "Animation.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// ------------------------------
+// Tworzenie klipów
+// ------------------------------
+ClipId AnimationSystem::finishClip(std::size_t firstFrame, AnimationLoop loop) {
+    if (clips.size() >= InvalidClip)
+        throw std::runtime_error("AnimationSystem: too many clips");
+
+    AnimationClip clip;
+    clip.firstFrame = static_cast<std::uint32_t>(firstFrame);
+    clip.frameCount = static_cast<std::uint16_t>(frames.size() - firstFrame);
+    clip.loop = loop;
+
+    float t = 0.f;
+    for (std::size_t i = firstFrame; i < frames.size(); ++i) {
+        frames[i].start = t;
+        t += frames[i].duration;
+    }
+    clip.length = t;
+
+    clips.push_back(clip);
+    return static_cast<ClipId>(clips.size() - 1);
+}
+
+ClipId AnimationSystem::createClip(const std::vector<BitmapHandler>& bitmaps, float frameDuration, AnimationLoop loop) {
+    std::size_t first = frames.size();
+    for (const auto& bmp : bitmaps) {
+        auto tex = bmp.getTexture();
+        if (!tex) continue;
+        textures.push_back(bmp);
+        frames.push_back({ tex.get(), sf::IntRect({ 0, 0 }, sf::Vector2i(tex->getSize())), 0.f, frameDuration });
+    }
+    if (frames.size() == first)
+        throw std::runtime_error("AnimationSystem: clip has no valid frames");
+    return finishClip(first, loop);
+}
+
+ClipId AnimationSystem::createClip(const BitmapHandler& sheet, const std::vector<sf::IntRect>& rects, float frameDuration,
+    AnimationLoop loop)
+{
+    auto tex = sheet.getTexture();
+    if (!tex || rects.empty())
+        throw std::runtime_error("AnimationSystem: clip has no valid frames");
+
+    textures.push_back(sheet);
+    std::size_t first = frames.size();
+    for (const auto& rect : rects)
+        frames.push_back({ tex.get(), rect, 0.f, frameDuration });
+    return finishClip(first, loop);
+}
+
+// ------------------------------
+// Instancje
+// ------------------------------
+AnimationHandle AnimationSystem::play(ClipId clip, float speed) {
+    AnimationState state;
+    state.clip = clip;
+    state.speed = speed;
+
+    if (!freeSlots.empty()) {
+        AnimationHandle handle = freeSlots.back();
+        freeSlots.pop_back();
+        states[handle] = state;
+        return handle;
+    }
+    states.push_back(state);
+    return static_cast<AnimationHandle>(states.size() - 1);
+}
+
+void AnimationSystem::release(AnimationHandle handle) {
+    if (handle >= states.size() || states[handle].clip == InvalidClip) return;
+    states[handle] = AnimationState{};
+    freeSlots.push_back(handle);
+}
+
+void AnimationSystem::setClip(AnimationHandle handle, ClipId clip) {
+    AnimationState& s = states[handle];
+    if (s.clip == clip) return;
+    s.clip = clip;
+    s.time = 0.f;
+    s.frame = 0;
+}
+
+bool AnimationSystem::isFinished(AnimationHandle handle) const {
+    const AnimationState& s = states[handle];
+    const AnimationClip& c = clips[s.clip];
+    return c.loop == AnimationLoop::Once && s.time >= c.length;
+}
+
+// ------------------------------
+// Wspólny przebieg aktualizacji
+// ------------------------------
+void AnimationSystem::advance(float dt) {
+    const AnimationClip* clipData = clips.data();
+    const AnimationFrame* frameData = frames.data();
+
+    for (AnimationState& s : states) {
+        if (s.clip == InvalidClip || s.speed == 0.f) continue;
+        const AnimationClip& c = clipData[s.clip];
+        if (c.length <= 0.f) continue;
+
+        // Czas lokalny w klipie zależnie od trybu zapętlenia
+        float t = s.time + dt * s.speed;
+        float local;
+        switch (c.loop) {
+        case AnimationLoop::Loop:
+            t = std::fmod(t, c.length);
+            if (t < 0.f) t += c.length;
+            local = t;
+            break;
+        case AnimationLoop::PingPong:
+            t = std::fmod(t, 2.f * c.length);
+            if (t < 0.f) t += 2.f * c.length;
+            local = t < c.length ? t : 2.f * c.length - t;
+            break;
+        default: // Once
+            t = std::min(std::max(t, 0.f), c.length);
+            local = t;
+            break;
+        }
+        s.time = t;
+
+        // Wyszukiwanie klatki od ostatnio znanej — zwykle 0 lub 1 krok
+        const AnimationFrame* f = frameData + c.firstFrame;
+        unsigned int frame = s.frame;
+        while (frame + 1 < c.frameCount && local >= f[frame].start + f[frame].duration) ++frame;
+        while (frame > 0 && local < f[frame].start) --frame;
+        s.frame = static_cast<std::uint16_t>(frame);
+    }
+}
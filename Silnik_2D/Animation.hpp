@@ -0,0 +1,178 @@
+﻿#pragma once
+#include <SFML/Graphics.hpp>
+#include "BitmapHandler.hpp"
+#include <cstdint>
+#include <vector>
+
+using ClipId = std::uint16_t;          ///< Identyfikator klipu w AnimationSystem.
+using AnimationHandle = std::uint32_t; ///< Identyfikator instancji animacji.
+
+constexpr ClipId InvalidClip = 0xFFFF;                 ///< Brak klipu.
+constexpr AnimationHandle InvalidAnimation = 0xFFFFFFFF; ///< Brak instancji.
+
+/**
+ * @enum AnimationLoop
+ * @brief Sposób zapętlenia klipu.
+ *
+ * - Loop: po ostatniej klatce wraca do pierwszej.
+ * - Once: zatrzymuje się na ostatniej klatce.
+ * - PingPong: odtwarza klatki naprzemiennie w przód i w tył.
+ */
+enum class AnimationLoop : std::uint8_t { Loop, Once, PingPong };
+
+/**
+ * @struct AnimationFrame
+ * @brief Pojedyncza klatka klipu (tekstura, fragment i czas trwania).
+ */
+struct AnimationFrame {
+    const sf::Texture* texture = nullptr; ///< Tekstura klatki.
+    sf::IntRect rect;                     ///< Fragment tekstury (np. z arkusza sprite'ów).
+    float start = 0.f;                    ///< Początek klatki względem początku klipu.
+    float duration = 0.f;                 ///< Czas trwania klatki.
+};
+
+/**
+ * @struct AnimationClip
+ * @brief Niezmienny opis animacji współdzielony przez wszystkie instancje.
+ */
+struct AnimationClip {
+    std::uint32_t firstFrame = 0; ///< Indeks pierwszej klatki we wspólnej tablicy klatek.
+    std::uint16_t frameCount = 0; ///< Liczba klatek.
+    AnimationLoop loop = AnimationLoop::Loop; ///< Tryb zapętlenia.
+    float length = 0.f;           ///< Łączny czas klipu.
+};
+
+/**
+ * @struct AnimationState
+ * @brief Stan animacji jednej instancji (12 bajtów).
+ */
+struct AnimationState {
+    float time = 0.f;            ///< Czas od początku klipu.
+    float speed = 1.f;           ///< Mnożnik tempa (0 = pauza).
+    ClipId clip = InvalidClip;   ///< Odtwarzany klip (InvalidClip = wolne miejsce).
+    std::uint16_t frame = 0;     ///< Bieżąca klatka (pamięć podręczna wyszukiwania).
+};
+
+/**
+ * @class AnimationSystem
+ * @brief Centralny system animacji z klipami współdzielonymi przez aktorów.
+ *
+ * Klipy są tworzone raz i nie zmieniają się; aktor przechowuje jedynie
+ * uchwyt do swojego stanu (klip, czas, tempo). Wszystkie instancje są
+ * przesuwane w czasie jednym przebiegiem advance() po ciągłej tablicy stanów.
+ */
+class AnimationSystem {
+private:
+    std::vector<AnimationFrame> frames;  ///< Klatki wszystkich klipów (ciągle, klip po klipie).
+    std::vector<AnimationClip> clips;    ///< Opisy klipów.
+    std::vector<BitmapHandler> textures; ///< Utrzymanie tekstur klipów przy życiu.
+    std::vector<AnimationState> states;  ///< Stany instancji (indeksowane uchwytem).
+    std::vector<AnimationHandle> freeSlots; ///< Zwolnione miejsca do ponownego użycia.
+
+    /**
+     * @brief Dodaje klip zbudowany z klatek dopisanych na końcu tablicy frames.
+     * @param firstFrame Indeks pierwszej klatki.
+     * @param loop Tryb zapętlenia.
+     * @return Identyfikator klipu.
+     */
+    ClipId finishClip(std::size_t firstFrame, AnimationLoop loop);
+
+public:
+    /**
+     * @brief Tworzy klip z listy bitmap (jedna bitmapa = jedna klatka).
+     * @param bitmaps Bitmapy kolejnych klatek (puste są pomijane).
+     * @param frameDuration Czas trwania klatki w sekundach.
+     * @param loop Tryb zapętlenia.
+     * @return Identyfikator klipu.
+     */
+    ClipId createClip(const std::vector<BitmapHandler>& bitmaps, float frameDuration,
+        AnimationLoop loop = AnimationLoop::Loop);
+
+    /**
+     * @brief Tworzy klip z fragmentów jednego arkusza sprite'ów.
+     * @param sheet Arkusz sprite'ów.
+     * @param rects Fragmenty kolejnych klatek.
+     * @param frameDuration Czas trwania klatki w sekundach.
+     * @param loop Tryb zapętlenia.
+     * @return Identyfikator klipu.
+     */
+    ClipId createClip(const BitmapHandler& sheet, const std::vector<sf::IntRect>& rects, float frameDuration,
+        AnimationLoop loop = AnimationLoop::Loop);
+
+    /**
+     * @brief Zwraca opis klipu.
+     * @param clip Identyfikator klipu.
+     * @return Referencja do klipu.
+     */
+    const AnimationClip& getClip(ClipId clip) const { return clips[clip]; }
+
+    /**
+     * @brief Zwraca klatkę klipu.
+     * @param clip Identyfikator klipu.
+     * @param index Numer klatki w klipie.
+     * @return Referencja do klatki.
+     */
+    const AnimationFrame& getClipFrame(ClipId clip, std::size_t index) const {
+        return frames[clips[clip].firstFrame + index];
+    }
+
+    /**
+     * @brief Tworzy instancję odtwarzającą klip od początku.
+     * @param clip Identyfikator klipu.
+     * @param speed Mnożnik tempa.
+     * @return Uchwyt instancji.
+     */
+    AnimationHandle play(ClipId clip, float speed = 1.f);
+
+    /**
+     * @brief Zwalnia instancję.
+     * @param handle Uchwyt instancji.
+     */
+    void release(AnimationHandle handle);
+
+    /**
+     * @brief Zmienia klip instancji (bez efektu, jeśli klip jest ten sam).
+     * @param handle Uchwyt instancji.
+     * @param clip Nowy klip (odtwarzany od początku).
+     */
+    void setClip(AnimationHandle handle, ClipId clip);
+
+    /**
+     * @brief Ustawia tempo instancji.
+     * @param handle Uchwyt instancji.
+     * @param speed Mnożnik tempa (0 = pauza).
+     */
+    void setSpeed(AnimationHandle handle, float speed) { states[handle].speed = speed; }
+
+    /**
+     * @brief Przewija instancję na początek klipu.
+     * @param handle Uchwyt instancji.
+     */
+    void rewind(AnimationHandle handle) { states[handle].time = 0.f; states[handle].frame = 0; }
+
+    /**
+     * @brief Przesuwa w czasie wszystkie instancje.
+     * @param dt Czas w sekundach od poprzedniej klatki.
+     */
+    void advance(float dt);
+
+    /**
+     * @brief Zwraca bieżącą klatkę instancji.
+     * @param handle Uchwyt instancji.
+     * @return Referencja do klatki.
+     */
+    const AnimationFrame& getFrame(AnimationHandle handle) const {
+        const AnimationState& s = states[handle];
+        return frames[clips[s.clip].firstFrame + s.frame];
+    }
+
+    /**
+     * @brief Sprawdza, czy instancja klipu AnimationLoop::Once dobiegła końca.
+     * @param handle Uchwyt instancji.
+     * @return true jeśli osiągnięto ostatnią klatkę.
+     */
+    bool isFinished(AnimationHandle handle) const;
+
+    std::size_t getClipCount() const { return clips.size(); }                         ///< Liczba klipów.
+    std::size_t getInstanceCount() const { return states.size() - freeSlots.size(); } ///< Liczba aktywnych instancji.
+};
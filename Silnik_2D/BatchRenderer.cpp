@@ -0,0 +1,110 @@
+﻿#include "BatchRenderer.hpp"
+#include "RenderContext.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+constexpr std::size_t BatchHistoryBudget = 64u << 20; ///< Limit historii scen zawierających Undo/Redo.
+}
+
+// ------------------------------
+// Wątki robocze
+// ------------------------------
+BatchRenderer::BatchRenderer(unsigned int threads) {
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    workers.reserve(threads);
+    for (unsigned int i = 0; i < threads; ++i)
+        workers.emplace_back(&BatchRenderer::workerLoop, this);
+}
+
+BatchRenderer::~BatchRenderer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (auto& worker : workers)
+        if (worker.joinable())
+            worker.join();
+}
+
+void BatchRenderer::workerLoop() {
+    // Kontekst (i kontekst OpenGL) żyje i ginie w tym wątku
+    std::unique_ptr<RenderContext> context;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        jobReady.wait(lock, [this] { return stopping || !jobs.empty(); });
+        if (jobs.empty()) break; // stopping i pusta kolejka
+
+        RenderJob job = std::move(jobs.front());
+        jobs.pop_front();
+        ++busy;
+        lock.unlock();
+
+        RenderJobResult result = render(job, context);
+
+        lock.lock();
+        results.push_back(std::move(result));
+        --busy;
+        if (jobs.empty() && busy == 0)
+            idle.notify_all();
+    }
+    lock.unlock();
+    context.reset();
+}
+
+// ------------------------------
+// Renderowanie sceny
+// ------------------------------
+RenderJobResult BatchRenderer::render(const RenderJob& job, std::unique_ptr<RenderContext>& context) {
+    using Clock = std::chrono::steady_clock;
+    RenderJobResult result;
+    result.output = job.output;
+
+    Clock::time_point start = Clock::now();
+    if (!context || !context->reset(job.size, job.background))
+        context = std::make_unique<RenderContext>(job.size, job.background);
+
+    // Historia (odczyt kanwy po każdej klatce) tylko dla scen, które jej używają
+    bool undoable = std::any_of(job.commands.begin(), job.commands.end(), [](const DrawCommand& cmd) {
+        return cmd.type == CommandType::Undo || cmd.type == CommandType::Redo;
+    });
+    context->enableHistory(undoable ? BatchHistoryBudget : 0);
+
+    for (const DrawCommand& cmd : job.commands)
+        context->execute(cmd);
+    sf::Image image = context->capture();
+    if (job.postProcess)
+        job.postProcess(image);
+
+    Clock::time_point rendered = Clock::now();
+    result.success = SnapshotWriter::write(image, job.output, job.format);
+    result.renderSeconds = std::chrono::duration<float>(rendered - start).count();
+    result.encodeSeconds = std::chrono::duration<float>(Clock::now() - rendered).count();
+    return result;
+}
+
+// ------------------------------
+// Kolejka zleceń
+// ------------------------------
+void BatchRenderer::submit(RenderJob job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+    jobReady.notify_one();
+}
+
+void BatchRenderer::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return jobs.empty() && busy == 0; });
+}
+
+std::vector<RenderJobResult> BatchRenderer::collectResults() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<RenderJobResult> out;
+    out.swap(results);
+    return out;
+}
@@ -0,0 +1,111 @@
+﻿#pragma once
+#include <SFML/Graphics.hpp>
+#include "CommandLog.hpp"
+#include "SnapshotWriter.hpp"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class RenderContext;
+
+/**
+ * @struct RenderJob
+ * @brief Jedna niezależna scena do wyrenderowania poza ekranem.
+ */
+struct RenderJob {
+    std::vector<DrawCommand> commands;       ///< Polecenia sceny (FrameEnd rozdziela klatki).
+    std::string output;                      ///< Plik wynikowy.
+    sf::Vector2u size{ 800, 600 };           ///< Rozmiar kanwy.
+    sf::Color background = sf::Color::Black; ///< Kolor tła.
+    SnapshotFormat format = SnapshotFormat::Png; ///< Format zapisu.
+    /// Opcjonalna obróbka obrazu przed zapisem (np. FilterPipeline z jednym
+    /// wątkiem — równoległość zapewniają już wątki robocze).
+    std::function<void(sf::Image&)> postProcess;
+};
+
+/**
+ * @struct RenderJobResult
+ * @brief Wynik renderowania jednej sceny.
+ */
+struct RenderJobResult {
+    std::string output;        ///< Plik wynikowy.
+    bool success = false;      ///< Czy zapis się powiódł.
+    float renderSeconds = 0.f; ///< Czas rysowania i odczytu kanwy.
+    float encodeSeconds = 0.f; ///< Czas kodowania i zapisu.
+};
+
+/**
+ * @class BatchRenderer
+ * @brief Pula wątków renderujących niezależne sceny do plików.
+ *
+ * Każdy wątek ma własny RenderContext (a więc własny kontekst OpenGL),
+ * używany ponownie między zleceniami o tym samym rozmiarze kanwy.
+ * Zlecenia nie współdzielą stanu, więc przepustowość rośnie z liczbą rdzeni.
+ */
+class BatchRenderer {
+private:
+    mutable std::mutex mutex;               ///< Ochrona kolejki i wyników.
+    std::condition_variable jobReady;       ///< Sygnał pojawienia się zlecenia.
+    std::condition_variable idle;           ///< Sygnał zakończenia wszystkich zleceń.
+    std::deque<RenderJob> jobs;             ///< Oczekujące zlecenia.
+    std::vector<RenderJobResult> results;   ///< Zakończone zlecenia do odebrania.
+    std::size_t busy = 0;                   ///< Liczba wątków przetwarzających zlecenie.
+    bool stopping = false;                  ///< Flaga zakończenia wątków.
+    std::vector<std::thread> workers;       ///< Wątki robocze (inicjalizowane jako ostatnie).
+
+    /**
+     * @brief Pętla wątku roboczego.
+     */
+    void workerLoop();
+
+    /**
+     * @brief Renderuje scenę i zapisuje wynik.
+     * @param job Zlecenie.
+     * @param context Kontekst wątku (tworzony lub dopasowywany do rozmiaru).
+     * @return Wynik zlecenia.
+     */
+    static RenderJobResult render(const RenderJob& job, std::unique_ptr<RenderContext>& context);
+
+public:
+    /**
+     * @brief Uruchamia wątki robocze.
+     * @param threads Liczba wątków (0 = liczba rdzeni).
+     */
+    explicit BatchRenderer(unsigned int threads = 0);
+
+    /**
+     * @brief Kończy pracę po przetworzeniu oczekujących zleceń.
+     */
+    ~BatchRenderer();
+
+    BatchRenderer(const BatchRenderer&) = delete;
+    BatchRenderer& operator=(const BatchRenderer&) = delete;
+
+    /**
+     * @brief Dodaje scenę do kolejki.
+     * @param job Zlecenie.
+     */
+    void submit(RenderJob job);
+
+    /**
+     * @brief Czeka na zakończenie wszystkich zleconych scen.
+     */
+    void wait();
+
+    /**
+     * @brief Odbiera wyniki zakończonych zleceń.
+     * @return Lista wyników (od ostatniego wywołania).
+     */
+    std::vector<RenderJobResult> collectResults();
+
+    /**
+     * @brief Zwraca liczbę wątków roboczych.
+     * @return Liczba wątków.
+     */
+    std::size_t getThreadCount() const { return workers.size(); }
+};
@@ -0,0 +1,168 @@
+﻿#include "Behaviour.hpp"
+#include <algorithm>
+
+namespace {
+constexpr std::size_t MinTimerCompaction = 64; ///< Nieaktualne budziki tolerowane przed przebudową kopca.
+}
+
+// ------------------------------
+// Oczekiwanie w korutynach
+// ------------------------------
+void NextFrame::await_suspend(Behaviour::Handle h) {
+    scheduler = h.promise().scheduler;
+    scheduler->ready.push_back(h.promise().id);
+}
+
+float NextFrame::await_resume() const noexcept {
+    return scheduler ? scheduler->frameDt : 0.f;
+}
+
+void Sleep::await_suspend(Behaviour::Handle h) {
+    BehaviourScheduler& s = *h.promise().scheduler;
+    s.timers.push({ s.now + seconds, s.timerOrder++, h.promise().id });
+}
+
+void WaitEvent::await_suspend(Behaviour::Handle h) {
+    BehaviourScheduler& s = *h.promise().scheduler;
+    const BehaviourId id = h.promise().id;
+    s.waiting[event].push_back(id);
+    s.slots[id.index].event = event;
+    s.slots[id.index].waitingEvent = true;
+}
+
+// ------------------------------
+// Uruchamianie i zatrzymywanie
+// ------------------------------
+BehaviourId BehaviourScheduler::start(Behaviour behaviour) {
+    if (!behaviour.handle) return {};
+
+    std::uint32_t index;
+    if (!freeSlots.empty()) {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        index = static_cast<std::uint32_t>(slots.size());
+        slots.emplace_back();
+    }
+
+    Behaviour::Handle handle = std::exchange(behaviour.handle, {});
+    BehaviourId id{ index, slots[index].generation };
+    handle.promise().scheduler = this;
+    handle.promise().id = id;
+    slots[index].handle = handle;
+    ++alive;
+
+    resume(id);
+    return valid(id) ? id : BehaviourId{};
+}
+
+void BehaviourScheduler::stop(BehaviourId id) {
+    if (!valid(id)) return;
+    if (id == current) {
+        stopCurrent = true; // ramki wykonywanej korutyny nie można zniszczyć
+        return;
+    }
+    release(id.index);
+}
+
+void BehaviourScheduler::release(std::uint32_t index) {
+    Slot& slot = slots[index];
+    if (slot.waitingEvent) {
+        // Lista zdarzenia, które może nigdy nie nadejść, nie może rosnąć o zatrzymane zachowania
+        auto it = waiting.find(slot.event);
+        if (it != waiting.end()) {
+            auto& ids = it->second;
+            auto pos = std::find(ids.begin(), ids.end(), BehaviourId{ index, slot.generation });
+            if (pos != ids.end()) {
+                *pos = ids.back();
+                ids.pop_back();
+            }
+            if (ids.empty()) waiting.erase(it);
+        }
+        slot.waitingEvent = false;
+    }
+    slot.handle.destroy();
+    slot.handle = {};
+    ++slot.generation;
+    freeSlots.push_back(index);
+    --alive;
+}
+
+void BehaviourScheduler::resume(BehaviourId id) {
+    if (!valid(id)) return;
+
+    // Zagnieżdżone start() z wnętrza korutyny może przenieść slots — bez referencji
+    const BehaviourId outer = current;
+    const bool outerStop = stopCurrent;
+    current = id;
+    stopCurrent = false;
+    ++resumedLastTick;
+
+    try {
+        slots[id.index].handle.resume();
+    }
+    catch (...) {
+        current = outer;
+        stopCurrent = outerStop;
+        release(id.index);
+        throw;
+    }
+
+    if (stopCurrent || slots[id.index].handle.done())
+        release(id.index);
+    current = outer;
+    stopCurrent = outerStop;
+}
+
+// ------------------------------
+// Zdarzenia i klatki
+// ------------------------------
+void BehaviourScheduler::signal(BehaviourEvent event) {
+    auto it = waiting.find(event);
+    if (it == waiting.end()) return;
+    for (BehaviourId id : it->second)
+        slots[id.index].waitingEvent = false;
+    ready.insert(ready.end(), it->second.begin(), it->second.end());
+    waiting.erase(it);
+}
+
+void BehaviourScheduler::tick(float dt) {
+    now += dt;
+    frameDt = dt;
+    resumedLastTick = 0;
+
+    // Zachowania dodane do ready w trakcie wznawiania czekają do następnej klatki
+    resuming.clear();
+    resuming.swap(ready);
+    while (!timers.empty() && timers.top().wake <= now) {
+        if (valid(timers.top().id)) resuming.push_back(timers.top().id);
+        timers.pop();
+    }
+    if (timers.size() > 2 * alive + MinTimerCompaction)
+        compactTimers();
+
+    for (BehaviourId id : resuming)
+        resume(id);
+}
+
+void BehaviourScheduler::compactTimers() {
+    std::vector<Timer> live;
+    live.reserve(alive);
+    for (; !timers.empty(); timers.pop())
+        if (valid(timers.top().id)) live.push_back(timers.top());
+    timers = decltype(timers)(std::greater<Timer>(), std::move(live));
+}
+
+void BehaviourScheduler::clear() {
+    // Wywołane z wnętrza korutyny: ona sama zostanie zwolniona po zawieszeniu,
+    // a wpisy w resuming (iterowanym przez tick()) staną się nieaktualne
+    for (std::uint32_t i = 0; i < slots.size(); ++i) {
+        if (!slots[i].handle) continue;
+        if (BehaviourId{ i, slots[i].generation } == current) stopCurrent = true;
+        else release(i);
+    }
+    ready.clear();
+    timers = {};
+    waiting.clear();
+}
@@ -0,0 +1,273 @@
+﻿#pragma once
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class BehaviourScheduler;
+
+/**
+ * @struct BehaviourId
+ * @brief Uchwyt zachowania w BehaviourScheduler (indeks + generacja).
+ *
+ * Uchwyt zatrzymanego lub zakończonego zachowania jest nieważny —
+ * jego gniazdo ma już inną generację.
+ */
+struct BehaviourId {
+    std::uint32_t index = 0;      ///< Gniazdo w harmonogramie.
+    std::uint32_t generation = 0; ///< Generacja gniazda (0 = uchwyt pusty).
+
+    bool operator==(const BehaviourId& o) const { return index == o.index && generation == o.generation; }
+    bool operator!=(const BehaviourId& o) const { return !(*this == o); }
+};
+
+using BehaviourEvent = std::uint32_t; ///< Identyfikator zdarzenia, na które czekają zachowania.
+
+/**
+ * @class Behaviour
+ * @brief Zachowanie obiektu zapisane jako korutyna C++20.
+ *
+ * Funkcja zwracająca Behaviour może czekać na kolejną klatkę
+ * (co_await NextFrame{}), na upływ czasu (co_await Sleep{ sekundy })
+ * lub na zdarzenie (co_await WaitEvent{ id }). Korutyna nie rusza
+ * przed przekazaniem do BehaviourScheduler::start(), który wykonuje
+ * ją do pierwszego co_await i przejmuje jej ramkę.
+ */
+class Behaviour {
+public:
+    /**
+     * @struct promise_type
+     * @brief Obietnica korutyny — powiązanie z harmonogramem.
+     */
+    struct promise_type {
+        BehaviourScheduler* scheduler = nullptr; ///< Harmonogram, który wznawia korutynę.
+        BehaviourId id;                          ///< Uchwyt w harmonogramie.
+
+        Behaviour get_return_object() { return Behaviour(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { throw; }
+    };
+
+    using Handle = std::coroutine_handle<promise_type>; ///< Uchwyt ramki korutyny.
+
+private:
+    Handle handle; ///< Ramka korutyny (nieuruchomionej).
+
+    explicit Behaviour(Handle h) : handle(h) {}
+
+    friend class BehaviourScheduler;
+
+public:
+    Behaviour(Behaviour&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    Behaviour& operator=(Behaviour&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+    Behaviour(const Behaviour&) = delete;
+    Behaviour& operator=(const Behaviour&) = delete;
+
+    /**
+     * @brief Destruktor — niszczy korutynę, jeśli nie trafiła do harmonogramu.
+     */
+    ~Behaviour() {
+        if (handle) handle.destroy();
+    }
+};
+
+/**
+ * @struct NextFrame
+ * @brief Oczekiwanie na kolejną klatkę; co_await zwraca jej dt.
+ */
+struct NextFrame {
+    BehaviourScheduler* scheduler = nullptr; ///< Ustawiane przy zawieszeniu.
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(Behaviour::Handle h);
+    float await_resume() const noexcept;
+};
+
+/**
+ * @struct Sleep
+ * @brief Oczekiwanie przez podany czas (bez kosztu w klatkach pośrednich).
+ */
+struct Sleep {
+    float seconds = 0.f; ///< Czas oczekiwania.
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(Behaviour::Handle h);
+    void await_resume() const noexcept {}
+};
+
+/**
+ * @struct WaitEvent
+ * @brief Oczekiwanie na BehaviourScheduler::signal() ze zdarzeniem.
+ */
+struct WaitEvent {
+    BehaviourEvent event = 0; ///< Zdarzenie.
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(Behaviour::Handle h);
+    void await_resume() const noexcept {}
+};
+
+/**
+ * @struct BehaviourStats
+ * @brief Stan harmonogramu zachowań.
+ */
+struct BehaviourStats {
+    std::size_t alive = 0;       ///< Zachowania w toku.
+    std::size_t nextFrame = 0;   ///< Czekające na kolejną klatkę.
+    std::size_t sleeping = 0;    ///< Czekające na upływ czasu (z wpisami już nieaktualnymi).
+    std::size_t resumed = 0;     ///< Wznowienia w ostatnim tick().
+};
+
+/**
+ * @class BehaviourScheduler
+ * @brief Harmonogram korutyn zachowań — wznawia tylko te, które mają pracę.
+ *
+ * Zawieszone zachowania leżą w jednej z trzech kolejek: lista na kolejną
+ * klatkę, kopiec budzików uporządkowany czasem oraz listy zdarzeń.
+ * tick() zdejmuje jedynie listę klatki i budziki, których czas minął,
+ * więc uśpione zachowania nie kosztują nic do chwili wznowienia —
+ * koszt klatki zależy od liczby wznowień, nie od liczby zachowań.
+ *
+ * Zatrzymane zachowanie jest od razu usuwane z listy zdarzenia. Wpisy
+ * w liście klatki i w kopcu budzików są pomijane po generacji uchwytu
+ * przy zdjęciu, a kopiec jest przebudowywany, gdy nieaktualne wpisy
+ * zaczynają w nim przeważać.
+ */
+class BehaviourScheduler {
+private:
+    /**
+     * @struct Slot
+     * @brief Gniazdo ramki korutyny.
+     */
+    struct Slot {
+        Behaviour::Handle handle;     ///< Ramka (pusta = gniazdo wolne).
+        std::uint32_t generation = 1; ///< Generacja (rośnie przy zwolnieniu).
+        BehaviourEvent event = 0;     ///< Zdarzenie, na które czeka zachowanie.
+        bool waitingEvent = false;    ///< Czy zachowanie jest na liście waiting[event].
+    };
+
+    /**
+     * @struct Timer
+     * @brief Budzik zachowania uśpionego przez Sleep.
+     */
+    struct Timer {
+        double wake;         ///< Czas wznowienia.
+        std::uint64_t order; ///< Kolejność dodania (stała kolejność przy równych czasach).
+        BehaviourId id;      ///< Zachowanie.
+
+        bool operator>(const Timer& o) const { return wake != o.wake ? wake > o.wake : order > o.order; }
+    };
+
+    std::vector<Slot> slots;                 ///< Gniazda ramek.
+    std::vector<std::uint32_t> freeSlots;    ///< Wolne gniazda.
+    std::vector<BehaviourId> ready;          ///< Czekające na kolejną klatkę.
+    std::vector<BehaviourId> resuming;       ///< Wznawiane w bieżącym tick() (bufor wielokrotnego użytku).
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers; ///< Budziki.
+    std::unordered_map<BehaviourEvent, std::vector<BehaviourId>> waiting; ///< Oczekujący na zdarzenia.
+    double now = 0.0;                        ///< Czas harmonogramu [s].
+    float frameDt = 0.f;                     ///< dt bieżącej klatki.
+    std::uint64_t timerOrder = 0;            ///< Licznik kolejności budzików.
+    std::size_t alive = 0;                   ///< Zachowania w toku.
+    std::size_t resumedLastTick = 0;         ///< Wznowienia w ostatnim tick().
+    BehaviourId current;                     ///< Wykonywane zachowanie (puste poza resume()).
+    bool stopCurrent = false;                ///< stop() wywołane przez wykonywane zachowanie.
+
+    /**
+     * @brief Wznawia zachowanie i zwalnia je po zakończeniu.
+     * @param id Uchwyt (nieaktualny jest pomijany).
+     */
+    void resume(BehaviourId id);
+
+    /**
+     * @brief Niszczy ramkę i zwalnia gniazdo.
+     * @param index Gniazdo.
+     */
+    void release(std::uint32_t index);
+
+    /**
+     * @brief Usuwa z kopca budziki zwolnionych zachowań.
+     */
+    void compactTimers();
+
+    /**
+     * @brief Sprawdza ważność uchwytu.
+     */
+    bool valid(BehaviourId id) const {
+        return id.index < slots.size() && slots[id.index].generation == id.generation && slots[id.index].handle;
+    }
+
+    friend struct NextFrame;
+    friend struct Sleep;
+    friend struct WaitEvent;
+
+public:
+    BehaviourScheduler() = default;
+    BehaviourScheduler(const BehaviourScheduler&) = delete;
+    BehaviourScheduler& operator=(const BehaviourScheduler&) = delete;
+
+    /**
+     * @brief Destruktor — niszczy ramki zachowań w toku.
+     */
+    ~BehaviourScheduler() { clear(); }
+
+    /**
+     * @brief Uruchamia zachowanie (wykonuje je do pierwszego co_await).
+     * @param behaviour Korutyna.
+     * @return Uchwyt (pusty, jeśli zakończyła się od razu).
+     */
+    BehaviourId start(Behaviour behaviour);
+
+    /**
+     * @brief Zatrzymuje zachowanie (niszczy jego ramkę).
+     * @param id Uchwyt.
+     */
+    void stop(BehaviourId id);
+
+    /**
+     * @brief Sprawdza, czy zachowanie jest w toku.
+     * @param id Uchwyt.
+     * @return true jeśli się nie zakończyło i nie zostało zatrzymane.
+     */
+    bool isRunning(BehaviourId id) const { return valid(id); }
+
+    /**
+     * @brief Budzi zachowania czekające na zdarzenie (w najbliższym tick()).
+     * @param event Zdarzenie.
+     */
+    void signal(BehaviourEvent event);
+
+    /**
+     * @brief Przesuwa czas i wznawia zachowania, które mają pracę.
+     * @param dt Czas klatki w sekundach.
+     */
+    void tick(float dt);
+
+    /**
+     * @brief Zatrzymuje wszystkie zachowania.
+     */
+    void clear();
+
+    /**
+     * @brief Zwraca czas harmonogramu.
+     * @return Suma dt przekazanych do tick() [s].
+     */
+    double getTime() const { return now; }
+
+    /**
+     * @brief Zwraca stan harmonogramu.
+     * @return Statystyki.
+     */
+    BehaviourStats getStats() const { return { alive, ready.size(), timers.size(), resumedLastTick }; }
+};
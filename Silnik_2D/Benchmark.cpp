@@ -0,0 +1,398 @@
+﻿#include "Benchmark.hpp"
+#include "PrimitiveRenderer.hpp"
+#include "GameObject.hpp"
+#include "Animation.hpp"
+#include "SceneGraph.hpp"
+#include "ImageFilter.hpp"
+#include <SFML/OpenGL.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <thread>
+
+namespace {
+constexpr int WarmupRuns = 3;              ///< Przebiegi rozgrzewające (niemierzone).
+constexpr unsigned int InputSeed = 12345;  ///< Stałe ziarno danych wejściowych.
+
+/**
+ * @brief Skalarne rozmycie Gaussa — wzorzec poprawności dla FilterPipeline.
+ *
+ * Te same wagi i powielanie krawędzi co FilterPipeline::gaussianBlur, ale
+ * bez SSE/AVX i bez wątków.
+ */
+void scalarGaussianBlur(sf::Image& image, float sigma) {
+    const sf::Vector2u size = image.getSize();
+    const int w = static_cast<int>(size.x), h = static_cast<int>(size.y);
+    const int r = std::min(64, static_cast<int>(std::ceil(3.f * sigma)));
+    std::vector<float> weights;
+    float sum = 0.f;
+    for (int k = -r; k <= r; ++k) {
+        weights.push_back(std::exp(-(k * k) / (2.f * sigma * sigma)));
+        sum += weights.back();
+    }
+    for (float& weight : weights) weight /= sum;
+
+    auto clamp = [](int i, int n) { return std::clamp(i, 0, n - 1); };
+    const std::uint8_t* src = image.getPixelsPtr();
+    std::vector<float> pass(static_cast<std::size_t>(w) * h * 4);
+    for (int y = 0; y < h; ++y)
+        for (int x = 0; x < w; ++x)
+            for (int c = 0; c < 4; ++c) {
+                float acc = 0.f;
+                for (int k = -r; k <= r; ++k)
+                    acc += weights[k + r] * src[(static_cast<std::size_t>(y) * w + clamp(x + k, w)) * 4 + c] / 255.f;
+                pass[(static_cast<std::size_t>(y) * w + x) * 4 + c] = acc;
+            }
+
+    std::vector<std::uint8_t> out(pass.size());
+    for (int y = 0; y < h; ++y)
+        for (int x = 0; x < w; ++x)
+            for (int c = 0; c < 4; ++c) {
+                float acc = 0.f;
+                for (int k = -r; k <= r; ++k)
+                    acc += weights[k + r] * pass[(static_cast<std::size_t>(clamp(y + k, h)) * w + x) * 4 + c];
+                out[(static_cast<std::size_t>(y) * w + x) * 4 + c] = static_cast<std::uint8_t>(std::clamp(acc * 255.f + 0.5f, 0.f, 255.f));
+            }
+    image.resize(size, out.data());
+}
+
+/**
+ * @brief Największa różnica kanału między dwoma obrazami tego samego rozmiaru.
+ */
+int maxChannelDifference(const sf::Image& a, const sf::Image& b) {
+    const std::size_t bytes = static_cast<std::size_t>(a.getSize().x) * a.getSize().y * 4;
+    const std::uint8_t* pa = a.getPixelsPtr();
+    const std::uint8_t* pb = b.getPixelsPtr();
+    int worst = 0;
+    for (std::size_t i = 0; i < bytes; ++i)
+        worst = std::max(worst, std::abs(static_cast<int>(pa[i]) - static_cast<int>(pb[i])));
+    return worst;
+}
+}
+
+// ------------------------------
+// Konstruktor i pomiar
+// ------------------------------
+Benchmark::Benchmark(sf::Vector2u canvasSize, int repetitions)
+    : canvas(canvasSize), repetitions(std::max(1, repetitions)) {
+}
+
+void Benchmark::measure(const std::string& name, const std::string& variant,
+    std::vector<std::pair<std::string, double>> params,
+    const std::function<void()>& setup, const std::function<void()>& body, bool gpu)
+{
+    using clock = std::chrono::steady_clock;
+    std::vector<double> samples;
+    samples.reserve(repetitions);
+
+    for (int i = 0; i < WarmupRuns + repetitions; ++i) {
+        if (setup) setup();
+        if (gpu) glFinish();
+
+        auto start = clock::now();
+        body();
+        if (gpu) glFinish();
+        auto end = clock::now();
+
+        if (i >= WarmupRuns)
+            samples.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+    }
+
+    BenchmarkResult r;
+    r.name = name;
+    r.variant = variant;
+    r.params = std::move(params);
+    r.samples = samples.size();
+
+    std::sort(samples.begin(), samples.end());
+    r.minNs = samples.front();
+    r.maxNs = samples.back();
+    r.meanNs = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+    r.medianNs = samples.size() % 2 ? samples[samples.size() / 2]
+        : (samples[samples.size() / 2 - 1] + samples[samples.size() / 2]) / 2.0;
+    r.p95Ns = samples[std::min(samples.size() - 1, static_cast<std::size_t>(std::ceil(samples.size() * 0.95)) - 1)];
+    double var = 0.0;
+    for (double s : samples) var += (s - r.meanNs) * (s - r.meanNs);
+    r.stddevNs = std::sqrt(var / samples.size());
+
+    std::cout << "[Bench] " << name << (variant.empty() ? "" : " " + variant);
+    for (const auto& p : r.params) std::cout << " " << p.first << "=" << p.second;
+    std::cout << ": median " << r.medianNs / 1000.0 << " us\n";
+
+    results.push_back(std::move(r));
+}
+
+// ------------------------------
+// Przypadki testowe
+// ------------------------------
+void Benchmark::benchPoints() {
+    PrimitiveRenderer renderer(canvas);
+    const sf::Vector2u size = canvas.getSize();
+
+    for (int count : { 1000, 10000 }) {
+        std::mt19937 rng(InputSeed);
+        std::uniform_real_distribution<float> x(0.f, float(size.x)), y(0.f, float(size.y));
+        std::vector<sf::Vector2f> points(count);
+        for (auto& p : points) p = { x(rng), y(rng) };
+
+        measure("drawPoint", "", { { "count", count } },
+            [&] { canvas.clear(); },
+            [&] { for (const auto& p : points) renderer.drawPoint(p, sf::Color::White); });
+    }
+}
+
+void Benchmark::benchLines() {
+    PrimitiveRenderer renderer(canvas);
+    const sf::Vector2f center(canvas.getSize().x / 2.f, canvas.getSize().y / 2.f);
+    constexpr int LinesPerSample = 64;
+
+    for (float length : { 16.f, 128.f, 512.f }) {
+        for (float slope : { 0.f, 30.f, 45.f, 60.f, 90.f }) {
+            const float rad = slope * 3.14159265f / 180.f;
+            const sf::Vector2f dir(std::cos(rad) * length / 2.f, std::sin(rad) * length / 2.f);
+
+            measure("drawLine", "incremental", { { "length", length }, { "slopeDeg", slope }, { "count", LinesPerSample } },
+                [&] { canvas.clear(); },
+                [&] { for (int i = 0; i < LinesPerSample; ++i) renderer.drawLine(center - dir, center + dir, sf::Color::Cyan); });
+
+            measure("drawLine", "default", { { "length", length }, { "slopeDeg", slope }, { "count", LinesPerSample } },
+                [&] { canvas.clear(); },
+                [&] { for (int i = 0; i < LinesPerSample; ++i) renderer.drawLineDom(center - dir, center + dir, sf::Color::Cyan); });
+        }
+    }
+}
+
+void Benchmark::benchCircles() {
+    PrimitiveRenderer renderer(canvas);
+    const sf::Vector2f center(canvas.getSize().x / 2.f, canvas.getSize().y / 2.f);
+
+    for (float radius : { 8.f, 32.f, 128.f, 384.f }) {
+        measure("drawCircle", "", { { "radius", radius } },
+            [&] { canvas.clear(); },
+            [&] { renderer.drawCircle(center, radius, sf::Color::Green, sf::Color::Green); });
+
+        measure("drawElips", "", { { "rx", radius }, { "ry", radius / 2.f } },
+            [&] { canvas.clear(); },
+            [&] { renderer.drawElips(center, radius, radius / 2.f, sf::Color::Red, sf::Color::Red); });
+    }
+}
+
+void Benchmark::benchFills() {
+    PrimitiveRenderer renderer(canvas);
+    const sf::Vector2f center(canvas.getSize().x / 2.f, canvas.getSize().y / 2.f);
+
+    for (float side : { 64.f, 256.f, 1000.f }) {
+        const sf::Vector2f origin = center - sf::Vector2f(side / 2.f, side / 2.f);
+
+        // Prostokąt z białą ramką
+        auto drawRect = [&] {
+            canvas.clear(sf::Color::Black);
+            sf::RectangleShape frame({ side - 2.f, side - 2.f });
+            frame.setPosition(origin + sf::Vector2f(1.f, 1.f));
+            frame.setFillColor(sf::Color::Black);
+            frame.setOutlineColor(sf::Color::White);
+            frame.setOutlineThickness(1.f);
+            canvas.draw(frame);
+            canvas.display();
+        };
+
+        // "Grzebień" — naprzemienne ścianki wymuszające wąski, kręty obszar
+        auto drawComb = [&] {
+            drawRect();
+            for (float x = 8.f; x < side - 8.f; x += 8.f) {
+                bool fromTop = static_cast<int>(x / 8.f) % 2 == 0;
+                sf::RectangleShape wall({ 1.f, side - 8.f });
+                wall.setPosition(origin + sf::Vector2f(x, fromTop ? 0.f : 8.f));
+                wall.setFillColor(sf::Color::White);
+                canvas.draw(wall);
+            }
+            canvas.display();
+        };
+
+        const sf::Vector2f seed = origin + sf::Vector2f(4.f, 4.f);
+        for (auto shape : { std::make_pair("rect", std::function<void()>(drawRect)),
+                            std::make_pair("comb", std::function<void()>(drawComb)) }) {
+            measure("flood_fill", shape.first, { { "size", side } }, shape.second,
+                [&] { renderer.flood_fill(seed, sf::Color::Blue, sf::Color::Black); });
+            measure("boundry_fill", shape.first, { { "size", side } }, shape.second,
+                [&] { renderer.boundry_fill(seed, sf::Color::Blue, sf::Color::White); });
+        }
+    }
+}
+
+void Benchmark::benchPolylines() {
+    PrimitiveRenderer renderer(canvas);
+    const sf::Vector2u size = canvas.getSize();
+
+    for (int vertices : { 8, 64, 512 }) {
+        std::mt19937 rng(InputSeed);
+        std::uniform_real_distribution<float> x(0.f, float(size.x)), y(0.f, float(size.y));
+        std::vector<sf::Vector2f> points(vertices);
+        for (auto& p : points) p = { x(rng), y(rng) };
+
+        measure("drawPolyline", "", { { "vertices", vertices } },
+            [&] { canvas.clear(); },
+            [&] { renderer.drawPolyline(points, sf::Color::Magenta); });
+    }
+}
+
+void Benchmark::benchTransforms() {
+    for (int population : { 1000, 10000, 100000 }) {
+        std::mt19937 rng(InputSeed);
+        std::uniform_real_distribution<float> coord(0.f, 1000.f);
+
+        std::vector<std::pair<std::string, std::vector<std::unique_ptr<TransformableObject>>>> groups;
+        groups.emplace_back("Point", std::vector<std::unique_ptr<TransformableObject>>{});
+        groups.emplace_back("Line", std::vector<std::unique_ptr<TransformableObject>>{});
+        groups.emplace_back("CircleShapeObject", std::vector<std::unique_ptr<TransformableObject>>{});
+        for (int i = 0; i < population; ++i) {
+            groups[0].second.push_back(std::make_unique<Point>(coord(rng), coord(rng)));
+            groups[1].second.push_back(std::make_unique<Line>(sf::Vector2f(coord(rng), coord(rng)), sf::Vector2f(coord(rng), coord(rng))));
+            groups[2].second.push_back(std::make_unique<CircleShapeObject>(sf::Vector2f(coord(rng), coord(rng)), 10.f));
+        }
+
+        for (auto& group : groups) {
+            auto& objects = group.second;
+            measure("translate", group.first, { { "population", population } }, nullptr,
+                [&] { for (auto& o : objects) o->translate(1.f, -1.f); }, false);
+            measure("rotate", group.first, { { "population", population } }, nullptr,
+                [&] { for (auto& o : objects) o->rotate(1.f, { 500.f, 500.f }); }, false);
+        }
+    }
+}
+
+void Benchmark::benchHierarchy() {
+    for (int population : { 1000, 10000, 100000 }) {
+        std::mt19937 rng(InputSeed);
+        std::uniform_real_distribution<float> coord(0.f, 1000.f);
+
+        SceneGraph graph;
+        SceneNodeId parent = graph.create();
+        std::vector<SceneNodeId> children;
+        for (int i = 0; i < population; ++i) {
+            children.push_back(graph.create(parent));
+            graph.setPosition(children.back(), { coord(rng), coord(rng) });
+        }
+        graph.updateWorld();
+
+        // Jedna zmiana rodzica + odczyt macierzy świata wszystkich dzieci (jak przy rysowaniu)
+        measure("hierarchy", "moveParent", { { "population", population } }, nullptr,
+            [&] {
+                graph.move(parent, { 1.f, -1.f });
+                for (SceneNodeId c : children) graph.getWorld(c);
+            }, false);
+        measure("hierarchy", "moveEachChild", { { "population", population } }, nullptr,
+            [&] {
+                for (SceneNodeId c : children) graph.move(c, { 1.f, -1.f });
+                for (SceneNodeId c : children) graph.getWorld(c);
+            }, false);
+    }
+}
+
+void Benchmark::benchAnimations() {
+    BitmapHandler sheet;
+    sheet.create(256, 32, sf::Color::White);
+    std::vector<sf::IntRect> rects;
+    for (int i = 0; i < 8; ++i) rects.push_back(sf::IntRect({ i * 32, 0 }, { 32, 32 }));
+
+    for (int population : { 1000, 10000, 100000 }) {
+        AnimationSystem system;
+        ClipId loop = system.createClip(sheet, rects, 0.1f, AnimationLoop::Loop);
+        ClipId pingPong = system.createClip(sheet, rects, 0.1f, AnimationLoop::PingPong);
+
+        std::mt19937 rng(InputSeed);
+        std::uniform_real_distribution<float> speed(0.5f, 2.f);
+        for (int i = 0; i < population; ++i)
+            system.play(i % 2 ? loop : pingPong, speed(rng));
+
+        measure("animationAdvance", "", { { "population", population } }, nullptr,
+            [&] { system.advance(1.f / 60.f); }, false);
+    }
+}
+
+void Benchmark::benchFilters() {
+    constexpr unsigned int Side = 512;
+    std::mt19937 rng(InputSeed);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::vector<std::uint8_t> noise(static_cast<std::size_t>(Side) * Side * 4);
+    for (auto& b : noise) b = static_cast<std::uint8_t>(byte(rng));
+    const sf::Image input({ Side, Side }, noise.data());
+
+    for (float sigma : { 1.f, 4.f }) {
+        // Poprawność: SIMD (z wątkami) wobec wzorca skalarnego; różnica do 1 to zaokrąglenia
+        sf::Image reference = input, simd = input;
+        scalarGaussianBlur(reference, sigma);
+        FilterPipeline threaded;
+        threaded.gaussianBlur(sigma);
+        threaded.apply(simd);
+        const int error = maxChannelDifference(reference, simd);
+        if (error > 1)
+            std::cerr << "[Bench] gaussianBlur sigma=" << sigma << ": SIMD differs from scalar by " << error << std::endl;
+
+        sf::Image image = input;
+        measure("gaussianBlur", "scalar", { { "size", Side }, { "sigma", sigma } },
+            [&] { image = input; },
+            [&] { scalarGaussianBlur(image, sigma); }, false);
+
+        FilterPipeline single(1);
+        single.gaussianBlur(sigma);
+        measure("gaussianBlur", "simd", { { "size", Side }, { "sigma", sigma }, { "threads", 1 }, { "maxError", double(error) } },
+            [&] { image = input; },
+            [&] { single.apply(image); }, false);
+
+        // Wątki pomocnicze potoku żyją między wywołaniami apply()
+        measure("gaussianBlur", "simdThreaded", { { "size", Side }, { "sigma", sigma }, { "threads", double(std::max(1u, std::thread::hardware_concurrency())) }, { "maxError", double(error) } },
+            [&] { image = input; },
+            [&] { threaded.apply(image); }, false);
+    }
+}
+
+void Benchmark::runAll() {
+    results.clear();
+    benchPoints();
+    benchLines();
+    benchCircles();
+    benchFills();
+    benchPolylines();
+    benchTransforms();
+    benchHierarchy();
+    benchAnimations();
+    benchFilters();
+}
+
+// ------------------------------
+// Zapis wyników (JSON)
+// ------------------------------
+bool Benchmark::writeJson(const std::string& filename) const {
+    std::ofstream out(filename);
+    if (!out) return false;
+
+    const sf::Vector2u size = canvas.getSize();
+    out << "{\n  \"canvas\": [" << size.x << ", " << size.y << "],\n"
+        << "  \"repetitions\": " << repetitions << ",\n  \"results\": [\n";
+
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        out << "    { \"name\": \"" << r.name << "\", \"variant\": \"" << r.variant << "\", \"params\": {";
+        for (std::size_t p = 0; p < r.params.size(); ++p)
+            out << (p ? ", " : " ") << "\"" << r.params[p].first << "\": " << r.params[p].second;
+        out << (r.params.empty() ? "}" : " }")
+            << ", \"samples\": " << r.samples
+            << ", \"mean_ns\": " << r.meanNs
+            << ", \"median_ns\": " << r.medianNs
+            << ", \"stddev_ns\": " << r.stddevNs
+            << ", \"min_ns\": " << r.minNs
+            << ", \"max_ns\": " << r.maxNs
+            << ", \"p95_ns\": " << r.p95Ns
+            << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,91 @@
+﻿#pragma once
+#include <SFML/Graphics.hpp>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct BenchmarkResult
+ * @brief Podsumowanie statystyczne pojedynczego przypadku testowego.
+ *
+ * Wszystkie czasy podawane są w nanosekundach na jedną próbkę.
+ */
+struct BenchmarkResult {
+    std::string name;    ///< Nazwa mierzonej operacji (np. "drawLine").
+    std::string variant; ///< Wariant (np. kształt obszaru, typ obiektu).
+    std::vector<std::pair<std::string, double>> params; ///< Parametry przypadku.
+    std::size_t samples = 0; ///< Liczba próbek.
+    double meanNs = 0.0;     ///< Średnia.
+    double medianNs = 0.0;   ///< Mediana.
+    double stddevNs = 0.0;   ///< Odchylenie standardowe.
+    double minNs = 0.0;      ///< Minimum.
+    double maxNs = 0.0;      ///< Maksimum.
+    double p95Ns = 0.0;      ///< 95. percentyl.
+};
+
+/**
+ * @class Benchmark
+ * @brief Zestaw mikrobenchmarków PrimitiveRenderer, wypełnień, transformacji i filtrów.
+ *
+ * Każdy przypadek jest sparametryzowany i wykonywany na tych samych,
+ * deterministycznych danych wejściowych (stałe ziarno generatora), dzięki
+ * czemu wyniki różnych wersji renderera można porównywać bezpośrednio.
+ * Czas próbki obejmuje wykonanie operacji i synchronizację z GPU (glFinish),
+ * przygotowanie kanwy nie jest mierzone.
+ */
+class Benchmark {
+private:
+    sf::RenderTexture canvas;              ///< Kanwa pozaekranowa.
+    int repetitions;                       ///< Liczba mierzonych próbek na przypadek.
+    std::vector<BenchmarkResult> results;  ///< Zebrane wyniki.
+
+    /**
+     * @brief Mierzy pojedynczy przypadek i zapisuje wynik.
+     * @param name Nazwa operacji.
+     * @param variant Wariant przypadku.
+     * @param params Parametry przypadku.
+     * @param setup Przygotowanie kanwy przed próbką (niemierzone).
+     * @param body Mierzona operacja.
+     * @param gpu Czy czekać na zakończenie pracy GPU po każdej próbce.
+     */
+    void measure(const std::string& name, const std::string& variant,
+        std::vector<std::pair<std::string, double>> params,
+        const std::function<void()>& setup, const std::function<void()>& body, bool gpu = true);
+
+    void benchPoints();     ///< Przepustowość drawPoint.
+    void benchLines();      ///< drawLine / drawLineDom wg długości i nachylenia.
+    void benchCircles();    ///< drawCircle / drawElips wg promienia.
+    void benchFills();      ///< flood_fill / boundry_fill wg rozmiaru i kształtu obszaru.
+    void benchPolylines();  ///< drawPolyline wg liczby wierzchołków.
+    void benchTransforms(); ///< translate / rotate dla populacji obiektów.
+    void benchHierarchy();  ///< Przesunięcie rodzica w SceneGraph vs przesuwanie każdego dziecka.
+    void benchAnimations(); ///< AnimationSystem::advance dla populacji aktorów.
+    void benchFilters();    ///< FilterPipeline::gaussianBlur: skalarnie, SIMD i SIMD z wątkami (z kontrolą zgodności).
+
+public:
+    /**
+     * @brief Konstruktor.
+     * @param canvasSize Rozmiar kanwy pozaekranowej.
+     * @param repetitions Liczba próbek na przypadek.
+     */
+    explicit Benchmark(sf::Vector2u canvasSize = { 1024, 1024 }, int repetitions = 30);
+
+    /**
+     * @brief Uruchamia wszystkie przypadki.
+     */
+    void runAll();
+
+    /**
+     * @brief Zapisuje wyniki w formacie JSON.
+     * @param filename Plik wynikowy.
+     * @return true jeśli zapis się powiódł.
+     */
+    bool writeJson(const std::string& filename) const;
+
+    /**
+     * @brief Zwraca zebrane wyniki.
+     * @return Lista wyników.
+     */
+    const std::vector<BenchmarkResult>& getResults() const { return results; }
+};
@@ -2,27 +2,116 @@
 #include <SFML/Graphics.hpp>
 #include <string>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <filesystem>
 #include <iostream>
+#include "Resampler.hpp"
+#include "TextureTracker.hpp"
 
 /**
  * @class BitmapHandler
  * @brief Klasa pomocnicza do obsługi bitmap (tekstur) w SFML.
  *
  * Umożliwia wczytywanie, zapisywanie, tworzenie, kopiowanie
- * i czyszczenie obiektów typu sf::Texture. Przechowuje teksturę
- * wewnątrz inteligentnego wskaźnika std::shared_ptr.
+ * i czyszczenie bitmap. Bitmapa ma dwie reprezentacje:
+ * - opcjonalny bufor pikseli po stronie CPU (sf::Image),
+ * - teksturę na GPU (sf::Texture).
+ *
+ * Obie leżą we wspólnym bloku współdzielonym przez std::shared_ptr między
+ * kopiami uchwytu (kopiowanie jest O(1)). Tekstura wysłana leniwie przez
+ * jedną kopię służy więc wszystkim. Zapis przez editPixels() odłącza blok
+ * (copy-on-write), a nieaktualna tekstura jest wysyłana na GPU dopiero
+ * przy getTexture(). Odczyt z GPU (copyToImage) następuje tylko wtedy,
+ * gdy bufor CPU nie istnieje, np. po releasePixels().
  */
 class BitmapHandler {
 private:
     /**
-     * @brief Udostępniana tekstura.
+     * @struct Storage
+     * @brief Piksele i tekstura współdzielone między kopiami uchwytu.
+     */
+    struct Storage {
+        /**
+         * @brief Bufor pikseli po stronie CPU (pusty po releasePixels()).
+         */
+        std::optional<sf::Image> pixels;
+
+        /**
+         * @brief Udostępniana tekstura.
+         *
+         * Przechowywana jako std::shared_ptr, aby obiekty rysujące mogły ją
+         * utrzymać przy życiu. Tekstura trzymana poza blokiem (getTexture())
+         * nigdy nie jest modyfikowana w miejscu.
+         */
+        std::shared_ptr<sf::Texture> texture;
+
+        bool textureStale = false; ///< Czy piksele CPU są nowsze niż tekstura.
+    };
+
+    /**
+     * @brief Blok danych bitmapy (nullptr jeśli brak bitmapy).
+     *
+     * Współdzielony między kopiami uchwytu do pierwszego zapisu.
+     */
+    std::shared_ptr<Storage> storage;
+
+    /**
+     * @brief Piramida mipmap (nullptr jeśli nie zbudowana).
      *
-     * Przechowywana jako std::shared_ptr, aby umożliwić współdzielenie
-     * tekstur między różnymi obiektami bez kopiowania dużych danych.
+     * Zbudowana z pikseli w chwili buildMips(); każda zmiana pikseli ją usuwa.
      */
-    std::shared_ptr<sf::Texture> texture;
+    std::shared_ptr<const MipPyramid> mips;
+
+    std::string tag;                   ///< Właściciel tekstury w TextureTracker.
+
+    /**
+     * @brief Wysyła piksele na GPU, jeśli tekstura jest nieaktualna.
+     * @return true jeśli tekstura jest aktualna.
+     */
+    bool upload() const {
+        if (!storage) return false;
+        Storage& s = *storage;
+        if (!s.textureStale) return static_cast<bool>(s.texture);
+        if (!s.pixels) return false;
+
+        auto& tracker = TextureTracker::get();
+        if (s.texture && s.texture.use_count() == 1 && s.texture->getSize() == s.pixels->getSize()) {
+            s.texture->update(*s.pixels);
+        }
+        else {
+            auto fresh = tracker.create(tag);
+            if (!fresh->loadFromImage(*s.pixels))
+                return false;
+            tracker.refresh(fresh.get());
+            s.texture = std::move(fresh);
+        }
+        s.textureStale = false;
+        return true;
+    }
+
+    /**
+     * @brief Odczytuje piksele z GPU, jeśli bufor CPU nie istnieje.
+     * @return true jeśli bufor CPU jest dostępny.
+     */
+    bool readback() const {
+        if (!storage) return false;
+        if (storage->pixels) return true;
+        if (!storage->texture) return false;
+        storage->pixels = storage->texture->copyToImage();
+        return true;
+    }
+
+    /**
+     * @brief Zastępuje blok nowym, z samymi pikselami (tekstura do wysłania).
+     * @param image Nowe piksele.
+     */
+    void replacePixels(sf::Image image) {
+        storage = std::make_shared<Storage>();
+        storage->pixels = std::move(image);
+        storage->textureStale = true;
+        mips.reset();
+    }
 
 public:
     /**
@@ -33,7 +122,10 @@ public:
     BitmapHandler() = default;
 
     /**
-     * @brief Wczytuje teksturę z pliku.
+     * @brief Wczytuje bitmapę z pliku.
+     *
+     * Piksele zostają w buforze CPU, tekstura jest tworzona od razu —
+     * obraz przekraczający limit tekstury GPU daje false.
      *
      * @param filename Ścieżka do pliku graficznego.
      * @return true jeśli udało się wczytać plik, w przeciwnym razie false.
@@ -42,64 +134,179 @@ public:
      * wraz z informacją o bieżącym katalogu roboczym.
      */
     bool loadFromFile(const std::string& filename) {
-        texture = std::make_shared<sf::Texture>();
-        if (!texture->loadFromFile(filename)) {
+        clear();
+        tag = filename;
+        sf::Image image;
+        if (!image.loadFromFile(filename)) {
             std::cout << "ERROR: Cannot load file: " << filename << "\n";
             std::cout << "Current working dir: "
                 << std::filesystem::current_path().string() << "\n";
+            return false;
+        }
 
-            texture.reset();
+        replacePixels(std::move(image));
+        if (!upload()) {
+            std::cout << "ERROR: Cannot create texture for: " << filename << "\n";
+            clear();
             return false;
         }
         return true;
     }
 
     /**
-     * @brief Zapisuje aktualną teksturę do pliku.
+     * @brief Zapisuje bitmapę do pliku.
+     *
+     * Korzysta z bufora CPU; odczyt z GPU tylko, gdy bufora brak.
      *
      * @param filename Nazwa pliku wynikowego.
-     * @return true jeśli zapis się powiódł, false jeśli brak tekstury lub błąd.
+     * @return true jeśli zapis się powiódł, false jeśli brak bitmapy lub błąd.
      */
     bool saveToFile(const std::string& filename) const {
-        if (!texture) return false;
-        sf::Image img = texture->copyToImage();
-        return img.saveToFile(filename);
+        if (!readback()) return false;
+        return storage->pixels->saveToFile(filename);
     }
 
     /**
-     * @brief Tworzy nową teksturę o podanym rozmiarze i kolorze wypełnienia.
+     * @brief Tworzy nową bitmapę o podanym rozmiarze i kolorze wypełnienia.
+     *
+     * Tekstura powstaje leniwie, przy pierwszym getTexture().
      *
-     * @param width  Szerokość tworzonej tekstury.
-     * @param height Wysokość tworzonej tekstury.
+     * @param width  Szerokość tworzonej bitmapy.
+     * @param height Wysokość tworzonej bitmapy.
      * @param color  Kolor, którym ma zostać wypełniona. Domyślnie przezroczysty.
      */
     void create(unsigned int width, unsigned int height, sf::Color color = sf::Color::Transparent) {
-        texture = std::make_shared<sf::Texture>();
-        sf::Image img({ width, height }, color);
-        texture->loadFromImage(img);
+        clear();
+        tag = "BitmapHandler::create";
+        replacePixels(sf::Image(sf::Vector2u{ width, height }, color));
     }
 
     /**
-     * @brief Usuwa aktualnie przechowywaną teksturę.
+     * @brief Usuwa bitmapę (bufor CPU i teksturę).
      */
-    void clear() { texture.reset(); }
+    void clear() {
+        storage.reset();
+        mips.reset();
+    }
 
     /**
-     * @brief Zwraca wskaźnik do aktualnej tekstury.
+     * @brief Zwalnia bufor CPU, zostawiając samą teksturę.
      *
-     * @return std::shared_ptr<sf::Texture> lub nullptr jeśli brak tekstury.
+     * Dotyczy wszystkich kopii współdzielących blok; kolejny odczyt
+     * pikseli pobierze je z GPU.
      */
-    std::shared_ptr<sf::Texture> getTexture() const { return texture; }
+    void releasePixels() {
+        if (upload()) storage->pixels.reset();
+    }
 
     /**
-     * @brief Kopiuje teksturę z innego obiektu BitmapHandler.
+     * @brief Zwraca aktualną teksturę, wysyłając piksele na GPU w razie potrzeby.
+     *
+     * @return std::shared_ptr<const sf::Texture> lub nullptr jeśli brak tekstury.
+     */
+    std::shared_ptr<const sf::Texture> getTexture() const {
+        return upload() ? storage->texture : nullptr;
+    }
+
+    /**
+     * @brief Zwraca piksele do odczytu, pobierając je z GPU w razie potrzeby.
+     *
+     * @return Wskaźnik do obrazu lub nullptr jeśli brak bitmapy.
+     */
+    const sf::Image* getPixels() const {
+        return readback() ? &*storage->pixels : nullptr;
+    }
+
+    /**
+     * @brief Zwraca piksele do zapisu.
+     *
+     * Współdzielony blok jest najpierw kopiowany (copy-on-write) — bez
+     * tekstury, którą zachowują pozostałe kopie — a tekstura oznaczana
+     * jako nieaktualna. Referencja jest ważna
+     * do następnego kopiowania lub modyfikacji uchwytu.
+     *
+     * @return Obraz do modyfikacji.
+     * @throws std::runtime_error jeśli brak bitmapy.
+     */
+    sf::Image& editPixels() {
+        if (!readback())
+            throw std::runtime_error("BitmapHandler: No bitmap to edit");
+        if (storage.use_count() > 1)
+            replacePixels(*storage->pixels);
+        storage->textureStale = true;
+        mips.reset();
+        return *storage->pixels;
+    }
+
+    /**
+     * @brief Zmienia rozmiar bitmapy z filtrowaniem.
+     *
+     * Kopie uchwytu współdzielące blok zachowują stary obraz.
+     *
+     * @param size Nowy rozmiar.
+     * @param filter Filtr.
+     * @return false jeśli brak bitmapy.
+     */
+    bool resize(sf::Vector2u size, ResampleFilter filter = ResampleFilter::Bilinear) {
+        if (!readback()) return false;
+        replacePixels(Resampler().resize(*storage->pixels, size, filter));
+        return true;
+    }
+
+    /**
+     * @brief Buduje piramidę mipmap z bieżących pikseli.
+     *
+     * Obiekty rysujące bitmapę w pomniejszeniu wybierają poziom piramidy
+     * zamiast próbkować pełną rozdzielczość.
+     *
+     * @param filter Filtr pomniejszania (Box — najszybszy).
+     * @return false jeśli brak bitmapy lub tekstury.
+     */
+    bool buildMips(ResampleFilter filter = ResampleFilter::Box) {
+        if (!readback() || !upload()) return false;
+        mips = MipPyramid::build(*storage->pixels, storage->texture, filter, tag);
+        return true;
+    }
+
+    /**
+     * @brief Zwraca piramidę mipmap.
+     * @return Piramida lub nullptr jeśli nie zbudowana (albo piksele zmieniono po budowie).
+     */
+    std::shared_ptr<const MipPyramid> getMips() const { return mips; }
+
+    /**
+     * @brief Ustawia kolor pojedynczego piksela.
+     * @param position Pozycja piksela.
+     * @param color Nowy kolor.
+     */
+    void setPixel(sf::Vector2u position, sf::Color color) {
+        editPixels().setPixel(position, color);
+    }
+
+    /**
+     * @brief Zwraca rozmiar bitmapy.
+     * @return Rozmiar w pikselach lub (0, 0) jeśli brak bitmapy.
+     */
+    sf::Vector2u getSize() const {
+        if (!storage) return {};
+        if (storage->pixels) return storage->pixels->getSize();
+        return storage->texture ? storage->texture->getSize() : sf::Vector2u{};
+    }
+
+    /**
+     * @brief Kopiuje bitmapę z innego obiektu BitmapHandler.
+     *
+     * Kopia współdzieli blok pikseli i tekstury z oryginałem (O(1)),
+     * aż któryś z nich zostanie zmodyfikowany.
      *
-     * @param other Obiekt, z którego tekstura ma zostać skopiowana.
+     * @param other Obiekt, z którego bitmapa ma zostać skopiowana.
      *
-     * Jeśli obiekt `other` nie ma tekstury — operacja jest pomijana.
+     * Jeśli obiekt `other` nie ma bitmapy — operacja jest pomijana.
      */
     void copyFrom(const BitmapHandler& other) {
-        if (!other.texture) return;
-        texture = std::make_shared<sf::Texture>(*other.texture);
+        if (!other.storage) return;
+        storage = other.storage;
+        mips = other.mips;
+        tag = "copy of " + other.tag;
     }
-};
\ No newline at end of file
+};
@@ -0,0 +1,306 @@
+﻿#include "CanvasHistory.hpp"
+#include <algorithm>
+#include <cstring>
+
+// ------------------------------
+// Konstruktor i odniesienie
+// ------------------------------
+CanvasHistory::CanvasHistory(std::size_t budgetBytes)
+    : budget(budgetBytes), tile(TileSize * TileSize), upload(TextureTracker::get().createUnique("CanvasHistory"))
+{
+}
+
+CanvasHistory::~CanvasHistory() {
+    if (staging) TextureTracker::get().untrack(&staging->getTexture());
+}
+
+void CanvasHistory::reset(const sf::Image& content, sf::Vector2i contentOrigin) {
+    origin = contentOrigin;
+    size = content.getSize();
+    shadow.resize(static_cast<std::size_t>(size.x) * size.y);
+    if (!shadow.empty())
+        std::memcpy(shadow.data(), content.getPixelsPtr(), shadow.size() * 4);
+    undoSteps.clear();
+    redoSteps.clear();
+    usedBytes = 0;
+}
+
+void CanvasHistory::rebase(const sf::Image& content, sf::Vector2i contentOrigin) {
+    if (content.getSize() != size) {
+        reset(content, contentOrigin);
+        return;
+    }
+    origin = contentOrigin;
+    if (!shadow.empty())
+        std::memcpy(shadow.data(), content.getPixelsPtr(), shadow.size() * 4);
+}
+
+// ------------------------------
+// Kodowanie delty
+// ------------------------------
+bool CanvasHistory::encode(const std::uint32_t* delta, std::size_t count, std::vector<std::uint32_t>& out) {
+    out.clear();
+    std::size_t i = 0;
+    while (i < count) {
+        std::uint32_t zeros = 0, literals = 0;
+        while (i < count && delta[i] == 0 && zeros < 0xFFFF) { ++zeros; ++i; }
+        std::size_t start = i;
+        while (i < count && delta[i] != 0 && literals < 0xFFFF) { ++literals; ++i; }
+        if (literals == 0 && i == count) break; // same zera do końca kafla
+        out.push_back(zeros << 16 | literals);
+        out.insert(out.end(), delta + start, delta + start + literals);
+    }
+    out.shrink_to_fit();
+    return !out.empty();
+}
+
+// ------------------------------
+// Zatwierdzanie zmian
+// ------------------------------
+void CanvasHistory::diffTile(std::uint32_t tx, std::uint32_t ty, const std::uint8_t* pixels, std::size_t stride, Step& step) {
+    const std::uint32_t w = std::min(TileSize, size.x - tx), h = std::min(TileSize, size.y - ty);
+
+    // Szybkie porównanie wierszy kafla; XOR tylko dla zmienionych
+    bool changed = false;
+    for (std::uint32_t y = 0; y < h && !changed; ++y) {
+        std::size_t offset = static_cast<std::size_t>(ty + y) * size.x + tx;
+        changed = std::memcmp(pixels + y * stride * 4, shadow.data() + offset, w * 4) != 0;
+    }
+    if (!changed) return;
+
+    for (std::uint32_t y = 0; y < h; ++y) {
+        std::size_t offset = static_cast<std::size_t>(ty + y) * size.x + tx;
+        std::uint32_t* row = tile.data() + y * w;
+        std::uint32_t* old = shadow.data() + offset;
+        std::memcpy(row, pixels + y * stride * 4, w * 4);
+        for (std::uint32_t x = 0; x < w; ++x) {
+            std::uint32_t fresh = row[x];
+            row[x] ^= old[x];
+            old[x] = fresh;
+        }
+    }
+
+    TileDelta delta{ tx, ty, w, h };
+    if (encode(tile.data(), static_cast<std::size_t>(w) * h, delta.code)) {
+        step.bytes += sizeof(TileDelta) + delta.code.size() * sizeof(std::uint32_t);
+        step.tiles.push_back(std::move(delta));
+    }
+}
+
+bool CanvasHistory::commit(const sf::Image& content, std::uint64_t before, std::uint64_t after) {
+    if (content.getSize() != size) {
+        reset(content, origin);
+        return false;
+    }
+
+    const std::uint8_t* pixels = content.getPixelsPtr();
+    Step step;
+    step.before = before;
+    step.after = after;
+    step.origin = origin;
+
+    for (std::uint32_t ty = 0; ty < size.y; ty += TileSize)
+        for (std::uint32_t tx = 0; tx < size.x; tx += TileSize)
+            diffTile(tx, ty, pixels + (static_cast<std::size_t>(ty) * size.x + tx) * 4, size.x, step);
+    return pushStep(std::move(step));
+}
+
+bool CanvasHistory::commit(const sf::Texture& canvas, const std::vector<sf::IntRect>& regions,
+    std::uint64_t before, std::uint64_t after, RenderStats& stats)
+{
+    if (canvas.getSize() != size) {
+        reset(canvas.copyToImage(), origin);
+        stats.readback(canvas.getSize());
+        return false;
+    }
+
+    // Kafle przecinające zmienione obszary (każdy raz)
+    const int columns = static_cast<int>((size.x + TileSize - 1) / TileSize);
+    const int rows = static_cast<int>((size.y + TileSize - 1) / TileSize);
+    const int tileSize = static_cast<int>(TileSize);
+    tileMarks.assign(static_cast<std::size_t>(columns) * rows, 0);
+    dirtyTiles.clear();
+    for (const sf::IntRect& region : regions) {
+        const int x0 = std::max(0, region.position.x), y0 = std::max(0, region.position.y);
+        const int x1 = std::min(static_cast<int>(size.x), region.position.x + region.size.x);
+        const int y1 = std::min(static_cast<int>(size.y), region.position.y + region.size.y);
+        if (x0 >= x1 || y0 >= y1) continue;
+        for (int ty = y0 / tileSize; ty <= (y1 - 1) / tileSize; ++ty) {
+            for (int tx = x0 / tileSize; tx <= (x1 - 1) / tileSize; ++tx) {
+                std::uint8_t& mark = tileMarks[static_cast<std::size_t>(ty) * columns + tx];
+                if (mark) continue;
+                mark = 1;
+                dirtyTiles.push_back({ static_cast<unsigned int>(tx * tileSize), static_cast<unsigned int>(ty * tileSize) });
+            }
+        }
+    }
+
+    Step step;
+    step.before = before;
+    step.after = after;
+    step.origin = origin;
+
+    // Większość kanwy zmieniona (lub brak tekstury pasa) — jeden odczyt całości
+    if (dirtyTiles.size() * 2 > tileMarks.size() || !diffTiles(canvas, dirtyTiles, step, stats)) {
+        const sf::Image content = canvas.copyToImage();
+        stats.readback(size);
+        const std::uint8_t* pixels = content.getPixelsPtr();
+        for (const sf::Vector2u& t : dirtyTiles)
+            diffTile(t.x, t.y, pixels + (static_cast<std::size_t>(t.y) * size.x + t.x) * 4, size.x, step);
+    }
+    return pushStep(std::move(step));
+}
+
+bool CanvasHistory::diffTiles(const sf::Texture& canvas, const std::vector<sf::Vector2u>& tiles, Step& step, RenderStats& stats) {
+    if (!staging) {
+        auto strip = std::make_unique<sf::RenderTexture>();
+        if (!strip->resize({ StagingTiles * TileSize, TileSize })) return false;
+        staging = std::move(strip);
+        TextureTracker::get().track(&staging->getTexture(), "CanvasHistory");
+    }
+
+    // Kafle kopiowane obok siebie bez mieszania, potem jeden odczyt pasa
+    const std::size_t stride = static_cast<std::size_t>(StagingTiles) * TileSize;
+    for (std::size_t first = 0; first < tiles.size(); first += StagingTiles) {
+        const std::size_t count = std::min<std::size_t>(StagingTiles, tiles.size() - first);
+        for (std::size_t i = 0; i < count; ++i) {
+            const sf::Vector2u t = tiles[first + i];
+            const std::uint32_t w = std::min(TileSize, size.x - t.x), h = std::min(TileSize, size.y - t.y);
+            sf::Sprite sprite(canvas, sf::IntRect({ static_cast<int>(t.x), static_cast<int>(t.y) },
+                { static_cast<int>(w), static_cast<int>(h) }));
+            sprite.setPosition({ static_cast<float>(i * TileSize), 0.f });
+            staging->draw(sprite, sf::BlendNone);
+            stats.draw(4, static_cast<std::size_t>(w) * h);
+        }
+        staging->display();
+        const sf::Image strip = staging->getTexture().copyToImage();
+        stats.readback(staging->getSize());
+
+        for (std::size_t i = 0; i < count; ++i) {
+            const sf::Vector2u t = tiles[first + i];
+            diffTile(t.x, t.y, strip.getPixelsPtr() + i * TileSize * 4, stride, step);
+        }
+    }
+    return true;
+}
+
+bool CanvasHistory::pushStep(Step step) {
+    if (step.tiles.empty()) return false;
+
+    for (const Step& redo : redoSteps) usedBytes -= redo.bytes;
+    redoSteps.clear();
+    step.bytes += sizeof(Step);
+    usedBytes += step.bytes;
+    undoSteps.push_back(std::move(step));
+    trim();
+    return true;
+}
+
+void CanvasHistory::trim() {
+    while (usedBytes > budget && !undoSteps.empty()) {
+        usedBytes -= undoSteps.front().bytes;
+        undoSteps.pop_front();
+        ++dropped;
+    }
+}
+
+// ------------------------------
+// Cofanie i ponawianie
+// ------------------------------
+void CanvasHistory::apply(const TileDelta& delta, sf::RenderTexture& canvas, RenderStats& stats) {
+    // XOR na kopii CPU
+    std::size_t pos = 0;
+    for (std::size_t i = 0; i < delta.code.size();) {
+        std::uint32_t header = delta.code[i++];
+        pos += header >> 16;
+        for (std::uint32_t n = header & 0xFFFF; n > 0; --n, ++pos) {
+            std::size_t y = pos / delta.width, x = pos % delta.width;
+            shadow[(delta.y + y) * size.x + delta.x + x] ^= delta.code[i++];
+        }
+    }
+
+    // Wysłanie kafla na GPU i narysowanie go bez mieszania
+    if (upload->getSize().x < TileSize) {
+        if (!upload->resize({ TileSize, TileSize })) return;
+        TextureTracker::get().refresh(upload.get());
+    }
+    for (std::uint32_t y = 0; y < delta.height; ++y)
+        std::memcpy(tile.data() + y * delta.width, shadow.data() + (delta.y + y) * size.x + delta.x, delta.width * 4);
+    upload->update(reinterpret_cast<const std::uint8_t*>(tile.data()), { delta.width, delta.height }, { 0, 0 });
+    stats.upload({ delta.width, delta.height });
+
+    sf::Sprite sprite(*upload, sf::IntRect({ 0, 0 }, { static_cast<int>(delta.width), static_cast<int>(delta.height) }));
+    sprite.setPosition({ static_cast<float>(delta.x), static_cast<float>(delta.y) });
+    canvas.draw(sprite, sf::BlendNone);
+    stats.draw(4, static_cast<std::size_t>(delta.width) * delta.height);
+}
+
+std::optional<std::uint64_t> CanvasHistory::undo(sf::RenderTexture& canvas, RenderStats& stats, std::vector<sf::IntRect>* touched) {
+    if (undoSteps.empty() || undoSteps.back().origin != origin) return std::nullopt;
+    Step step = std::move(undoSteps.back());
+    undoSteps.pop_back();
+    for (const TileDelta& delta : step.tiles) {
+        apply(delta, canvas, stats);
+        if (touched) touched->push_back({ { static_cast<int>(delta.x), static_cast<int>(delta.y) },
+            { static_cast<int>(delta.width), static_cast<int>(delta.height) } });
+    }
+    canvas.display();
+
+    std::uint64_t version = step.before;
+    redoSteps.push_back(std::move(step));
+    return version;
+}
+
+std::optional<std::uint64_t> CanvasHistory::redo(sf::RenderTexture& canvas, RenderStats& stats, std::vector<sf::IntRect>* touched) {
+    if (redoSteps.empty() || redoSteps.back().origin != origin) return std::nullopt;
+    Step step = std::move(redoSteps.back());
+    redoSteps.pop_back();
+    for (const TileDelta& delta : step.tiles) {
+        apply(delta, canvas, stats);
+        if (touched) touched->push_back({ { static_cast<int>(delta.x), static_cast<int>(delta.y) },
+            { static_cast<int>(delta.width), static_cast<int>(delta.height) } });
+    }
+    canvas.display();
+
+    std::uint64_t version = step.after;
+    undoSteps.push_back(std::move(step));
+    return version;
+}
+
+std::optional<sf::Vector2i> CanvasHistory::getUndoOrigin() const {
+    if (undoSteps.empty()) return std::nullopt;
+    return undoSteps.back().origin;
+}
+
+std::optional<sf::Vector2i> CanvasHistory::getRedoOrigin() const {
+    if (redoSteps.empty()) return std::nullopt;
+    return redoSteps.back().origin;
+}
+
+sf::Image CanvasHistory::copyRegion(const sf::IntRect& rect) const {
+    const int x0 = std::max(0, rect.position.x), y0 = std::max(0, rect.position.y);
+    const int x1 = std::min(static_cast<int>(size.x), rect.position.x + rect.size.x);
+    const int y1 = std::min(static_cast<int>(size.y), rect.position.y + rect.size.y);
+    sf::Image region;
+    if (x0 >= x1 || y0 >= y1) return region;
+
+    const std::size_t width = static_cast<std::size_t>(x1 - x0);
+    std::vector<std::uint32_t> pixels(width * (y1 - y0));
+    for (int y = y0; y < y1; ++y)
+        std::memcpy(pixels.data() + (y - y0) * width, shadow.data() + static_cast<std::size_t>(y) * size.x + x0, width * 4);
+    region.resize({ static_cast<unsigned int>(width), static_cast<unsigned int>(y1 - y0) },
+        reinterpret_cast<const std::uint8_t*>(pixels.data()));
+    return region;
+}
+
+// ------------------------------
+// Limit i statystyki
+// ------------------------------
+void CanvasHistory::setBudget(std::size_t budgetBytes) {
+    budget = budgetBytes;
+    trim();
+}
+
+HistoryStats CanvasHistory::getStats() const {
+    return { undoSteps.size(), redoSteps.size(), usedBytes, budget, dropped };
+}
@@ -0,0 +1,249 @@
+﻿#pragma once
+#include <SFML/Graphics.hpp>
+#include "RenderStats.hpp"
+#include "TextureTracker.hpp"
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <vector>
+
+/**
+ * @struct HistoryStats
+ * @brief Stan historii cofania.
+ */
+struct HistoryStats {
+    std::size_t undoSteps = 0; ///< Kroki do cofnięcia.
+    std::size_t redoSteps = 0; ///< Kroki do ponowienia.
+    std::size_t bytes = 0;     ///< Pamięć zajmowana przez kroki.
+    std::size_t budget = 0;    ///< Limit pamięci.
+    std::size_t dropped = 0;   ///< Najstarsze kroki usunięte z powodu limitu.
+};
+
+/**
+ * @class CanvasHistory
+ * @brief Historia cofania i ponawiania zmian kanwy zapisywana kaflami.
+ *
+ * Historia przechowuje kopię ostatniej zatwierdzonej zawartości kanwy
+ * (po stronie CPU). Zatwierdzenie porównuje nowy obraz z kopią kaflami
+ * TileSize x TileSize i zapisuje tylko kafle, które się zmieniły, jako
+ * XOR starej i nowej zawartości skompresowany kodowaniem długości serii
+ * (niezmienione piksele w kaflu to zera — kilka słów na kafel).
+ * Ta sama delta służy do cofania i ponawiania, a na GPU wysyłane są
+ * jedynie odtwarzane kafle.
+ *
+ * Gdy znane są obszary zmienione od ostatniego zatwierdzenia, z GPU
+ * odczytywane są tylko przecinające je kafle — pasami po StagingTiles
+ * kafli, jednym copyToImage na pas.
+ *
+ * Kanwa może pokazywać fragment większego dokumentu (widok kanwy
+ * kafelkowej). Każdy krok pamięta położenie kanwy w dokumencie, a rebase()
+ * zmienia położenie bez utraty kroków — krok można cofnąć lub ponowić
+ * tylko w położeniu, w którym go zapisano.
+ *
+ * Po przekroczeniu limitu pamięci usuwane są najstarsze kroki.
+ */
+class CanvasHistory {
+public:
+    static constexpr unsigned int TileSize = 64; ///< Bok kafla w pikselach.
+
+private:
+    /**
+     * @struct TileDelta
+     * @brief Zmiana jednego kafla.
+     */
+    struct TileDelta {
+        std::uint32_t x = 0, y = 0;       ///< Lewy górny róg kafla w pikselach.
+        std::uint32_t width = 0, height = 0; ///< Rozmiar kafla (mniejszy na krawędziach).
+        std::vector<std::uint32_t> code;  ///< XOR pikseli zakodowany seriami.
+    };
+
+    /**
+     * @struct Step
+     * @brief Jedna operacja (zbiór kafli) z wersjami kanwy przed i po niej.
+     */
+    struct Step {
+        std::vector<TileDelta> tiles; ///< Zmienione kafle.
+        std::uint64_t before = 0;     ///< Wersja kanwy przed operacją.
+        std::uint64_t after = 0;      ///< Wersja kanwy po operacji.
+        std::size_t bytes = 0;        ///< Zajmowana pamięć.
+        sf::Vector2i origin;          ///< Położenie kanwy w dokumencie w chwili zapisu.
+    };
+
+    static constexpr unsigned int StagingTiles = 16; ///< Kafle odczytywane jednym copyToImage.
+
+    std::vector<std::uint32_t> shadow;   ///< Ostatnia zatwierdzona zawartość (RGBA).
+    sf::Vector2u size;                   ///< Rozmiar kanwy.
+    sf::Vector2i origin;                 ///< Bieżące położenie kanwy w dokumencie.
+    std::deque<Step> undoSteps;          ///< Kroki do cofnięcia (najnowszy na końcu).
+    std::vector<Step> redoSteps;         ///< Kroki do ponowienia (najbliższy na końcu).
+    std::size_t budget;                  ///< Limit pamięci kroków.
+    std::size_t usedBytes = 0;           ///< Pamięć kroków.
+    std::size_t dropped = 0;             ///< Licznik usuniętych kroków.
+    std::vector<std::uint32_t> tile;     ///< Bufor roboczy jednego kafla.
+    TextureTracker::UniqueTexture upload; ///< Tekstura do wysyłania odtwarzanych kafli.
+    std::unique_ptr<sf::RenderTexture> staging; ///< Pas kafli kopiowanych z kanwy do odczytu.
+    std::vector<sf::Vector2u> dirtyTiles; ///< Bufor roboczy: kafle do porównania.
+    std::vector<std::uint8_t> tileMarks;  ///< Bufor roboczy: kafle już dopisane do dirtyTiles.
+
+    /**
+     * @brief Koduje XOR kafla: [zera u16 | literały u16] + literały.
+     * @param delta Piksele XOR.
+     * @param count Liczba pikseli.
+     * @param out Wynik.
+     * @return false jeśli kafel się nie zmienił.
+     */
+    static bool encode(const std::uint32_t* delta, std::size_t count, std::vector<std::uint32_t>& out);
+
+    /**
+     * @brief Porównuje kafel z kopią CPU; zmieniony dopisuje do kroku i przepisuje do kopii.
+     * @param tx Lewa krawędź kafla w pikselach.
+     * @param ty Górna krawędź kafla w pikselach.
+     * @param pixels Lewy górny piksel kafla w nowej zawartości (RGBA).
+     * @param stride Długość wiersza nowej zawartości w pikselach.
+     * @param step Krok, do którego trafia delta.
+     */
+    void diffTile(std::uint32_t tx, std::uint32_t ty, const std::uint8_t* pixels, std::size_t stride, Step& step);
+
+    /**
+     * @brief Odczytuje z GPU wskazane kafle kanwy pasami i porównuje je z kopią.
+     * @param canvas Kanwa.
+     * @param tiles Lewe górne rogi kafli.
+     * @param step Krok, do którego trafiają delty.
+     * @param stats Liczniki rysowania i odczytów.
+     * @return false jeśli nie udało się utworzyć tekstury pasa.
+     */
+    bool diffTiles(const sf::Texture& canvas, const std::vector<sf::Vector2u>& tiles, Step& step, RenderStats& stats);
+
+    /**
+     * @brief Dopisuje krok do historii (czyści ponawianie).
+     * @param step Krok.
+     * @return false jeśli krok nie zawiera zmian.
+     */
+    bool pushStep(Step step);
+
+    /**
+     * @brief Nakłada deltę na kopię CPU i rysuje odtworzony kafel na kanwie.
+     * @param delta Zmiana kafla.
+     * @param canvas Kanwa.
+     * @param stats Liczniki wysłań i rysowania.
+     */
+    void apply(const TileDelta& delta, sf::RenderTexture& canvas, RenderStats& stats);
+
+    /**
+     * @brief Usuwa najstarsze kroki ponad limit pamięci.
+     */
+    void trim();
+
+public:
+    /**
+     * @brief Konstruktor.
+     * @param budgetBytes Limit pamięci kroków.
+     */
+    explicit CanvasHistory(std::size_t budgetBytes);
+
+    CanvasHistory(const CanvasHistory&) = delete;
+    CanvasHistory& operator=(const CanvasHistory&) = delete;
+
+    /**
+     * @brief Destruktor (wyrejestrowuje teksturę pasa odczytu).
+     */
+    ~CanvasHistory();
+
+    /**
+     * @brief Ustawia zawartość odniesienia i czyści historię.
+     * @param content Bieżąca zawartość kanwy.
+     * @param contentOrigin Położenie kanwy w dokumencie.
+     */
+    void reset(const sf::Image& content, sf::Vector2i contentOrigin = {});
+
+    /**
+     * @brief Ustawia zawartość odniesienia po zmianie położenia kanwy, zachowując kroki.
+     *
+     * Zmiana rozmiaru kanwy czyści historię jak reset().
+     *
+     * @param content Zawartość kanwy w nowym położeniu.
+     * @param contentOrigin Nowe położenie kanwy w dokumencie.
+     */
+    void rebase(const sf::Image& content, sf::Vector2i contentOrigin);
+
+    /**
+     * @brief Zapisuje zmianę kanwy jako nowy krok (czyści ponawianie).
+     *
+     * Zmiana rozmiaru kanwy nie może być zapisana kaflami — historia
+     * zaczyna się wtedy od nowa.
+     *
+     * @param content Nowa zawartość kanwy.
+     * @param before Wersja kanwy przed zmianą.
+     * @param after Wersja kanwy po zmianie.
+     * @return true jeśli zapisano krok.
+     */
+    bool commit(const sf::Image& content, std::uint64_t before, std::uint64_t after);
+
+    /**
+     * @brief Zapisuje zmianę ograniczoną do wskazanych obszarów kanwy.
+     *
+     * Z GPU odczytywane są tylko kafle przecinające obszary; gdy obejmują
+     * one ponad połowę kanwy, taniej jest odczytać ją w całości.
+     *
+     * @param canvas Tekstura kanwy.
+     * @param regions Obszary zmienione od ostatniego zatwierdzenia (piksele kanwy).
+     * @param before Wersja kanwy przed zmianą.
+     * @param after Wersja kanwy po zmianie.
+     * @param stats Liczniki rysowania i odczytów.
+     * @return true jeśli zapisano krok.
+     */
+    bool commit(const sf::Texture& canvas, const std::vector<sf::IntRect>& regions,
+        std::uint64_t before, std::uint64_t after, RenderStats& stats);
+
+    /**
+     * @brief Cofa ostatni krok.
+     * @param canvas Kanwa (odtwarzane są tylko zmienione kafle).
+     * @param stats Liczniki wysłań i rysowania.
+     * @param touched Lista, do której trafiają odtworzone kafle (opcjonalnie).
+     * @return Wersja kanwy sprzed kroku lub brak, jeśli nie ma czego cofać
+     *         albo krok zapisano w innym położeniu kanwy (getUndoOrigin()).
+     */
+    std::optional<std::uint64_t> undo(sf::RenderTexture& canvas, RenderStats& stats, std::vector<sf::IntRect>* touched = nullptr);
+
+    /**
+     * @brief Ponawia ostatnio cofnięty krok.
+     * @param canvas Kanwa.
+     * @param stats Liczniki wysłań i rysowania.
+     * @param touched Lista, do której trafiają odtworzone kafle (opcjonalnie).
+     * @return Wersja kanwy po kroku lub brak, jeśli nie ma czego ponawiać
+     *         albo krok zapisano w innym położeniu kanwy (getRedoOrigin()).
+     */
+    std::optional<std::uint64_t> redo(sf::RenderTexture& canvas, RenderStats& stats, std::vector<sf::IntRect>* touched = nullptr);
+
+    /**
+     * @brief Kopiuje fragment ostatniej zatwierdzonej zawartości (bez odczytu z GPU).
+     * @param rect Fragment kanwy (przycinany do jej granic).
+     * @return Obraz fragmentu.
+     */
+    sf::Image copyRegion(const sf::IntRect& rect) const;
+
+    /**
+     * @brief Zwraca położenie kanwy, w którym zapisano krok do cofnięcia.
+     * @return Położenie lub brak, jeśli nie ma czego cofać.
+     */
+    std::optional<sf::Vector2i> getUndoOrigin() const;
+
+    /**
+     * @brief Zwraca położenie kanwy, w którym zapisano krok do ponowienia.
+     * @return Położenie lub brak, jeśli nie ma czego ponawiać.
+     */
+    std::optional<sf::Vector2i> getRedoOrigin() const;
+
+    /**
+     * @brief Ustawia limit pamięci.
+     * @param budgetBytes Limit w bajtach.
+     */
+    void setBudget(std::size_t budgetBytes);
+
+    /**
+     * @brief Zwraca stan historii.
+     * @return Statystyki.
+     */
+    HistoryStats getStats() const;
+};
@@ -0,0 +1,211 @@
+﻿#include "CommandLog.hpp"
+#include <cstring>
+#include <iterator>
+
+namespace {
+constexpr char Magic[4] = { 'S', '2', 'D', 'R' };
+constexpr std::uint16_t Version = 2;        ///< 2: ResizeCanvas, Undo, Redo.
+constexpr std::uint16_t MinVersion = 1;     ///< Najstarsza wersja czytelna bez zmian (nowe typy dopisane na końcu).
+constexpr std::uint32_t MaxPoints = 1u << 20; ///< Ochrona przed uszkodzonym dziennikiem.
+
+template <typename T>
+void put(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void putPoint(std::ofstream& out, const sf::Vector2f& p) {
+    put(out, p.x);
+    put(out, p.y);
+}
+} // namespace
+
+// ------------------------------
+// CommandRecorder
+// ------------------------------
+bool CommandRecorder::open(const std::string& filename) {
+    out.open(filename, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    out.write(Magic, sizeof(Magic));
+    put(out, Version);
+    frame = 0;
+    return true;
+}
+
+void CommandRecorder::record(const DrawCommand& cmd) {
+    if (!out.is_open()) return;
+    put(out, static_cast<std::uint8_t>(cmd.type));
+
+    switch (cmd.type) {
+    case CommandType::Point:
+    case CommandType::Circle:
+    case CommandType::Ellipse:
+        putPoint(out, cmd.points[0]);
+        break;
+    case CommandType::Line:
+        putPoint(out, cmd.points[0]);
+        putPoint(out, cmd.points[1]);
+        break;
+    case CommandType::Polyline:
+    case CommandType::Polygon:
+        put(out, static_cast<std::uint32_t>(cmd.points.size()));
+        for (const auto& p : cmd.points) putPoint(out, p);
+        break;
+    case CommandType::Fill:
+        putPoint(out, cmd.points[0]);
+        put(out, cmd.color.toInteger());
+        break;
+    case CommandType::LoadCanvas:
+    case CommandType::SaveCanvas:
+        put(out, static_cast<std::uint16_t>(cmd.filename.size()));
+        out.write(cmd.filename.data(), static_cast<std::streamsize>(cmd.filename.size()));
+        break;
+    case CommandType::BlankCanvas:
+        put(out, cmd.size.x);
+        put(out, cmd.size.y);
+        put(out, cmd.color.toInteger());
+        break;
+    case CommandType::ResizeCanvas:
+        put(out, cmd.size.x);
+        put(out, cmd.size.y);
+        put(out, static_cast<std::uint8_t>(cmd.filter));
+        break;
+    case CommandType::SpawnOkreg:
+        putPoint(out, cmd.points[0]);
+        put(out, cmd.radius);
+        put(out, cmd.color.toInteger());
+        put(out, cmd.speed);
+        put(out, cmd.angle);
+        put(out, cmd.rotation);
+        break;
+    case CommandType::ClearCanvas:
+    case CommandType::Undo:
+    case CommandType::Redo:
+    case CommandType::FrameEnd:
+        break;
+    }
+}
+
+void CommandRecorder::endFrame(float dt) {
+    if (!out.is_open()) return;
+    put(out, static_cast<std::uint8_t>(CommandType::FrameEnd));
+    put(out, frame++);
+    put(out, dt);
+}
+
+// ------------------------------
+// CommandPlayer
+// ------------------------------
+bool CommandPlayer::open(const std::string& filename) {
+    close();
+    std::ifstream in(filename, std::ios::binary);
+    if (!in) return false;
+    data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+    char magic[4];
+    std::uint16_t version = 0;
+    if (!read(magic, sizeof(magic)) || std::memcmp(magic, Magic, sizeof(Magic)) != 0
+        || !read(&version, sizeof(version)) || version < MinVersion || version > Version) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool CommandPlayer::read(void* dst, std::size_t bytes) {
+    if (data.size() - offset < bytes) {
+        offset = data.size();
+        return false;
+    }
+    std::memcpy(dst, data.data() + offset, bytes);
+    offset += bytes;
+    return true;
+}
+
+bool CommandPlayer::readFrame(std::vector<DrawCommand>& commands, float& dt) {
+    commands.clear();
+    auto readPoint = [this](sf::Vector2f& p) { return read(&p.x, sizeof(float)) && read(&p.y, sizeof(float)); };
+    auto readColor = [this](sf::Color& c) {
+        std::uint32_t v;
+        if (!read(&v, sizeof(v))) return false;
+        c = sf::Color(v);
+        return true;
+    };
+
+    while (isPlaying()) {
+        std::uint8_t type;
+        if (!read(&type, sizeof(type))) return false;
+
+        DrawCommand cmd;
+        cmd.type = static_cast<CommandType>(type);
+        bool ok = true;
+
+        switch (cmd.type) {
+        case CommandType::Point:
+        case CommandType::Circle:
+        case CommandType::Ellipse:
+            cmd.points.resize(1);
+            ok = readPoint(cmd.points[0]);
+            break;
+        case CommandType::Line:
+            cmd.points.resize(2);
+            ok = readPoint(cmd.points[0]) && readPoint(cmd.points[1]);
+            break;
+        case CommandType::Polyline:
+        case CommandType::Polygon: {
+            std::uint32_t count = 0;
+            ok = read(&count, sizeof(count)) && count <= MaxPoints;
+            if (ok) cmd.points.resize(count);
+            for (std::uint32_t i = 0; ok && i < count; ++i)
+                ok = readPoint(cmd.points[i]);
+            break;
+        }
+        case CommandType::Fill:
+            cmd.points.resize(1);
+            ok = readPoint(cmd.points[0]) && readColor(cmd.color);
+            break;
+        case CommandType::LoadCanvas:
+        case CommandType::SaveCanvas: {
+            std::uint16_t len = 0;
+            ok = read(&len, sizeof(len));
+            if (ok) {
+                cmd.filename.resize(len);
+                ok = read(cmd.filename.data(), len);
+            }
+            break;
+        }
+        case CommandType::BlankCanvas:
+            ok = read(&cmd.size.x, sizeof(cmd.size.x)) && read(&cmd.size.y, sizeof(cmd.size.y)) && readColor(cmd.color);
+            break;
+        case CommandType::ResizeCanvas: {
+            std::uint8_t filter = 0;
+            ok = read(&cmd.size.x, sizeof(cmd.size.x)) && read(&cmd.size.y, sizeof(cmd.size.y))
+                && read(&filter, sizeof(filter)) && filter <= static_cast<std::uint8_t>(ResampleFilter::Lanczos);
+            cmd.filter = static_cast<ResampleFilter>(filter);
+            break;
+        }
+        case CommandType::SpawnOkreg:
+            cmd.points.resize(1);
+            ok = readPoint(cmd.points[0]) && read(&cmd.radius, sizeof(float)) && readColor(cmd.color)
+                && read(&cmd.speed, sizeof(float)) && read(&cmd.angle, sizeof(float)) && read(&cmd.rotation, sizeof(float));
+            break;
+        case CommandType::ClearCanvas:
+        case CommandType::Undo:
+        case CommandType::Redo:
+            break;
+        case CommandType::FrameEnd: {
+            std::uint32_t frame = 0;
+            return read(&frame, sizeof(frame)) && read(&dt, sizeof(dt));
+        }
+        default:
+            ok = false; // nieznany typ — dziennik uszkodzony
+            break;
+        }
+
+        if (!ok) {
+            offset = data.size();
+            return false;
+        }
+        commands.push_back(std::move(cmd));
+    }
+    return false;
+}
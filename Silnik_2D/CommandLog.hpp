@@ -0,0 +1,174 @@
+﻿#pragma once
+#include <SFML/Graphics.hpp>
+#include "Resampler.hpp"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @enum CommandType
+ * @brief Rodzaje poleceń silnika zapisywanych w dzienniku.
+ */
+enum class CommandType : std::uint8_t {
+    Point,       ///< Dodanie punktu (wierzchołka łamanej).
+    Line,        ///< Odcinek.
+    Polyline,    ///< Łamana otwarta.
+    Polygon,     ///< Łamana zamknięta.
+    Circle,      ///< Okrąg.
+    Ellipse,     ///< Elipsa.
+    Fill,        ///< Wypełnienie kolorem.
+    LoadCanvas,  ///< Wczytanie bitmapy na warstwę statyczną.
+    SaveCanvas,  ///< Zrzut warstwy statycznej.
+    BlankCanvas, ///< Utworzenie pustej warstwy statycznej.
+    ClearCanvas, ///< Wyczyszczenie warstwy statycznej.
+    SpawnOkreg,  ///< Utworzenie ruchomego okręgu.
+    FrameEnd,    ///< Koniec klatki (numer klatki i dt).
+    ResizeCanvas, ///< Zmiana rozmiaru obrazu warstwy statycznej z filtrowaniem.
+    Undo,        ///< Cofnięcie ostatniej zmiany warstwy statycznej.
+    Redo         ///< Ponowienie cofniętej zmiany.
+};
+
+/**
+ * @enum ReplayTiming
+ * @brief Tempo odtwarzania dziennika poleceń.
+ *
+ * - FullSpeed: klatki odtwarzane bez oczekiwania (pomiary wydajności).
+ * - Recorded: zachowanie czasów klatek z nagrania.
+ */
+enum class ReplayTiming { FullSpeed, Recorded };
+
+/**
+ * @struct DrawCommand
+ * @brief Pojedyncze polecenie silnika na poziomie sceny.
+ *
+ * Wszystkie zmiany sceny wywoływane z wejścia przechodzą przez
+ * Engine::execute(), dzięki czemu mogą być nagrane i odtworzone.
+ */
+struct DrawCommand {
+    CommandType type = CommandType::Point; ///< Rodzaj polecenia.
+    std::vector<sf::Vector2f> points;      ///< Punkty (pozycja, końce odcinka, wierzchołki).
+    sf::Color color;                       ///< Kolor (wypełnienie, tło, obiekt).
+    sf::Vector2u size;                     ///< Rozmiar (BlankCanvas, ResizeCanvas).
+    std::string filename;                  ///< Plik (LoadCanvas, SaveCanvas).
+    float radius = 0.f;                    ///< Promień (SpawnOkreg).
+    float speed = 0.f;                     ///< Prędkość liniowa (SpawnOkreg).
+    float angle = 0.f;                     ///< Kierunek ruchu w radianach (SpawnOkreg).
+    float rotation = 0.f;                  ///< Prędkość obrotowa (SpawnOkreg).
+    ResampleFilter filter = ResampleFilter::Bilinear; ///< Filtr (ResizeCanvas).
+
+    // --- Funkcje tworzące ---
+    static DrawCommand point(sf::Vector2f p) { return { CommandType::Point, { p } }; }
+    static DrawCommand line(sf::Vector2f a, sf::Vector2f b) { return { CommandType::Line, { a, b } }; }
+    static DrawCommand polyline(std::vector<sf::Vector2f> pts) { return { CommandType::Polyline, std::move(pts) }; }
+    static DrawCommand polygon(std::vector<sf::Vector2f> pts) { return { CommandType::Polygon, std::move(pts) }; }
+    static DrawCommand circle(sf::Vector2f p) { return { CommandType::Circle, { p } }; }
+    static DrawCommand ellipse(sf::Vector2f p) { return { CommandType::Ellipse, { p } }; }
+    static DrawCommand fill(sf::Vector2f p, sf::Color c) { return { CommandType::Fill, { p }, c }; }
+    static DrawCommand loadCanvas(const std::string& f) { DrawCommand c{ CommandType::LoadCanvas }; c.filename = f; return c; }
+    static DrawCommand saveCanvas(const std::string& f) { DrawCommand c{ CommandType::SaveCanvas }; c.filename = f; return c; }
+    static DrawCommand blankCanvas(sf::Vector2u s, sf::Color col) { DrawCommand c{ CommandType::BlankCanvas, {}, col, s }; return c; }
+    static DrawCommand resizeCanvas(sf::Vector2u s, ResampleFilter f) { DrawCommand c{ CommandType::ResizeCanvas }; c.size = s; c.filter = f; return c; }
+    static DrawCommand clearCanvas() { return { CommandType::ClearCanvas }; }
+    static DrawCommand undo() { return { CommandType::Undo }; }
+    static DrawCommand redo() { return { CommandType::Redo }; }
+    static DrawCommand spawnOkreg(sf::Vector2f center, float r, sf::Color col, float speed, float angle, float rotation) {
+        DrawCommand c{ CommandType::SpawnOkreg, { center }, col };
+        c.radius = r;
+        c.speed = speed;
+        c.angle = angle;
+        c.rotation = rotation;
+        return c;
+    }
+};
+
+/**
+ * @class CommandRecorder
+ * @brief Zapis strumienia poleceń do zwartego dziennika binarnego.
+ *
+ * Format: nagłówek "S2DR" + wersja (u16), następnie rekordy
+ * [typ u8][dane]. Każda klatka kończy się rekordem FrameEnd z numerem
+ * klatki i czasem dt, dzięki czemu odtworzenie jest deterministyczne.
+ */
+class CommandRecorder {
+private:
+    std::ofstream out;       ///< Plik dziennika.
+    std::uint32_t frame = 0; ///< Numer bieżącej klatki.
+
+public:
+    /**
+     * @brief Otwiera plik dziennika i zapisuje nagłówek.
+     * @param filename Ścieżka pliku.
+     * @return true jeśli udało się otworzyć plik.
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * @brief Zapisuje polecenie w bieżącej klatce.
+     * @param cmd Polecenie.
+     */
+    void record(const DrawCommand& cmd);
+
+    /**
+     * @brief Zamyka bieżącą klatkę.
+     * @param dt Czas klatki w sekundach.
+     */
+    void endFrame(float dt);
+
+    /**
+     * @brief Zamyka dziennik.
+     */
+    void close() { out.close(); }
+
+    /**
+     * @brief Sprawdza, czy trwa nagrywanie.
+     * @return true jeśli dziennik jest otwarty.
+     */
+    bool isRecording() const { return out.is_open(); }
+};
+
+/**
+ * @class CommandPlayer
+ * @brief Odczyt dziennika poleceń klatka po klatce.
+ */
+class CommandPlayer {
+private:
+    std::vector<std::uint8_t> data; ///< Zawartość dziennika.
+    std::size_t offset = 0;         ///< Pozycja odczytu.
+
+    /**
+     * @brief Odczytuje surową wartość z dziennika.
+     * @param dst Bufor docelowy.
+     * @param bytes Liczba bajtów.
+     * @return false jeśli dziennik się skończył.
+     */
+    bool read(void* dst, std::size_t bytes);
+
+public:
+    /**
+     * @brief Wczytuje dziennik z pliku.
+     * @param filename Ścieżka pliku.
+     * @return true jeśli plik ma poprawny nagłówek.
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * @brief Odczytuje polecenia kolejnej klatki.
+     * @param commands Lista, do której trafią polecenia (czyszczona).
+     * @param dt Zapisany czas klatki.
+     * @return false gdy dziennik się skończył lub jest uszkodzony.
+     */
+    bool readFrame(std::vector<DrawCommand>& commands, float& dt);
+
+    /**
+     * @brief Sprawdza, czy trwa odtwarzanie.
+     * @return true jeśli w dzienniku pozostały dane.
+     */
+    bool isPlaying() const { return offset < data.size(); }
+
+    /**
+     * @brief Kończy odtwarzanie i zwalnia dane.
+     */
+    void close() { data.clear(); offset = 0; }
+};
@@ -1,11 +1,20 @@
 ﻿#include "Engine.hpp"
 #include "LineSegment.hpp"
+#include "Benchmark.hpp"
+#include "Regression.hpp"
+#include "BatchRenderer.hpp"
+#include "StressScene.hpp"
 #include <SFML/Window.hpp>
 #include <SFML/System.hpp>
 #include <iostream>
 #include <fstream>
+#include <filesystem>
+#include <sstream>
 #include <variant>
 #include <optional>
+#include <algorithm>
+#include <random>
+#include <cstdlib>
 #include <Windows.h>
 
 /**
@@ -13,35 +22,19 @@
  */
 Engine* Engine::instance = nullptr;
 
-/**
- * @struct FillRequest
- * @brief Struktura reprezentująca żądanie wypełnienia kolorem.
- */
-struct FillRequest {
-    sf::Vector2f pos; ///< Punkt startowy wypełnienia
-    sf::Color color;  ///< Kolor wypełnienia
-};
-
-bool waitingForColor = false; ///< Flaga oczekiwania na wybór koloru
-
-// --- Globalne kontenery rysowanych obiektów ---
-std::vector<FillRequest> wypewnenia;
-std::vector<sf::Vector2f> punkty;
-std::vector<std::pair<sf::Vector2f, sf::Vector2f>> linie;
-std::vector<std::vector<sf::Vector2f>> polyliny;
-std::vector<std::vector<sf::Vector2f>> polygony;
-std::vector<sf::Vector2f> okregy;
-std::vector<sf::Vector2f> elipsy;
-
 /**
  * @brief Konstruktor silnika.
  * @param config Konfiguracja silnika (rozmiar okna, kolor tła, fps, tryb fullscreen)
  */
 Engine::Engine(const EngineConfig& config)
     : clearColor(config.clearColor),
-    staticCanvas({ config.width, config.height }),
-    animatedCanvas({ config.width, config.height }),
-    canvasSprite(staticCanvas.getTexture())
+    context({ config.width, config.height }, config.clearColor),
+    staticCanvas(context.getCanvas()),
+    canvasSprite(staticCanvas.getTexture()),
+    pacer(config.fps, config.adaptivePacing),
+    hud(config.fps),
+    snapshotInterval(config.snapshotInterval),
+    snapshotFormat(config.snapshotFormat)
 {
     sf::VideoMode mode;
     mode.size = { config.width, config.height };
@@ -49,13 +42,53 @@ Engine::Engine(const EngineConfig& config)
     // Ukrycie konsoli
     ::ShowWindow(::GetConsoleWindow(), SW_HIDE);
 
+    // Tempo klatek odmierza FramePacer (sleep + aktywne oczekiwanie)
     window = sf::RenderWindow(mode, config.windowTitle);
-    window.setFramerateLimit(config.fps);
+    window.setFramerateLimit(0);
 
     staticCanvas.clear(clearColor);
     staticCanvas.display();
-    animatedCanvas.clear(sf::Color::Transparent);
-    animatedCanvas.display();
+    context.enableHistory(config.historyBudget);
+
+    TextureTracker& textures = TextureTracker::get();
+    textures.setBudget(config.textureBudget, config.textureBudgetPolicy);
+    textures.track(&staticCanvas.getTexture(), "Engine.staticCanvas");
+    buildRenderGraph();
+}
+
+/**
+ * @brief Deklaruje przebiegi renderowania klatki.
+ *
+ * Warstwy są składane w oknie przez jeden przebieg złożenia; kolejne
+ * warstwy (np. oświetlenie, efekty) dodaje się przez addRenderLayer().
+ */
+void Engine::buildRenderGraph() {
+    staticLayer = renderGraph.importTexture("static", staticCanvas);
+    animatedLayer = renderGraph.createTransient("animated", staticCanvas.getSize());
+    backbuffer = renderGraph.importTarget("window", window);
+    renderGraph.setOutput(backbuffer);
+
+    // Tło jest utrwalane na warstwie statycznej przy wczytaniu — ponownie
+    // rysowane są jedynie kafle po przesunięciu widoku kanwy kafelkowej
+    renderGraph.addPass({ "tiles", {}, { staticLayer },
+        [this](RenderPassContext&) { redrawTiledView(false); },
+        [this] { return tiledCanvas.isActive() && tiledViewDirty; } });
+
+    // Listy rysowania warstwy statycznej (prymitywy, wypełnienia) — liczniki w context
+    renderGraph.addPass({ "static", {}, { staticLayer }, [this](RenderPassContext&) { context.flush(); } });
+
+    // Obiekty animowane — odtworzenie listy nagranej przez wątek główny
+    renderGraph.addPass({ "animated", {}, { animatedLayer }, [this](RenderPassContext& pass) {
+        pass.stats += frameLists[renderList].replay(pass.target(animatedLayer));
+    } });
+
+    compositePass = renderGraph.addComposite("composite", backbuffer, sf::Color::Black);
+    renderGraph.addLayer(compositePass, staticLayer);
+    renderGraph.addLayer(compositePass, animatedLayer);
+
+    renderGraph.addPass({ "hud", {}, { backbuffer }, [this](RenderPassContext& pass) {
+        if (std::size_t vertices = hud.draw(pass.target(backbuffer))) pass.stats.draw(vertices, 0);
+    } });
 }
 
 /**
@@ -65,19 +98,66 @@ Engine::Engine(const EngineConfig& config)
  */
 bool Engine::loadBitmapToCanvas(const std::string& filename)
 {
-    if (!bitmap.loadFromFile(filename))
-        return false;
+    syncRender();
+    // Obraz przekraczający limit tekstury GPU (wg nagłówka) trafia od razu do kanwy kafelkowej
+    const std::optional<sf::Vector2u> probed = TiledCanvas::probeImageSize(filename);
+    const bool oversized = probed && !TiledCanvas::fitsInTexture(probed->x, probed->y);
+    if (oversized || !bitmap.loadFromFile(filename)) {
+        bitmap.clear();
+        if (!tiledCanvas.loadFromFile(filename))
+            return false;
+
+        tiledView = staticCanvas.getDefaultView();
+        redrawTiledView(true);
+        canvasSprite = sf::Sprite(staticCanvas.getTexture());
+        return true;
+    }
+    tiledCanvas.clear();
+    context.setDamageTracking(false);
 
     staticCanvas.clear(clearColor);
 
     sf::Sprite spr(*bitmap.getTexture());
     staticCanvas.draw(spr);
     staticCanvas.display();
+    touchStaticCanvas();
 
     canvasSprite = sf::Sprite(staticCanvas.getTexture());
     return true;
 }
 
+/**
+ * @brief Rysuje widoczny fragment kanwy kafelkowej na warstwie statycznej.
+ *
+ * Zmiany narysowane na warstwie od poprzedniego rysowania widoku najpierw
+ * wracają do kafli. Historia przyjmuje nową zawartość z kafli (kopia CPU,
+ * bez odczytu warstwy z GPU); przesunięcie widoku nie jest krokiem do cofnięcia.
+ *
+ * @param newDocument Czy to nowy obraz (historia od nowa), a nie przesunięcie widoku.
+ */
+void Engine::redrawTiledView(bool newDocument)
+{
+    if (newDocument) {
+        context.setDamageTracking(true);
+    }
+    else {
+        context.takeDamage([this](const sf::Image& pixels, sf::Vector2i position) {
+            tiledCanvas.writeImage(pixels, tiledOrigin + position);
+        });
+    }
+
+    staticCanvas.clear(clearColor);
+    tiledCanvas.draw(staticCanvas, tiledView);
+    staticCanvas.display();
+    tiledViewDirty = false;
+
+    tiledOrigin = sf::Vector2i(tiledView.getCenter() - tiledView.getSize() / 2.f);
+    sf::Image content;
+    if (context.getHistory())
+        content = tiledCanvas.readImage({ tiledOrigin, sf::Vector2i(staticCanvas.getSize()) }, clearColor);
+    context.adoptContent(content, tiledOrigin, !newDocument);
+}
+
 /**
  * @brief Zapisuje obecny stan canvas do pliku.
  * @param filename Nazwa pliku.
@@ -85,10 +165,22 @@ bool Engine::loadBitmapToCanvas(const std::string& filename)
  */
 bool Engine::saveCanvasToFile(const std::string& filename)
 {
+    syncRender();
     sf::Image img = staticCanvas.getTexture().copyToImage();
     return img.saveToFile(filename);
 }
 
+/**
+ * @brief Przechwytuje canvas i przekazuje go do zapisu w tle.
+ * @param filename Nazwa pliku.
+ * @param format Format zapisu.
+ */
+void Engine::requestSnapshot(const std::string& filename, SnapshotFormat format)
+{
+    syncRender();
+    snapshots.submit(staticCanvas.getTexture().copyToImage(), filename, format);
+}
+
 /**
  * @brief Tworzy pusty canvas o zadanym rozmiarze i kolorze.
  * @param w Szerokość canvas.
@@ -97,6 +189,21 @@ bool Engine::saveCanvasToFile(const std::string& filename)
  */
 void Engine::createBlankCanvas(unsigned w, unsigned h, sf::Color c)
 {
+    syncRender();
+    if (!TiledCanvas::fitsInTexture(w, h)) {
+        // Bez alokacji całego obrazu — kafle materializują się przy zapisie
+        bitmap.clear();
+        if (!tiledCanvas.create(w, h, c))
+            return;
+
+        tiledView = staticCanvas.getDefaultView();
+        redrawTiledView(true);
+        canvasSprite = sf::Sprite(staticCanvas.getTexture());
+        return;
+    }
+    tiledCanvas.clear();
+    context.setDamageTracking(false);
+
     bitmap.create(w, h, c);
 
     staticCanvas.clear(c);
@@ -104,6 +211,31 @@ void Engine::createBlankCanvas(unsigned w, unsigned h, sf::Color c)
     staticCanvas.draw(s);
     staticCanvas.display();
     canvasSprite = sf::Sprite(staticCanvas.getTexture());
+    touchStaticCanvas();
+}
+
+/**
+ * @brief Przeskalowuje obraz warstwy statycznej.
+ * @param w Szerokość.
+ * @param h Wysokość.
+ * @param filter Filtr.
+ */
+void Engine::resizeCanvas(unsigned w, unsigned h, ResampleFilter filter)
+{
+    syncRender();
+    if (w == 0 || h == 0 || tiledCanvas.isActive() || !TiledCanvas::fitsInTexture(w, h))
+        return;
+
+    context.flush();
+    sf::Image image = staticCanvas.getTexture().copyToImage();
+    bitmap.create(w, h);
+    Resampler().resize(image, bitmap.editPixels(), { w, h }, filter);
+
+    staticCanvas.clear(clearColor);
+    staticCanvas.draw(sf::Sprite(*bitmap.getTexture()));
+    staticCanvas.display();
+    canvasSprite = sf::Sprite(staticCanvas.getTexture());
+    touchStaticCanvas();
 }
 
 /**
@@ -120,6 +252,35 @@ static void log(const std::string& message) {
  */
 void Engine::shutdown() {
     log("Shutting down engine...");
+    if (renderThread.isRunning()) {
+        renderThread.stop();
+        log("Render thread: " + std::to_string(renderThread.getFrameCount()) + " frames");
+    }
+    recorder.close();
+    FrameStats stats = pacer.getStats();
+    log("Frames: " + std::to_string(stats.frames) + ", missed " + std::to_string(stats.missedFrames)
+        + ", p50 " + std::to_string(stats.p50Ms) + " ms, p95 " + std::to_string(stats.p95Ms)
+        + " ms, p99 " + std::to_string(stats.p99Ms) + " ms");
+    log("Frame arena: peak " + std::to_string(context.getArena().getPeakBytes()) + " bytes/frame, "
+        + std::to_string(context.getArena().getHeapAllocations()) + " heap allocations");
+    if (const CanvasHistory* history = context.getHistory()) {
+        HistoryStats h = history->getStats();
+        log("Undo history: " + std::to_string(h.undoSteps) + " steps, " + std::to_string(h.bytes)
+            + " bytes (budget " + std::to_string(h.budget) + "), dropped " + std::to_string(h.dropped));
+    }
+    const RenderGraphStats graphStats = renderGraph.getStats();
+    log("Render graph: " + std::to_string(graphStats.passes) + " passes, culled " + std::to_string(graphStats.culled)
+        + ", " + std::to_string(graphStats.transientResources) + " transient resources in "
+        + std::to_string(graphStats.transientTextures) + " textures");
+    snapshots.flush();
+    for (const auto& result : snapshots.collectResults())
+        log("Snapshot " + result.filename + (result.success ? " saved" : " FAILED"));
+
+    std::stringstream textureReport;
+    TextureTracker::get().dump(textureReport);
+    for (std::string line; std::getline(textureReport, line);)
+        log(line);
+    TextureTracker::get().untrack(&staticCanvas.getTexture());
     window.close();
     ::ShowWindow(::GetConsoleWindow(), SW_SHOW);
 
@@ -139,103 +300,214 @@ void Engine::init() {
 
 /**
  * @brief Obsługuje wszystkie zdarzenia wejścia (mysz, klawiatura, zamknięcie okna).
+ *
+ * Zdarzenia aktualizują migawkę wejścia (jedno źródło stanu dla obiektów),
+ * a akcje wyzwolone przez InputMap są wykonywane w kolejności zdarzeń.
  */
 void Engine::handleInput() {
+    input.beginFrame();
     while (const std::optional<sf::Event> event = window.pollEvent()) {
         if (event->is<sf::Event::Closed>()) {
-            isRunning = false;
-            window.close();
+            isRunning = false; // okno zamyka shutdown() po zatrzymaniu wątku renderującego
         }
+        input.handleEvent(*event);
+    }
 
-        // Obsługa myszy
-        if (const auto* MousePressed = event->getIf<sf::Event::MouseButtonPressed>()) {
-            if (MousePressed->button == sf::Mouse::Button(0)) {
-                sf::Vector2f pos(sf::Mouse::getPosition(window).x, sf::Mouse::getPosition(window).y);
-                punkty.push_back(pos);
-            }
-        }
+    for (const TriggeredAction& triggered : input.getState().getTriggered()) {
+        if (!isRunning) break;
+        onAction(triggered.action, triggered.position);
+    }
+}
 
-        // Obsługa klawiatury
-        if (const auto* keyPressed = event->getIf<sf::Event::KeyPressed>()) {
-            switch (keyPressed->code) {
-            case sf::Keyboard::Key::Escape:
-                isRunning = false;
-                window.close();
-                break;
-
-            case sf::Keyboard::Key::Backspace:
-                bitmap.clear();
-                staticCanvas.clear(clearColor);
-                window.clear();
-                window.draw(sf::Sprite(staticCanvas.getTexture()));
-                window.display();
-                break;
-
-            case sf::Keyboard::Key::Space:
-            {
-                sf::Vector2f pos(sf::Mouse::getPosition(window).x, sf::Mouse::getPosition(window).y);
-                linie.push_back({ pos, pos + sf::Vector2f(50, 50) });
-                break;
-            }
+/**
+ * @brief Wykonuje akcję wejścia.
+ *
+ * Zmiany sceny są zamieniane na polecenia DrawCommand i wykonywane przez
+ * execute(). Podczas odtwarzania dziennika obsługiwane jest jedynie
+ * zamknięcie i przełączenie nakładki wydajności.
+ */
+void Engine::onAction(InputAction action, sf::Vector2f pos) {
+    // Podczas odtwarzania dziennika polecenia pochodzą wyłącznie z pliku
+    if (player.isPlaying() && action != InputAction::Quit && action != InputAction::ToggleHud)
+        return;
+
+    // Polecenia kanwy czekają na klatkę w toku w execute(); zmiany widoku (nakładka,
+    // przesunięcie) trafiają do kolejnej klatki bez blokowania wątku głównego
+    switch (action) {
+    case InputAction::Quit:
+        isRunning = false;
+        break;
+    case InputAction::ToggleHud: hudTogglePending = !hudTogglePending; break;
+
+    case InputAction::AddPoint:    execute(DrawCommand::point(pos)); break;
+    case InputAction::ClearCanvas: execute(DrawCommand::clearCanvas()); break;
+    case InputAction::Line:        execute(DrawCommand::line(pos, pos + sf::Vector2f(50, 50))); break;
+    case InputAction::Polygon:     syncRender(); execute(DrawCommand::polygon(context.takePoints())); break;
+    case InputAction::Polyline:    syncRender(); execute(DrawCommand::polyline(context.takePoints())); break;
+    case InputAction::Circle:      execute(DrawCommand::circle(pos)); break;
+    case InputAction::Ellipse:     execute(DrawCommand::ellipse(pos)); break;
+    case InputAction::SpawnCircle:
+    {
+        std::uniform_real_distribution<float> direction(0.f, 6.2831853f);
+        execute(DrawCommand::spawnOkreg(pos, 20.f, sf::Color::Green, 60.f, direction(rng), 0.f));
+        break;
+    }
 
-            case sf::Keyboard::Key::P:
-                polygony.push_back(punkty);
-                punkty.clear();
-                break;
-
-            case sf::Keyboard::Key::L:
-                polyliny.push_back(punkty);
-                punkty.clear();
-                break;
-
-            case sf::Keyboard::Key::O:
-            {
-                sf::Vector2f pos(sf::Mouse::getPosition(window).x, sf::Mouse::getPosition(window).y);
-                okregy.push_back(pos);
-                break;
-            }
+    case InputAction::LoadBackground: execute(DrawCommand::loadCanvas("tlo.png")); break;
+    case InputAction::SaveCanvas:     execute(DrawCommand::saveCanvas("zrzut.png")); break;
+    case InputAction::BlankCanvas:    execute(DrawCommand::blankCanvas({ 1280, 720 }, sf::Color::White)); break;
+    case InputAction::LoadSnapshot:   execute(DrawCommand::loadCanvas("zrzut.png")); break;
+    case InputAction::HalveCanvas:
+    {
+        sf::Vector2u size = staticCanvas.getSize();
+        execute(DrawCommand::resizeCanvas({ size.x / 2, size.y / 2 }, ResampleFilter::Lanczos));
+        break;
+    }
 
-            case sf::Keyboard::Key::E:
-            {
-                sf::Vector2f pos(sf::Mouse::getPosition(window).x, sf::Mouse::getPosition(window).y);
-                elipsy.push_back(pos);
-                break;
-            }
+    // Cofanie i ponawianie zmian warstwy statycznej
+    case InputAction::Undo: execute(DrawCommand::undo()); break;
+    case InputAction::Redo: execute(DrawCommand::redo()); break;
+
+    // Przesuwanie widoku kanwy kafelkowej
+    case InputAction::PanLeft:  pendingPan.x -= 64.f; break;
+    case InputAction::PanRight: pendingPan.x += 64.f; break;
+    case InputAction::PanUp:    pendingPan.y -= 64.f; break;
+    case InputAction::PanDown:  pendingPan.y += 64.f; break;
+
+    case InputAction::Fill:
+        fillPending = true;
+        std::cout << "Waiting for color key...\n";
+        break;
+
+    case InputAction::FillRed:
+    case InputAction::FillGreen:
+    case InputAction::FillBlue:
+    case InputAction::FillYellow:
+    case InputAction::FillCyan:
+    case InputAction::FillMagenta:
+    {
+        if (!fillPending) break;
+        static const sf::Color colors[] = { sf::Color::Red, sf::Color::Green, sf::Color::Blue,
+            sf::Color::Yellow, sf::Color::Cyan, sf::Color::Magenta };
+        sf::Color chosenColor = colors[static_cast<int>(action) - static_cast<int>(InputAction::FillRed)];
+        execute(DrawCommand::fill(pos, chosenColor));
+        fillPending = false;
+        std::cout << "Added fill at (" << pos.x << ", " << pos.y
+            << ") color: " << int(chosenColor.r) << "\n";
+        break;
+    }
 
-            case sf::Keyboard::Key::Num1: loadBitmapToCanvas("tlo.png"); break;
-            case sf::Keyboard::Key::Num2: saveCanvasToFile("zrzut.png"); break;
-            case sf::Keyboard::Key::Num3: createBlankCanvas(1280, 720, sf::Color::White); break;
-            case sf::Keyboard::Key::Num4: loadBitmapToCanvas("zrzut.png"); break;
-
-            case sf::Keyboard::Key::F:
-                waitingForColor = true;
-                std::cout << "Waiting for color key...\n";
-                break;
-
-            default:
-                if (waitingForColor) {
-                    sf::Color chosenColor;
-                    switch (keyPressed->code) {
-                    case sf::Keyboard::Key::R: chosenColor = sf::Color::Red; break;
-                    case sf::Keyboard::Key::G: chosenColor = sf::Color::Green; break;
-                    case sf::Keyboard::Key::B: chosenColor = sf::Color::Blue; break;
-                    case sf::Keyboard::Key::Y: chosenColor = sf::Color::Yellow; break;
-                    case sf::Keyboard::Key::C: chosenColor = sf::Color::Cyan; break;
-                    case sf::Keyboard::Key::M: chosenColor = sf::Color::Magenta; break;
-                    default:
-                        std::cout << "Invalid color key!\n";
-                        return;
-                    }
-                    sf::Vector2f pos(sf::Mouse::getPosition(window).x, sf::Mouse::getPosition(window).y);
-                    wypewnenia.push_back({ pos, chosenColor });
-                    waitingForColor = false;
-                    std::cout << "Added fill at (" << pos.x << ", " << pos.y
-                        << ") color: " << int(chosenColor.r) << "\n";
-                }
-                break;
+    default:
+        break; // akcje stanu (Move*) czytane z migawki przez obiekty
+    }
+}
+
+/**
+ * @brief Wykonuje polecenie zmieniające scenę (i zapisuje je, jeśli trwa nagrywanie).
+ * @param cmd Polecenie do wykonania.
+ */
+void Engine::execute(const DrawCommand& cmd) {
+    syncRender();
+    recorder.record(cmd);
+
+    switch (cmd.type) {
+    case CommandType::Point:
+    case CommandType::Line:
+    case CommandType::Polyline:
+    case CommandType::Polygon:
+    case CommandType::Circle:
+    case CommandType::Ellipse:
+    case CommandType::Fill:
+        context.execute(cmd); // listy rysowania i historia warstwy statycznej
+        break;
+
+    case CommandType::Undo:
+    case CommandType::Redo:
+        // Krok zapisany przy innym widoku kanwy kafelkowej — najpierw powrót do tego widoku
+        if (tiledCanvas.isActive() && context.getHistory()) {
+            context.flush(); // niezatwierdzone zmiany stają się krokiem w bieżącym widoku
+            const CanvasHistory& history = *context.getHistory();
+            const std::optional<sf::Vector2i> origin = cmd.type == CommandType::Undo
+                ? history.getUndoOrigin() : history.getRedoOrigin();
+            if (origin && *origin != tiledOrigin) {
+                pendingPan = {}; // widok wraca do położenia kroku
+                tiledView.setCenter(sf::Vector2f(*origin) + tiledView.getSize() / 2.f);
+                redrawTiledView(false);
             }
         }
+        context.execute(cmd);
+        break;
+
+    case CommandType::LoadCanvas:
+        snapshots.flush(); // zrzut mógł jeszcze nie trafić na dysk
+        loadBitmapToCanvas(cmd.filename);
+        break;
+
+    case CommandType::SaveCanvas:
+        requestSnapshot(cmd.filename);
+        break;
+
+    case CommandType::BlankCanvas:
+        createBlankCanvas(cmd.size.x, cmd.size.y, cmd.color);
+        break;
+
+    case CommandType::ResizeCanvas:
+        resizeCanvas(cmd.size.x, cmd.size.y, cmd.filter);
+        break;
+
+    case CommandType::ClearCanvas:
+        bitmap.clear();
+        tiledCanvas.clear();
+        context.setDamageTracking(false);
+        context.clear();
+        window.clear();
+        window.draw(sf::Sprite(staticCanvas.getTexture()));
+        window.display();
+        break;
+
+    case CommandType::SpawnOkreg:
+    {
+        Okreg* okreg = objects.getAs<Okreg>(spawn<Okreg>(cmd.points[0], cmd.radius, cmd.color));
+        okreg->setMovement(cmd.speed, cmd.angle);
+        okreg->setRotation(cmd.rotation);
+        break;
+    }
+
+    case CommandType::FrameEnd:
+        break;
+    }
+}
+
+/**
+ * @brief Rozpoczyna nagrywanie poleceń do dziennika.
+ * @param filename Plik dziennika.
+ * @return true jeśli udało się otworzyć plik.
+ */
+bool Engine::startRecording(const std::string& filename) {
+    if (!recorder.open(filename)) {
+        log("Cannot open command log for recording: " + filename);
+        return false;
     }
+    log("Recording commands to " + filename);
+    return true;
+}
+
+/**
+ * @brief Rozpoczyna odtwarzanie dziennika poleceń.
+ * @param filename Plik dziennika.
+ * @param timing Tempo odtwarzania.
+ * @return true jeśli dziennik jest poprawny.
+ */
+bool Engine::startReplay(const std::string& filename, ReplayTiming timing) {
+    if (!player.open(filename)) {
+        log("Cannot open command log for replay: " + filename);
+        return false;
+    }
+    replayTiming = timing;
+    if (timing == ReplayTiming::FullSpeed)
+        pacer.setTargetFps(0);
+    log("Replaying commands from " + filename);
+    return true;
 }
 
 /**
@@ -243,56 +515,125 @@ void Engine::handleInput() {
  * @param dt Delta czasu od ostatniej aktualizacji.
  */
 void Engine::update(float dt) {
-    for (auto& obj : objects)
+    // Usuwany obiekt może być właścicielem tekstury z renderowanej listy
+    if (objects.hasPendingDespawns()) syncRender();
+    objects.applyPending(); // obiekty dodane poza pętlą aktualizacji
+    animations.advance(dt); // wszystkie animacje jednym przebiegiem
+    behaviours.tick(dt);    // tylko zachowania, które mają pracę w tej klatce
+    for (UpdatableObject* obj : objects)
         obj->update(dt);
+    if (objects.hasPendingDespawns()) syncRender();
+    objects.applyPending(); // zmiany zlecone w trakcie aktualizacji
 }
 
 /**
- * @brief Renderuje całą scenę: statyczne i animowane obiekty.
- * @param canvas RenderTexture, na którym rysujemy.
+ * @brief Nagrywa rysowanie obiektów do listy bieżącej klatki.
+ *
+ * Wątek renderujący odtwarza w tym czasie listę poprzedniej klatki.
  */
-void Engine::render(sf::RenderTexture& canvas) {
-    PrimitiveRenderer staticRenderer(staticCanvas);
+void Engine::recordFrame() {
+    RenderCommandList& list = frameLists[recordList];
+    const sf::Vector2u size = staticCanvas.getSize();
+    list.reset(size, sf::View(sf::FloatRect({ 0.f, 0.f }, sf::Vector2f(size))));
+
+    PrimitiveRenderer objectRenderer(staticCanvas, list);
+    for (UpdatableObject* obj : objects) {
+        if (auto drawable = dynamic_cast<DrawableObject*>(obj)) {
+            drawable->draw(objectRenderer);
+        }
+    }
+    list.setStats(objectRenderer.getStats());
+}
 
-    if (bitmap.getTexture()) {
-        sf::Sprite back(*bitmap.getTexture());
-        staticCanvas.draw(back);
+/**
+ * @brief Renderuje klatkę z listy renderList i wyświetla ją w oknie.
+ */
+void Engine::renderFrame() {
+    // Przebiegi w kolejności zależności; nieużywane i niezmienione są pomijane
+    if (!renderGraph.execute()) {
+        renderFailed = true;
+        return;
     }
+    window.display();
+}
 
-    // Rysowanie obiektów globalnych
-    for (auto& poly : polygony) staticRenderer.drawPolygon(poly, sf::Color::Yellow);
-    for (auto& polyline : polyliny) staticRenderer.drawPolyline(polyline, sf::Color::Magenta);
-    for (auto& circle : okregy) staticRenderer.drawCircle(circle, 75.0, sf::Color::Green, sf::Color::Green);
-    for (auto& ellipse : elipsy) staticRenderer.drawElips(ellipse, 75.0, 100.0, sf::Color::Red, sf::Color::Red);
-    for (auto& line : linie) staticRenderer.drawLine(line.first, line.second, sf::Color::Cyan);
-    for (auto& fill : wypewnenia) staticRenderer.flood_fill(fill.pos, fill.color, sf::Color::Black);
-    for (auto& pt : punkty) staticRenderer.drawPoint(pt, sf::Color::White);
+/**
+ * @brief Zamienia listy i zleca renderowanie nagranej klatki.
+ */
+void Engine::presentFrame(HudSample sample) {
+    if (!renderThread.isRunning()) {
+        applyViewChanges();
+        std::swap(recordList, renderList);
+        renderFrame();
+        collectFrameStats();
+        sample.render = renderStats;
+        hud.record(sample);
+        return;
+    }
 
-    staticCanvas.display();
+    // Nakładka i liczniki są czytane przez wątek renderujący — zmiana po zakończeniu klatki
+    renderThread.wait();
+    collectFrameStats();
+    sample.renderMs = renderThread.getLastFrameMs();
+    sample.render = renderStats;
+    hud.record(sample);
 
-    // Render obiektów animowanych
-    animatedCanvas.clear(sf::Color::Transparent);
-    PrimitiveRenderer animRenderer(animatedCanvas);
-    for (auto& obj : objects) {
-        if (auto drawable = dynamic_cast<DrawableObject*>(obj.get())) {
-            drawable->draw(animRenderer);
-        }
+    applyViewChanges();
+    std::swap(recordList, renderList);
+    renderThread.submit();
+}
+
+/**
+ * @brief Nakłada zmiany widoku zebrane od poprzedniej klatki (przesunięcie kanwy kafelkowej, nakładka).
+ *
+ * Wywoływane, gdy wątek renderujący nie pracuje — akcje widoku nie czekają
+ * na zakończenie klatki w toku.
+ */
+void Engine::applyViewChanges() {
+    if (pendingPan != sf::Vector2f()) {
+        tiledView.move(pendingPan);
+        tiledViewDirty = true;
+        pendingPan = {};
+    }
+    if (hudTogglePending) {
+        hud.toggle();
+        hudTogglePending = false;
     }
-    animatedCanvas.display();
+}
 
-    // Wyświetlenie sceny
-    window.clear();
-    window.draw(sf::Sprite(staticCanvas.getTexture()));
-    window.draw(sf::Sprite(animatedCanvas.getTexture()));
-    window.display();
+/**
+ * @brief Zbiera liczniki zakończonej klatki.
+ */
+void Engine::collectFrameStats() {
+    // Liczniki klatki: warstwa statyczna (z poleceniami z obsługi wejścia)
+    // i przebiegi grafu (obiekty animowane, złożenie warstw, nakładka)
+    renderStats = context.getStats();
+    renderStats += renderGraph.getRenderStats();
+    context.resetStats();
+
+    // Arena geometrii jest zwalniana w flush(); sterta używana tylko przy jej wzroście
+    const FrameArena& arena = context.getArena();
+    if (arena.getHeapAllocations() != arenaHeapAllocations) {
+        arenaHeapAllocations = arena.getHeapAllocations();
+        log("Frame arena grew to " + std::to_string(arena.getCapacity()) + " bytes");
+    }
+}
 
-    // Czyszczenie buforów rysowania
-    linie.clear();
-    polyliny.clear();
-    polygony.clear();
-    okregy.clear();
-    elipsy.clear();
-    wypewnenia.clear();
+/**
+ * @brief Renderuje całą scenę w bieżącym wątku: statyczne i animowane obiekty.
+ * @param canvas RenderTexture, na którym rysujemy.
+ */
+void Engine::render(sf::RenderTexture& canvas) {
+    syncRender();
+    recordFrame();
+    std::swap(recordList, renderList);
+    renderFrame();
+    if (renderFailed) {
+        log("Render graph compilation failed");
+        isRunning = false;
+        return;
+    }
+    collectFrameStats();
 }
 
 /**
@@ -300,12 +641,86 @@ void Engine::render(sf::RenderTexture& canvas) {
  */
 void Engine::run() {
     init();
+
+    // Kontekst okna przechodzi do wątku renderującego; bez tego renderowanie zostaje w wątku głównym
+    if (window.setActive(false)) {
+        renderThread.start([this] { renderFrame(); },
+            [this] { if (!window.setActive(true)) renderFailed = true; },
+            [this] { (void)window.setActive(false); });
+    }
+    else {
+        log("Render thread disabled: cannot release the window context");
+    }
+
     sf::Clock clock;
+    sf::Clock replayClock;
+    std::size_t replayFrames = 0;
+    std::vector<DrawCommand> frameCommands;
     while (isRunning && window.isOpen()) {
         float dt = clock.restart().asSeconds();
+        sf::Clock phaseClock;
         handleInput();
+
+        // Odtwarzanie: polecenia i dt klatki pochodzą z dziennika
+        if (player.isPlaying()) {
+            float recordedDt = 0.f;
+            bool frameRead = player.readFrame(frameCommands, recordedDt);
+            for (const auto& cmd : frameCommands)
+                execute(cmd);
+            if (frameRead) {
+                if (replayTiming == ReplayTiming::Recorded && recordedDt > dt)
+                    sf::sleep(sf::seconds(recordedDt - dt));
+                dt = recordedDt;
+                ++replayFrames;
+            }
+            else {
+                log("Replay finished: " + std::to_string(replayFrames) + " frames in "
+                    + std::to_string(replayClock.getElapsedTime().asSeconds()) + " s");
+                player.close();
+                isRunning = false;
+            }
+        }
+        else {
+            replayClock.restart();
+        }
+
+        const float inputMs = phaseClock.restart().asSeconds() * 1000.f;
         update(dt);
-        render(staticCanvas);
+        const float updateMs = phaseClock.restart().asSeconds() * 1000.f;
+
+        // Klatka N+1 jest nagrywana, gdy wątek renderujący kończy klatkę N
+        recordFrame();
+        recorder.endFrame(dt);
+        const float recordMs = phaseClock.restart().asSeconds() * 1000.f;
+
+        // Pomiary dla nakładki wydajności (zbierane również gdy jest ukryta);
+        // przy wątku renderującym czas renderowania dotyczy poprzedniej klatki
+        const TextureMemoryStats texStats = TextureTracker::get().getStats();
+        presentFrame({ dt * 1000.f, inputMs, updateMs, recordMs, objects.size(), scene.getNodeCount(),
+            texStats.currentBytes, texStats.budgetBytes, texStats.textureCount });
+        if (renderFailed) {
+            log("Render graph compilation failed");
+            isRunning = false;
+        }
+
+        // Cykliczne zrzuty canvasu
+        if (snapshotInterval > 0.f) {
+            snapshotTimer += dt;
+            if (snapshotTimer >= snapshotInterval) {
+                snapshotTimer = 0.f;
+                const char* ext = snapshotFormat == SnapshotFormat::Qoi ? ".qoi"
+                    : snapshotFormat == SnapshotFormat::Bmp ? ".bmp" : ".png";
+                requestSnapshot("snapshot_" + std::to_string(snapshotCounter++) + ext, snapshotFormat);
+            }
+        }
+
+        // Raport zakończonych zapisów
+        for (const auto& result : snapshots.collectResults()) {
+            log("Snapshot " + result.filename + (result.success ? " saved in " : " FAILED after ")
+                + std::to_string(result.encodeSeconds) + " s");
+        }
+
+        pacer.endFrame();
     }
     shutdown();
 }
@@ -313,7 +728,76 @@ void Engine::run() {
 /**
  * @brief Punkt wejścia programu.
  */
-int main(void) {
+int main(int argc, char* argv[]) {
+    // Tryb pomiarowy: --bench [wyniki.json] [powtorzenia]
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        std::string out = argc > 2 ? argv[2] : "benchmark.json";
+        int reps = argc > 3 ? std::atoi(argv[3]) : 30;
+        Benchmark bench({ 1024, 1024 }, reps);
+        bench.runAll();
+        if (!bench.writeJson(out)) {
+            std::cerr << "Nie udało się zapisać wyników: " << out << std::endl;
+            return 1;
+        }
+        std::cout << "Zapisano " << bench.getResults().size() << " wyników do " << out << std::endl;
+        return 0;
+    }
+
+    // Testy regresji obrazu i czasu: --regression [katalog_wzorcow] [--update]
+    // Kod wyjścia: 0 — brak regresji, 1 — regresja, 2 — brak wzorców (najpierw --update)
+    if (argc > 1 && std::string(argv[1]) == "--regression") {
+        RegressionOptions options;
+        std::string dir = "golden";
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--update") options.update = true;
+            else dir = arg;
+        }
+        RegressionSuite suite(dir, options);
+        bool ok = suite.run();
+        if (ok && suite.getMissingCount() > 0) {
+            std::cout << "Brak wzorców dla " << suite.getMissingCount() << " przypadków w " << dir
+                << " — utwórz je przez --regression " << dir << " --update" << std::endl;
+            return 2;
+        }
+        std::cout << (options.update ? "Zapisano wzorce w " + dir : ok ? "Brak regresji" : "Wykryto regresję") << std::endl;
+        return ok ? 0 : 1;
+    }
+
+    // Renderowanie wsadowe bez okna: --batch katalog plik1.s2dr [plik2.s2dr ...]
+    // Każdy dziennik poleceń staje się osobną sceną, zapisywaną jako PNG
+    if (argc > 2 && std::string(argv[1]) == "--batch") {
+        std::filesystem::path outDir = argv[2];
+        std::filesystem::create_directories(outDir);
+        BatchRenderer batch;
+        for (int i = 3; i < argc; ++i) {
+            CommandPlayer replay;
+            if (!replay.open(argv[i])) {
+                std::cerr << "Nie udało się otworzyć dziennika: " << argv[i] << std::endl;
+                continue;
+            }
+            RenderJob job;
+            job.size = { 1280, 720 };
+            job.output = (outDir / std::filesystem::path(argv[i]).stem()).string() + ".png";
+            std::vector<DrawCommand> frame;
+            float dt = 0.f;
+            while (replay.readFrame(frame, dt)) {
+                for (auto& cmd : frame) job.commands.push_back(std::move(cmd));
+                job.commands.push_back({ CommandType::FrameEnd });
+            }
+            batch.submit(std::move(job));
+        }
+        batch.wait();
+        int failed = 0;
+        for (const auto& result : batch.collectResults()) {
+            if (!result.success) ++failed;
+            std::cout << result.output << (result.success ? " OK " : " FAILED ")
+                << result.renderSeconds * 1000.f << " ms + " << result.encodeSeconds * 1000.f << " ms\n";
+        }
+        std::cout << "Wątki: " << batch.getThreadCount() << std::endl;
+        return failed ? 1 : 0;
+    }
+
     EngineConfig config;
     config.width = 1280;
     config.height = 720;
@@ -324,22 +808,49 @@ int main(void) {
 
     Engine& engine = Engine::getInstance(config);
 
-    // Wczytywanie bitmap gracza (animacje w 4 kierunkach)
-    std::vector<std::vector<BitmapHandler>> playerBitmaps(4);
+    // Test obciążeniowy: --stress [wyniki.csv] [maksymalne N]
+    if (argc > 1 && std::string(argv[1]) == "--stress") {
+        StressConfig stressConfig;
+        if (argc > 2) stressConfig.output = argv[2];
+        if (argc > 3) stressConfig.maxCount = static_cast<unsigned int>(std::atoi(argv[3]));
+        bool ok = StressScene(engine, stressConfig).run();
+        engine.shutdown();
+        return ok ? 0 : 1;
+    }
+
+    // Wczytywanie bitmap gracza — jeden klip chodu na każdy z 4 kierunków
+    std::array<ClipId, 4> walkClips;
     for (int dir = 0; dir < 4; ++dir) {
+        std::vector<BitmapHandler> frames;
         for (int f = 0; f < 4; ++f) {
             BitmapHandler bmp;
             std::string filename = "player_" + std::to_string(dir) + "_" + std::to_string(f) + ".png";
             if (!bmp.loadFromFile(filename)) {
                 std::cerr << "Nie udało się załadować bitmapy: " << filename << std::endl;
             }
-            playerBitmaps[dir].push_back(bmp);
+            frames.push_back(bmp);
         }
+        walkClips[dir] = engine.getAnimations().createClip(frames, 0.12f);
     }
 
-    auto player = std::make_unique<Player>(playerBitmaps);
+    auto player = std::make_unique<Player>(engine.getAnimations(), walkClips, engine.getInput());
     engine.addObject(std::move(player));
 
+    // Nagrywanie i odtwarzanie dziennika poleceń:
+    //   --record plik.s2dr | --replay plik.s2dr [--realtime]
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--record" && i + 1 < argc) {
+            engine.startRecording(argv[++i]);
+        }
+        else if (arg == "--replay" && i + 1 < argc) {
+            std::string file = argv[++i];
+            bool realtime = i + 1 < argc && std::string(argv[i + 1]) == "--realtime";
+            if (realtime) ++i;
+            engine.startReplay(file, realtime ? ReplayTiming::Recorded : ReplayTiming::FullSpeed);
+        }
+    }
+
     engine.run();
     return 0;
 }
@@ -2,6 +2,21 @@
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Graphics.hpp>
 #include "GameObject.hpp"
+#include "SnapshotWriter.hpp"
+#include "TiledCanvas.hpp"
+#include "RenderContext.hpp"
+#include "CommandLog.hpp"
+#include "ObjectStore.hpp"
+#include "FramePacer.hpp"
+#include "PerfHud.hpp"
+#include "Behaviour.hpp"
+#include "Input.hpp"
+#include "RenderGraph.hpp"
+#include "RenderCommandList.hpp"
+#include "RenderThread.hpp"
+#include <array>
+#include <atomic>
+#include <random>
 
 /**
  * @struct EngineConfig
@@ -15,8 +30,14 @@ struct EngineConfig {
     unsigned int height = 600;              ///< Wysokość okna.
     bool fullscreen = false;                ///< Czy uruchomić w trybie pełnoekranowym.
     unsigned int fps = 60;                  ///< Docelowa liczba klatek na sekundę.
+    bool adaptivePacing = false;            ///< Czy obniżać tempo (fps/2, fps/4), gdy klatki nie mieszczą się w budżecie.
     sf::Color clearColor = sf::Color::Black;///< Kolor używany do czyszczenia ekranu.
     std::string windowTitle = "Engine Window"; ///< Tytuł okna.
+    float snapshotInterval = 0.f;           ///< Odstęp cyklicznych zrzutów canvasu w sekundach (0 = wyłączone).
+    SnapshotFormat snapshotFormat = SnapshotFormat::Qoi; ///< Format cyklicznych zrzutów.
+    std::size_t textureBudget = 0;          ///< Budżet pamięci tekstur w bajtach (0 = bez limitu).
+    TextureBudgetPolicy textureBudgetPolicy = TextureBudgetPolicy::Warn; ///< Reakcja na przekroczenie budżetu.
+    std::size_t historyBudget = 64u << 20;  ///< Limit pamięci historii cofania w bajtach (0 = bez cofania).
 };
 
 /**
@@ -28,7 +49,8 @@ struct EngineConfig {
  * - zarządzanie pętlą gry,
  * - obsługę wejścia,
  * - aktualizację logiki obiektów,
- * - renderowanie na dwóch warstwach: statycznej i animowanej,
+ * - renderowanie warstw (statyczna, animowana, nakładka) grafem przebiegów
+ *   w osobnym wątku, równolegle z aktualizacją kolejnej klatki,
  * - obsługę bitmap przez BitmapHandler,
  * - przechowywanie obiektów implementujących UpdatableObject.
  *
@@ -42,10 +64,101 @@ private:
     bool isRunning = false;                ///< Flaga działania głównej pętli gry.
     sf::Color clearColor;                  ///< Kolor czyszczenia sceny.
 
-    sf::RenderTexture staticCanvas;        ///< Warstwa statyczna (tło, prymitywy, bitmapy).
-    sf::RenderTexture animatedCanvas;      ///< Warstwa animowana (gracz, obiekty ruchome).
+    RenderContext context;                 ///< Warstwa statyczna z listami rysowania i pamięcią wypełnień.
+    std::size_t arenaHeapAllocations = 0;  ///< Ostatnio zgłoszona liczba alokacji bloków areny kontekstu.
+    sf::RenderTexture& staticCanvas;       ///< Kanwa warstwy statycznej (należy do context).
     sf::Sprite canvasSprite;               ///< Sprite łączący warstwy do finalnego renderingu.
 
+    RenderGraph renderGraph;               ///< Przebiegi renderowania klatki i złożenie warstw.
+    RenderResource staticLayer = InvalidRenderResource;   ///< Warstwa statyczna (kanwa context).
+    RenderResource animatedLayer = InvalidRenderResource; ///< Warstwa animowana (zasób tymczasowy).
+    RenderResource backbuffer = InvalidRenderResource;    ///< Okno.
+    std::size_t compositePass = 0;         ///< Przebieg złożenia warstw w oknie.
+
+    std::array<RenderCommandList, 2> frameLists; ///< Nagrane rysowanie obiektów (nagrywana i renderowana klatka).
+    std::size_t recordList = 0;            ///< Lista nagrywana przez wątek główny.
+    std::size_t renderList = 1;            ///< Lista odtwarzana przez wątek renderujący.
+    std::atomic<bool> renderFailed{ false }; ///< Graf renderowania nie dał się skompilować.
+
+    /**
+     * @brief Deklaruje przebiegi domyślne: tło kafelkowe, warstwa statyczna,
+     * obiekty animowane, złożenie w oknie i nakładka wydajności.
+     */
+    void buildRenderGraph();
+
+    /**
+     * @brief Nagrywa rysowanie obiektów do listy bieżącej klatki (wątek główny).
+     */
+    void recordFrame();
+
+    /**
+     * @brief Renderuje ostatnio przekazaną klatkę i wyświetla ją w oknie.
+     */
+    void renderFrame();
+
+    /**
+     * @brief Przekazuje nagraną klatkę do renderowania (zamiana list).
+     *
+     * Czeka na zakończenie poprzedniej klatki, zbiera jej liczniki i zapisuje
+     * pomiary nakładki. Bez wątku renderującego renderuje klatkę od razu.
+     *
+     * @param sample Pomiary wątku głównego (liczniki GPU uzupełniane tutaj).
+     */
+    void presentFrame(HudSample sample);
+
+    /**
+     * @brief Zbiera liczniki zakończonej klatki (warstwa statyczna i przebiegi grafu).
+     */
+    void collectFrameStats();
+
+    /**
+     * @brief Nakłada zmiany widoku zebrane od poprzedniej klatki (przesunięcie, nakładka).
+     */
+    void applyViewChanges();
+
+    sf::Vector2f pendingPan;               ///< Przesunięcie widoku kanwy kafelkowej czekające na kolejną klatkę.
+    bool hudTogglePending = false;         ///< Przełączenie nakładki czekające na kolejną klatkę.
+
+    /**
+     * @brief Czeka, aż wątek renderujący zakończy klatkę — przed każdą zmianą
+     * kanwy, list rysowania lub obiektów, z których korzysta renderowanie.
+     */
+    void syncRender() { renderThread.wait(); }
+
+    TiledCanvas tiledCanvas;               ///< Kanwa kafelkowa dla obrazów większych niż limit tekstury.
+    sf::View tiledView;                    ///< Widok określający widoczny fragment kanwy kafelkowej.
+    bool tiledViewDirty = false;           ///< Czy widok kanwy kafelkowej zmienił się od ostatniego rysowania.
+    sf::Vector2i tiledOrigin;              ///< Położenie warstwy statycznej w kanwie kafelkowej (ostatnio narysowany widok).
+
+    /**
+     * @brief Oznacza zmianę zawartości warstwy statycznej (nowa wersja kanwy).
+     */
+    void touchStaticCanvas() { context.touch(); }
+
+    /**
+     * @brief Rysuje widoczny fragment kanwy kafelkowej na warstwie statycznej.
+     * @param newDocument Czy to nowy obraz (historia od nowa), a nie przesunięcie widoku.
+     */
+    void redrawTiledView(bool newDocument);
+
+    CommandRecorder recorder;              ///< Nagrywanie poleceń do dziennika.
+    CommandPlayer player;                  ///< Odtwarzanie dziennika poleceń.
+    ReplayTiming replayTiming = ReplayTiming::FullSpeed; ///< Tempo odtwarzania.
+    std::mt19937 rng{ 2024 };              ///< Generator parametrów tworzonych obiektów.
+
+    FramePacer pacer;                      ///< Odmierzanie klatek i statystyki opóźnień.
+    PerfHud hud;                           ///< Nakładka wydajności (F3).
+    RenderStats renderStats;               ///< Liczniki pracy GPU ostatniej klatki.
+
+    InputSystem input;                     ///< Migawka wejścia i przypisania akcji.
+    bool fillPending = false;              ///< Akcja Fill czeka na wybór koloru.
+
+    SnapshotWriter snapshots;              ///< Kodowanie i zapis zrzutów w wątku tła.
+    float snapshotInterval = 0.f;          ///< Odstęp cyklicznych zrzutów (0 = wyłączone).
+    SnapshotFormat snapshotFormat;         ///< Format cyklicznych zrzutów.
+    float snapshotTimer = 0.f;             ///< Czas od ostatniego cyklicznego zrzutu.
+    unsigned int snapshotCounter = 0;      ///< Numer kolejnego cyklicznego zrzutu.
+
     /**
      * @brief Prywatny konstruktor — część wzorca Singleton.
      *
@@ -53,7 +166,11 @@ private:
      */
     Engine(const EngineConfig& config);
 
-    std::vector<std::unique_ptr<UpdatableObject>> objects; ///< Lista obiektów podlegających aktualizacji.
+    AnimationSystem animations;            ///< Współdzielone klipy i stany animacji (żyją dłużej niż obiekty).
+    SceneGraph scene;                      ///< Hierarchia przekształceń (żyje dłużej niż obiekty).
+    ObjectStore objects;                   ///< Obiekty podlegające aktualizacji (uchwyty generacyjne, pule).
+    BehaviourScheduler behaviours;         ///< Korutyny zachowań (niszczone przed obiektami, którymi sterują).
+    RenderThread renderThread;             ///< Wątek renderujący (zatrzymywany przed zniszczeniem reszty).
 
 public:
     BitmapHandler bitmap; ///< Obsługa bitmap — wczytywanie, zapisywanie, generowanie.
@@ -82,6 +199,9 @@ public:
     /**
      * @brief Ładuje bitmapę z pliku i umieszcza ją na warstwie statycznej.
      *
+     * Obrazy większe niż limit tekstury GPU są wczytywane do kanwy
+     * kafelkowej (TiledCanvas), po której można przesuwać widok strzałkami.
+     *
      * @param filename Ścieżka do pliku.
      * @return true jeśli udało się wczytać bitmapę, false w przeciwnym razie.
      */
@@ -90,20 +210,80 @@ public:
     /**
      * @brief Zapisuje aktualny stan warstwy statycznej do pliku.
      *
+     * Zapis jest synchroniczny — pętla gry czeka na zakończenie kodowania.
+     * W trakcie działania silnika należy używać requestSnapshot().
+     *
      * @param filename Nazwa pliku wynikowego.
      * @return true jeśli zapis zakończył się sukcesem.
      */
     bool saveCanvasToFile(const std::string& filename);
 
+    /**
+     * @brief Przechwytuje warstwę statyczną i zleca jej zapis w wątku tła.
+     *
+     * Na wątku głównym wykonywany jest jedynie odczyt pikseli z GPU,
+     * kodowanie i zapis odbywają się w SnapshotWriter. Wynik jest
+     * zapisywany do engine.log po zakończeniu.
+     *
+     * @param filename Nazwa pliku wynikowego.
+     * @param format Format zapisu.
+     */
+    void requestSnapshot(const std::string& filename, SnapshotFormat format = SnapshotFormat::Png);
+
     /**
      * @brief Tworzy pustą warstwę statyczną o podanym rozmiarze i kolorze.
      *
+     * Rozmiary przekraczające limit tekstury GPU tworzą kanwę kafelkową.
+     *
      * @param w Szerokość.
      * @param h Wysokość.
      * @param c Kolor wypełnienia.
      */
     void createBlankCanvas(unsigned w, unsigned h, sf::Color c);
 
+    /**
+     * @brief Przeskalowuje obraz warstwy statycznej do podanego rozmiaru.
+     *
+     * Wynik trafia do lewego górnego rogu kanwy. Kanwa kafelkowa
+     * nie jest przeskalowywana.
+     *
+     * @param w Szerokość.
+     * @param h Wysokość.
+     * @param filter Filtr.
+     */
+    void resizeCanvas(unsigned w, unsigned h, ResampleFilter filter);
+
+    /**
+     * @brief Wykonuje polecenie zmieniające scenę.
+     *
+     * Jedyny punkt wejścia dla zmian sceny z wejścia użytkownika oraz
+     * z odtwarzanego dziennika. Jeśli trwa nagrywanie, polecenie jest
+     * zapisywane w bieżącej klatce.
+     *
+     * @param cmd Polecenie.
+     */
+    void execute(const DrawCommand& cmd);
+
+    /**
+     * @brief Rozpoczyna nagrywanie poleceń do dziennika binarnego.
+     *
+     * @param filename Plik dziennika.
+     * @return true jeśli udało się otworzyć plik.
+     */
+    bool startRecording(const std::string& filename);
+
+    /**
+     * @brief Rozpoczyna odtwarzanie dziennika poleceń.
+     *
+     * Każda klatka dziennika jest wykonywana z zapisanym dt. Po zakończeniu
+     * dziennika silnik zapisuje czas odtwarzania do engine.log i kończy pracę.
+     *
+     * @param filename Plik dziennika.
+     * @param timing Tempo odtwarzania.
+     * @return true jeśli dziennik jest poprawny.
+     */
+    bool startReplay(const std::string& filename, ReplayTiming timing = ReplayTiming::FullSpeed);
+
     /**
      * @brief Inicjalizuje silnik: tworzy okno, ustawia canvas i parametry renderowania.
      */
@@ -111,9 +291,19 @@ public:
 
     /**
      * @brief Obsługuje wejście użytkownika (klawiatura, mysz).
+     *
+     * Zdarzenia okna budują migawkę wejścia, a wyzwolone akcje są
+     * wykonywane w kolejności zdarzeń.
      */
     void handleInput();
 
+    /**
+     * @brief Wykonuje akcję wyzwoloną klawiszem lub przyciskiem myszy.
+     * @param action Akcja.
+     * @param pos Położenie kursora w chwili zdarzenia.
+     */
+    void onAction(InputAction action, sf::Vector2f pos);
+
     /**
      * @brief Uruchamia główną pętlę gry.
      *
@@ -133,12 +323,44 @@ public:
     void update(float dt);
 
     /**
-     * @brief Renderuje obecną scenę do podanego canvasu.
+     * @brief Renderuje obecną scenę do podanego canvasu (synchronicznie, w bieżącym wątku).
      *
      * @param canvas RenderTexture, do którego mają być rysowane warstwy.
      */
     void render(sf::RenderTexture& canvas);
 
+    /**
+     * @brief Renderuje obecną scenę na warstwie statycznej silnika.
+     */
+    void render() { render(staticCanvas); }
+
+    /**
+     * @brief Sprawdza, czy silnik działa (okno otwarte, brak żądania zamknięcia).
+     * @return true jeśli pętla gry może być kontynuowana.
+     */
+    bool isOpen() const { return isRunning && window.isOpen(); }
+
+    /**
+     * @brief Zwraca rozmiar warstw rysowania.
+     * @return Rozmiar kanwy w pikselach.
+     */
+    sf::Vector2u getCanvasSize() const { return staticCanvas.getSize(); }
+
+    /**
+     * @brief Zmienia docelowe tempo klatek (0 = bez limitu).
+     * @param fps Liczba klatek na sekundę.
+     */
+    void setTargetFps(unsigned int fps) { pacer.setTargetFps(fps); }
+
+    /**
+     * @brief Usuwa natychmiast wszystkie obiekty i zatrzymuje zachowania (nie wywoływać w trakcie update()).
+     */
+    void clearObjects() {
+        syncRender();
+        behaviours.clear();
+        objects.clear();
+    }
+
     /**
      * @brief Zamyka silnik — kończy działanie pętli gry.
      */
@@ -147,9 +369,107 @@ public:
     /**
      * @brief Dodaje obiekt do aktualizacji w pętli gry.
      *
+     * Obiekt staje się aktywny w najbliższym bezpiecznym punkcie klatki.
+     *
      * @param obj Obiekt implementujący UpdatableObject.
+     * @return Uchwyt obiektu.
+     */
+    ObjectHandle addObject(std::unique_ptr<UpdatableObject> obj) {
+        return objects.adopt(std::move(obj));
+    }
+
+    /**
+     * @brief Tworzy obiekt w puli silnika (bez osobnej alokacji na stercie).
+     *
+     * Można wywoływać w trakcie update() — obiekt dołączy do sceny
+     * w najbliższym bezpiecznym punkcie klatki.
+     *
+     * @param args Argumenty konstruktora T.
+     * @return Uchwyt obiektu.
+     */
+    template <typename T, typename... Args>
+    ObjectHandle spawn(Args&&... args) {
+        return objects.spawn<T>(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Usuwa obiekt w najbliższym bezpiecznym punkcie klatki.
+     * @param handle Uchwyt obiektu (nieaktualne uchwyty są ignorowane).
+     */
+    void despawn(ObjectHandle handle) { objects.despawn(handle); }
+
+    /**
+     * @brief Zwraca obiekt dla uchwytu.
+     * @param handle Uchwyt obiektu.
+     * @return Wskaźnik na obiekt lub nullptr, jeśli obiekt już nie istnieje.
      */
-    void addObject(std::unique_ptr<UpdatableObject> obj) {
-        objects.push_back(std::move(obj));
+    UpdatableObject* getObject(ObjectHandle handle) const { return objects.get(handle); }
+
+    /**
+     * @brief Zwraca system animacji (tworzenie klipów i sprite'ów).
+     * @return Referencja do AnimationSystem.
+     */
+    AnimationSystem& getAnimations() { return animations; }
+
+    /**
+     * @brief Zwraca harmonogram zachowań (korutyny wznawiane raz na klatkę przed update() obiektów).
+     * @return Referencja do BehaviourScheduler.
+     */
+    BehaviourScheduler& getBehaviours() { return behaviours; }
+
+    /**
+     * @brief Zwraca migawkę wejścia bieżącej klatki (do odczytu przez obiekty).
+     * @return Referencja do InputState (ważna przez cały czas życia silnika).
+     */
+    const InputState& getInput() const { return input.getState(); }
+
+    /**
+     * @brief Zwraca przypisania klawiszy do akcji (zmiana sterowania).
+     * @return Referencja do InputMap.
+     */
+    InputMap& getInputMap() { return input.getMap(); }
+
+    /**
+     * @brief Zwraca graf renderowania (dodawanie przebiegów i zasobów).
+     *
+     * Czeka na zakończenie renderowanej klatki — graf można zmieniać
+     * do końca bieżącej klatki wątku głównego.
+     *
+     * @return Referencja do RenderGraph.
+     */
+    RenderGraph& getRenderGraph() {
+        syncRender();
+        return renderGraph;
+    }
+
+    /**
+     * @brief Dodaje warstwę do złożenia w oknie (nad obiektami animowanymi, pod nakładką).
+     *
+     * Zasób warstwy musi być zapisywany przez przebieg dodany do getRenderGraph().
+     *
+     * @param layer Zasób warstwy.
+     * @param blend Tryb mieszania (np. sf::BlendMultiply dla oświetlenia).
+     */
+    void addRenderLayer(RenderResource layer, sf::BlendMode blend = sf::BlendAlpha) {
+        syncRender();
+        renderGraph.addLayer(compositePass, layer, blend);
     }
+
+    /**
+     * @brief Zwraca zasób warstwy statycznej (do odczytu w przebiegach).
+     * @return Zasób grafu renderowania.
+     */
+    RenderResource getStaticLayer() const { return staticLayer; }
+
+    /**
+     * @brief Zwraca graf sceny (węzły obiektów SceneObject).
+     * @return Referencja do SceneGraph.
+     */
+    SceneGraph& getScene() { return scene; }
+
+    /**
+     * @brief Zwraca statystyki czasu klatek (p50/p95/p99, spóźnione klatki).
+     * @return Statystyki z FramePacer.
+     */
+    FrameStats getFrameStats() const { return pacer.getStats(); }
 };
\ No newline at end of file
@@ -0,0 +1,117 @@
+﻿#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "PrimitiveRenderer.hpp"
+
+/**
+ * @class FillCache
+ * @brief Pamięć podręczna wyników wypełnień w postaci list odcinków.
+ *
+ * Wynik wypełnienia zależy wyłącznie od punktu startowego, kolorów oraz
+ * zawartości kanwy. Zawartość kanwy identyfikowana jest numerem wersji,
+ * zmienianym przy każdej modyfikacji warstwy statycznej — dzięki temu
+ * powtórzone wypełnienie nie wymaga odczytu z GPU ani ponownego
+ * przeszukiwania obrazu, a jedynie narysowania zapamiętanych odcinków.
+ */
+class FillCache {
+public:
+    /**
+     * @struct Key
+     * @brief Klucz wypełnienia: ziarno, kolory i wersja kanwy.
+     */
+    struct Key {
+        int x;                    ///< Kolumna punktu startowego.
+        int y;                    ///< Wiersz punktu startowego.
+        std::uint32_t fill;       ///< Kolor wypełnienia (sf::Color::toInteger).
+        std::uint32_t background; ///< Kolor tła (sf::Color::toInteger).
+        std::uint64_t version;    ///< Wersja kanwy przed wypełnieniem.
+
+        bool operator==(const Key& o) const {
+            return x == o.x && y == o.y && fill == o.fill && background == o.background && version == o.version;
+        }
+    };
+
+    /**
+     * @struct Entry
+     * @brief Zapamiętany wynik wypełnienia.
+     */
+    struct Entry {
+        std::vector<FillSpan> spans; ///< Odcinki wypełnionego obszaru.
+        std::uint64_t resultVersion; ///< Wersja kanwy po nałożeniu wypełnienia.
+    };
+
+private:
+    /**
+     * @struct KeyHash
+     * @brief Funkcja skrótu dla klucza wypełnienia.
+     */
+    struct KeyHash {
+        std::size_t operator()(const Key& k) const {
+            std::uint64_t h = k.version * 0x9E3779B97F4A7C15ull;
+            h ^= (static_cast<std::uint64_t>(static_cast<std::uint32_t>(k.x)) << 32 | static_cast<std::uint32_t>(k.y)) + (h << 6) + (h >> 2);
+            h ^= (static_cast<std::uint64_t>(k.fill) << 32 | k.background) + (h << 6) + (h >> 2);
+            return static_cast<std::size_t>(h);
+        }
+    };
+
+    std::unordered_map<Key, Entry, KeyHash> entries; ///< Zapamiętane wypełnienia.
+    std::size_t maxEntries;  ///< Limit liczby wpisów.
+    std::size_t hits = 0;    ///< Liczba trafień.
+    std::size_t misses = 0;  ///< Liczba chybień.
+
+public:
+    /**
+     * @brief Konstruktor.
+     * @param maxEntries Maksymalna liczba przechowywanych wypełnień.
+     */
+    explicit FillCache(std::size_t maxEntries = 256) : maxEntries(maxEntries) {}
+
+    /**
+     * @brief Wyszukuje zapamiętane wypełnienie.
+     * @param key Klucz wypełnienia.
+     * @return Wskaźnik do wpisu lub nullptr.
+     */
+    const Entry* find(const Key& key) {
+        auto it = entries.find(key);
+        if (it == entries.end()) {
+            ++misses;
+            return nullptr;
+        }
+        ++hits;
+        return &it->second;
+    }
+
+    /**
+     * @brief Zapamiętuje wynik wypełnienia.
+     *
+     * Po osiągnięciu limitu usuwane są wpisy dotyczące innych wersji
+     * kanwy niż bieżąca. Jeśli to nie zwolni co najmniej połowy miejsca
+     * (np. wiele wypełnień bez zmian kanwy w jednej wersji), usuwane są
+     * wszystkie wpisy — limit obowiązuje zawsze, a przegląd mapy wykonywany
+     * jest najwyżej raz na maxEntries / 2 zapisów.
+     *
+     * @param key Klucz wypełnienia.
+     * @param entry Wynik wypełnienia.
+     * @return Referencja do zapisanego wpisu.
+     */
+    const Entry& store(const Key& key, Entry entry) {
+        if (entries.size() >= maxEntries) {
+            for (auto it = entries.begin(); it != entries.end();) {
+                if (it->first.version != key.version) it = entries.erase(it);
+                else ++it;
+            }
+            if (entries.size() > maxEntries / 2) entries.clear();
+        }
+        return entries.insert_or_assign(key, std::move(entry)).first->second;
+    }
+
+    /**
+     * @brief Usuwa wszystkie wpisy.
+     */
+    void clear() { entries.clear(); }
+
+    std::size_t getHits() const { return hits; }     ///< Zwraca liczbę trafień.
+    std::size_t getMisses() const { return misses; } ///< Zwraca liczbę chybień.
+};
@@ -0,0 +1,62 @@
+﻿#include "FrameArena.hpp"
+#include <algorithm>
+#include <cstdint>
+
+FrameArena::FrameArena(std::size_t initialBytes) {
+    grow(std::max<std::size_t>(initialBytes, 256));
+}
+
+void FrameArena::grow(std::size_t minBytes) {
+    std::size_t size = blocks.empty() ? minBytes : std::max(minBytes, blocks.back().size * 2);
+    blocks.push_back({ std::make_unique<std::byte[]>(size), size });
+    offset = 0;
+    ++heapAllocations;
+}
+
+// ------------------------------
+// Alokacja
+// ------------------------------
+void* FrameArena::allocate(std::size_t bytes, std::size_t alignment) {
+    auto alignUp = [alignment](std::uintptr_t p) { return (p + alignment - 1) & ~(std::uintptr_t(alignment) - 1); };
+
+    Block* block = &blocks.back();
+    std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block->memory.get());
+    std::uintptr_t start = alignUp(base + offset);
+
+    if (start + bytes > base + block->size) {
+        grow(bytes + alignment);
+        block = &blocks.back();
+        base = reinterpret_cast<std::uintptr_t>(block->memory.get());
+        start = alignUp(base);
+    }
+
+    offset = start + bytes - base;
+    used += bytes;
+    ++allocations;
+    return reinterpret_cast<void*>(start);
+}
+
+// ------------------------------
+// Reset na końcu klatki
+// ------------------------------
+void FrameArena::reset() {
+    peak = std::max(peak, used);
+
+    // Jeśli klatka przepełniła blok, scal bloki w jeden — kolejne klatki
+    // o podobnym zużyciu zmieszczą się bez sięgania po stertę
+    if (blocks.size() > 1) {
+        std::size_t total = getCapacity();
+        blocks.clear();
+        grow(total);
+    }
+
+    offset = 0;
+    used = 0;
+    allocations = 0;
+}
+
+std::size_t FrameArena::getCapacity() const {
+    std::size_t total = 0;
+    for (const auto& b : blocks) total += b.size;
+    return total;
+}
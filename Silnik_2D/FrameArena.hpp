@@ -0,0 +1,99 @@
+﻿#pragma once
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @struct ArenaSpan
+ * @brief Widok na tablicę elementów umieszczoną w FrameArena.
+ *
+ * Nie jest właścicielem pamięci — traci ważność po FrameArena::reset().
+ */
+template <typename T>
+struct ArenaSpan {
+    T* data = nullptr;      ///< Początek tablicy.
+    std::size_t count = 0;  ///< Liczba elementów.
+
+    T* begin() const { return data; }
+    T* end() const { return data + count; }
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    T& operator[](std::size_t i) const { return data[i]; }
+};
+
+/**
+ * @class FrameArena
+ * @brief Alokator liniowy (bump allocator) dla danych żyjących jedną klatkę.
+ *
+ * Alokacja to przesunięcie wskaźnika w bieżącym bloku, a reset() na końcu
+ * klatki zeruje przesunięcie w O(1). Gdy bloku zabraknie, dokładany jest
+ * kolejny; przy najbliższym resecie bloki są scalane w jeden o łącznym
+ * rozmiarze, więc po rozgrzaniu arena przestaje korzystać ze sterty.
+ * Obsługiwane są wyłącznie typy trywialnie kopiowalne (bez destruktorów).
+ */
+class FrameArena {
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> memory; ///< Pamięć bloku.
+        std::size_t size = 0;                ///< Rozmiar bloku w bajtach.
+    };
+
+    std::vector<Block> blocks;        ///< Bloki (po resecie zawsze jeden).
+    std::size_t offset = 0;           ///< Przesunięcie w ostatnim bloku.
+    std::size_t used = 0;             ///< Bajty zajęte w bieżącej klatce.
+    std::size_t peak = 0;             ///< Największe zużycie w jednej klatce.
+    std::size_t allocations = 0;      ///< Alokacje w bieżącej klatce.
+    std::size_t heapAllocations = 0;  ///< Łączna liczba alokacji bloków na stercie.
+
+    /**
+     * @brief Dokłada nowy blok mieszczący co najmniej podaną liczbę bajtów.
+     * @param minBytes Minimalny rozmiar bloku.
+     */
+    void grow(std::size_t minBytes);
+
+public:
+    /**
+     * @brief Konstruktor.
+     * @param initialBytes Rozmiar pierwszego bloku.
+     */
+    explicit FrameArena(std::size_t initialBytes = 64 * 1024);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /**
+     * @brief Przydziela surową pamięć.
+     * @param bytes Liczba bajtów.
+     * @param alignment Wyrównanie (potęga dwójki).
+     * @return Wskaźnik ważny do najbliższego reset().
+     */
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * @brief Kopiuje tablicę elementów do areny.
+     * @param src Dane źródłowe.
+     * @param count Liczba elementów.
+     * @return Widok na skopiowane dane.
+     */
+    template <typename T>
+    ArenaSpan<T> copy(const T* src, std::size_t count) {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+            "FrameArena przechowuje wyłącznie typy trywialne");
+        if (count == 0) return {};
+        T* dst = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+        std::uninitialized_copy(src, src + count, dst);
+        return { dst, count };
+    }
+
+    /**
+     * @brief Zwalnia całą zawartość areny (koniec klatki).
+     */
+    void reset();
+
+    std::size_t getUsedBytes() const { return used; }              ///< Bajty zajęte w bieżącej klatce.
+    std::size_t getPeakBytes() const { return peak; }              ///< Największe zużycie w jednej klatce.
+    std::size_t getCapacity() const;                               ///< Łączny rozmiar bloków.
+    std::size_t getAllocations() const { return allocations; }     ///< Alokacje w bieżącej klatce.
+    std::size_t getHeapAllocations() const { return heapAllocations; } ///< Alokacje bloków na stercie.
+};
@@ -0,0 +1,140 @@
+﻿#include "FramePacer.hpp"
+#include <algorithm>
+#include <thread>
+#define NOMINMAX
+#include <Windows.h>
+#include <timeapi.h>
+#pragma comment(lib, "winmm.lib")
+
+namespace {
+constexpr double MinSpinMargin = 0.0005; ///< Najmniejszy margines aktywnego oczekiwania [s].
+constexpr double MaxSpinMargin = 0.004;  ///< Największy margines aktywnego oczekiwania [s].
+constexpr unsigned int MaxDivisor = 4;   ///< Najniższe tempo adaptacyjne: fps / 4.
+constexpr std::uint64_t AdaptInterval = 60; ///< Minimalny odstęp między zmianami tempa (klatki).
+
+double seconds(FramePacer::Clock::duration d) {
+    return std::chrono::duration<double>(d).count();
+}
+
+double percentile(std::vector<float>& values, double p) {
+    if (values.empty()) return 0.0;
+    std::size_t k = std::min(values.size() - 1, static_cast<std::size_t>(p * values.size()));
+    std::nth_element(values.begin(), values.begin() + k, values.end());
+    return values[k];
+}
+} // namespace
+
+// ------------------------------
+// Konstruktor i konfiguracja
+// ------------------------------
+FramePacer::FramePacer(unsigned int fps, bool adaptToCost, std::size_t window)
+    : baseFps(fps), adaptive(adaptToCost), windowSize(std::max<std::size_t>(window, 1))
+{
+    ::timeBeginPeriod(1); // sleep z dokładnością ~1 ms zamiast ~15 ms
+    frameTimes.reserve(windowSize);
+    workTimes.reserve(windowSize);
+    frameStart = Clock::now();
+    deadline = frameStart + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(period()));
+}
+
+FramePacer::~FramePacer() {
+    ::timeEndPeriod(1);
+}
+
+void FramePacer::setTargetFps(unsigned int fps) {
+    baseFps = fps;
+    divisor = 1;
+    deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(period()));
+}
+
+// ------------------------------
+// Oczekiwanie na termin klatki
+// ------------------------------
+void FramePacer::endFrame() {
+    Clock::time_point now = Clock::now();
+    double work = seconds(now - frameStart);
+    double target = period();
+
+    if (target > 0.0) {
+        if (now > deadline) {
+            // Spóźniona klatka — nowy termin liczony od teraz, bez nadrabiania
+            ++missed;
+            deadline = now;
+        }
+        else {
+            double remaining = seconds(deadline - now);
+            if (remaining > spinMargin) {
+                auto sleepFor = std::chrono::duration<double>(remaining - spinMargin);
+                Clock::time_point wake = now + std::chrono::duration_cast<Clock::duration>(sleepFor);
+                std::this_thread::sleep_for(sleepFor);
+
+                // Margines dopasowany do tego, o ile sleep się spóźnia
+                double oversleep = seconds(Clock::now() - wake);
+                spinMargin = std::clamp(0.9 * spinMargin + 0.1 * (oversleep * 1.5 + MinSpinMargin),
+                    MinSpinMargin, MaxSpinMargin);
+            }
+            while (Clock::now() < deadline)
+                std::this_thread::yield();
+        }
+    }
+
+    Clock::time_point end = Clock::now();
+    float frameMs = static_cast<float>(seconds(end - frameStart) * 1000.0);
+    float workMs = static_cast<float>(work * 1000.0);
+    if (frameTimes.size() < windowSize) {
+        frameTimes.push_back(frameMs);
+        workTimes.push_back(workMs);
+    }
+    else {
+        frameTimes[cursor] = frameMs;
+        workTimes[cursor] = workMs;
+        cursor = (cursor + 1) % windowSize;
+    }
+    ++frames;
+
+    workAverage = frames == 1 ? work : 0.95 * workAverage + 0.05 * work;
+    if (adaptive) adapt();
+
+    frameStart = end;
+    deadline += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(period()));
+}
+
+void FramePacer::adapt() {
+    if (baseFps == 0 || frames - lastAdaptFrame < AdaptInterval) return;
+    double budget = period();
+    unsigned int previous = divisor;
+    if (workAverage > 0.9 * budget && divisor < MaxDivisor)
+        divisor *= 2;
+    else if (divisor > 1 && workAverage < 0.6 * budget / 2.0)
+        divisor /= 2;
+    if (divisor != previous)
+        lastAdaptFrame = frames;
+}
+
+// ------------------------------
+// Statystyki
+// ------------------------------
+FrameStats FramePacer::getStats() const {
+    FrameStats stats;
+    std::vector<float> sorted = frameTimes;
+    stats.p50Ms = percentile(sorted, 0.50);
+    stats.p95Ms = percentile(sorted, 0.95);
+    stats.p99Ms = percentile(sorted, 0.99);
+    stats.maxMs = sorted.empty() ? 0.0 : *std::max_element(sorted.begin(), sorted.end());
+    double workSum = 0.0;
+    for (float w : workTimes) workSum += w;
+    stats.meanWorkMs = workTimes.empty() ? 0.0 : workSum / workTimes.size();
+    stats.frames = frames;
+    stats.missedFrames = missed;
+    stats.effectiveFps = baseFps / divisor;
+    return stats;
+}
+
+void FramePacer::resetStats() {
+    frameTimes.clear();
+    workTimes.clear();
+    cursor = 0;
+    frames = 0;
+    missed = 0;
+    lastAdaptFrame = 0;
+}
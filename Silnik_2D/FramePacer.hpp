@@ -0,0 +1,113 @@
+﻿#pragma once
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct FrameStats
+ * @brief Statystyki czasu klatek zebrane przez FramePacer.
+ *
+ * Percentyle liczone są z ostatnich klatek (okno przesuwne),
+ * liczniki obejmują cały czas działania.
+ */
+struct FrameStats {
+    double p50Ms = 0.0;             ///< Mediana czasu klatki.
+    double p95Ms = 0.0;             ///< 95. percentyl.
+    double p99Ms = 0.0;             ///< 99. percentyl.
+    double maxMs = 0.0;             ///< Najdłuższa klatka w oknie.
+    double meanWorkMs = 0.0;        ///< Średni czas pracy (bez oczekiwania) w oknie.
+    std::uint64_t frames = 0;       ///< Liczba klatek.
+    std::uint64_t missedFrames = 0; ///< Klatki, które nie zmieściły się w terminie.
+    unsigned int effectiveFps = 0;  ///< Bieżąca docelowa liczba klatek (po adaptacji).
+};
+
+/**
+ * @class FramePacer
+ * @brief Precyzyjne odmierzanie klatek: uśpienie + krótkie aktywne oczekiwanie.
+ *
+ * Wątek śpi do chwili tuż przed terminem klatki, a resztę odczekuje
+ * aktywnie, dzięki czemu nie zależy od ziarnistości zegara systemowego.
+ * Margines aktywnego oczekiwania dostosowuje się do zmierzonego
+ * "przespania" funkcji sleep. W trybie adaptacyjnym, gdy praca klatki
+ * regularnie przekracza budżet, docelowe tempo spada do 1/2, 1/4 fps
+ * (i wraca, gdy koszt renderowania maleje) zamiast gubić co drugą klatkę.
+ */
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    unsigned int baseFps = 60;          ///< Docelowe fps z konfiguracji (0 = bez limitu).
+    unsigned int divisor = 1;           ///< Dzielnik tempa w trybie adaptacyjnym.
+    bool adaptive = false;              ///< Czy dostosowywać tempo do kosztu klatki.
+    Clock::time_point frameStart;       ///< Początek bieżącej klatki.
+    Clock::time_point deadline;         ///< Termin zakończenia bieżącej klatki.
+    double spinMargin = 0.002;          ///< Czas aktywnego oczekiwania przed terminem [s].
+    double workAverage = 0.0;           ///< Średnia krocząca czasu pracy [s].
+    std::uint64_t lastAdaptFrame = 0;   ///< Klatka ostatniej zmiany tempa.
+
+    std::size_t windowSize = 1;         ///< Długość okna statystyk (co najmniej 1).
+    std::vector<float> frameTimes;      ///< Okno czasów klatek [ms].
+    std::vector<float> workTimes;       ///< Okno czasów pracy [ms].
+    std::size_t cursor = 0;             ///< Pozycja zapisu w oknie.
+    std::uint64_t frames = 0;           ///< Liczba klatek.
+    std::uint64_t missed = 0;           ///< Liczba spóźnionych klatek.
+
+    /**
+     * @brief Okres klatki dla bieżącego tempa.
+     * @return Okres w sekundach (0 = bez limitu).
+     */
+    double period() const { return baseFps ? double(divisor) / baseFps : 0.0; }
+
+    /**
+     * @brief Dostosowuje dzielnik tempa do średniego czasu pracy.
+     */
+    void adapt();
+
+public:
+    /**
+     * @brief Konstruktor.
+     * @param fps Docelowa liczba klatek na sekundę (0 = bez limitu).
+     * @param adaptToCost Czy dostosowywać tempo do kosztu renderowania.
+     * @param window Liczba ostatnich klatek branych do percentyli.
+     */
+    explicit FramePacer(unsigned int fps = 60, bool adaptToCost = false, std::size_t window = 1024);
+
+    /**
+     * @brief Destruktor — przywraca domyślną rozdzielczość zegara systemowego.
+     */
+    ~FramePacer();
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    /**
+     * @brief Zmienia docelowe tempo (0 = bez limitu).
+     * @param fps Liczba klatek na sekundę.
+     */
+    void setTargetFps(unsigned int fps);
+
+    /**
+     * @brief Włącza lub wyłącza adaptację tempa do kosztu klatki.
+     * @param enabled Czy adaptować.
+     */
+    void setAdaptive(bool enabled) { adaptive = enabled; if (!enabled) divisor = 1; }
+
+    /**
+     * @brief Kończy klatkę: czeka do terminu i zapisuje statystyki.
+     *
+     * Wywoływane raz na klatkę, po wyświetleniu obrazu.
+     */
+    void endFrame();
+
+    /**
+     * @brief Zwraca statystyki czasu klatek.
+     * @return Percentyle, liczniki i bieżące tempo.
+     */
+    FrameStats getStats() const;
+
+    /**
+     * @brief Zeruje statystyki.
+     */
+    void resetStats();
+};
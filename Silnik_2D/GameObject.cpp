@@ -1,4 +1,5 @@
 ﻿#include "GameObject.hpp"
+#include <algorithm>
 
 // ------------------------------
 // ShapeObject
@@ -169,6 +170,61 @@ void Okreg::scale(float kx, float ky, const sf::Vector2f& pivot) {
     radius *= (kx + ky) / 2.f;
 }
 
+// ------------------------------
+// SceneObject — obiekty w grafie sceny
+// ------------------------------
+
+SceneObject::SceneObject(SceneGraph& graph, SceneNodeId parent)
+    : scene(graph), node(graph.create(parent)) {
+}
+
+SceneObject::~SceneObject() {
+    scene.destroy(node);
+}
+
+// Przepięcie pod innego rodzica
+void SceneObject::attachTo(const SceneObject* parent) {
+    scene.setParent(node, parent ? parent->node : InvalidNode);
+}
+
+// Przesunięcie węzła (dzieci podążają za nim)
+void SceneObject::translate(float tx, float ty) {
+    scene.move(node, { tx, ty });
+}
+
+// Obrót węzła wokół punktu w układzie rodzica
+void SceneObject::rotate(float angleDeg, const sf::Vector2f& center) {
+    scene.rotateAround(node, angleDeg, center);
+}
+
+// Skalowanie węzła względem punktu w układzie rodzica
+void SceneObject::scale(float kx, float ky, const sf::Vector2f& center) {
+    scene.scaleAround(node, { kx, ky }, center);
+}
+
+SceneSprite::SceneSprite(SceneGraph& graph, std::shared_ptr<const sf::Texture> tex, SceneNodeId parent)
+    : SceneObject(graph, parent), texture(std::move(tex)), sprite(*texture)
+{
+    sprite.setOrigin(sf::Vector2f{ texture->getSize().x / 2.f, texture->getSize().y / 2.f });
+}
+
+// Rysowanie sprite'a z macierzą świata
+void SceneSprite::draw(PrimitiveRenderer& renderer) {
+    renderer.drawSprite(sprite, sf::RenderStates(scene.getWorld(node)), texture);
+}
+
+SceneCircle::SceneCircle(SceneGraph& graph, float r, sf::Color col, SceneNodeId parent)
+    : SceneObject(graph, parent), radius(r), color(col) {
+}
+
+// Rysowanie koła w położeniu ze świata
+void SceneCircle::draw(PrimitiveRenderer& renderer) {
+    const sf::Transform& world = scene.getWorld(node);
+    const float* m = world.getMatrix();
+    float worldScale = std::sqrt(std::abs(m[0] * m[5] - m[1] * m[4]));
+    renderer.drawCircle(world.transformPoint({ 0.f, 0.f }), radius * worldScale, color, color);
+}
+
 // ------------------------------
 // BitmapObject — obsługa bitmap
 // ------------------------------
@@ -179,16 +235,49 @@ BitmapObject::BitmapObject(const std::vector<BitmapHandler>& bmps)
     if (bitmaps.empty() || !bitmaps[0].getTexture())
         throw std::runtime_error("BitmapObject: No valid bitmap loaded");
 
-    auto texPtr = bitmaps[0].getTexture();
-    sprite = std::make_unique<sf::Sprite>(*texPtr);
+    texture = bitmaps[0].getTexture();
+    sprite = std::make_unique<sf::Sprite>(*texture);
+    mips = bitmaps[0].getMips();
 
     // Ustawienie środka sprite'a na środek bitmapy
-    sprite->setOrigin(sf::Vector2f{ texPtr->getSize().x / 2.f, texPtr->getSize().y / 2.f });
+    sprite->setOrigin(sf::Vector2f{ texture->getSize().x / 2.f, texture->getSize().y / 2.f });
+}
+
+BitmapObject::BitmapObject(const sf::Texture& texture)
+    : sprite(std::make_unique<sf::Sprite>(texture))
+{
+    sprite->setOrigin(sf::Vector2f{ texture.getSize().x / 2.f, texture.getSize().y / 2.f });
 }
 
-// Rysowanie bitmapy
+// Rysowanie bitmapy (z wyborem poziomu mipmapy przy pomniejszeniu)
 void BitmapObject::draw(PrimitiveRenderer& renderer) {
-    if (sprite) renderer.getCanvas().draw(*sprite);
+    if (!sprite) return;
+    if (!mips || mips->getLevelCount() < 2) {
+        renderer.drawSprite(*sprite, sf::RenderStates::Default, texture);
+        return;
+    }
+
+    // Skala na ekranie: długości obrazów osi sprite'a razy powiększenie widoku
+    const float* m = sprite->getTransform().getMatrix();
+    float scale = std::max(std::hypot(m[0], m[1]), std::hypot(m[4], m[5]));
+    sf::Vector2f view = renderer.getTargetView().getSize();
+    if (view.x > 0.f) scale *= renderer.getTargetSize().x / view.x;
+
+    std::size_t level = mips->selectLevel(scale);
+    if (level == 0) {
+        renderer.drawSprite(*sprite, sf::RenderStates::Default, texture);
+        return;
+    }
+
+    // Mniejsza tekstura rozciągnięta do współrzędnych lokalnych oryginału
+    const sf::Texture& levelTexture = mips->getLevel(level);
+    sf::Vector2f base(mips->getLevel(0).getSize()), reduced(levelTexture.getSize());
+    sf::Sprite levelSprite(levelTexture);
+    levelSprite.setColor(sprite->getColor());
+    sf::Transform transform = sprite->getTransform();
+    transform.scale(sf::Vector2f{ base.x / reduced.x, base.y / reduced.y });
+    // Poziom żyje tak długo jak piramida — uchwyt współdzieli jej licznik
+    renderer.drawSprite(levelSprite, transform, std::shared_ptr<const sf::Texture>(mips, &levelTexture));
 }
 
 // Przesunięcie bitmapy
@@ -215,20 +304,23 @@ void BitmapObject::scale(float kx, float ky, const sf::Vector2f& center) {
 // SpriteObject — animowana bitmapa
 // ------------------------------
 
-SpriteObject::SpriteObject(const std::vector<BitmapHandler>& bmps, int frameCnt)
-    : BitmapObject(bmps), frameCount(frameCnt)
+SpriteObject::SpriteObject(AnimationSystem& system, ClipId clip, float speed)
+    : BitmapObject(*system.getClipFrame(clip, 0).texture), animations(system), animation(system.play(clip, speed))
 {
-    if (frameCount > bitmaps.size()) frameCount = bitmaps.size();
+    const sf::IntRect& rect = system.getClipFrame(clip, 0).rect;
+    sprite->setTextureRect(rect);
+    sprite->setOrigin(sf::Vector2f(rect.size) / 2.f);
 }
 
-// Aktualizacja animacji
-void SpriteObject::animate(float dt) {
-    animTimer += dt;
-    if (animTimer >= frameTime) {
-        animTimer = 0.f;
-        frame = (frame + 1) % frameCount;
-        sprite->setTexture(*bitmaps[frame].getTexture());
-    }
+SpriteObject::~SpriteObject() {
+    animations.release(animation);
+}
+
+// Ustawienie bieżącej klatki (czas animacji przesuwa AnimationSystem)
+void SpriteObject::animate(float) {
+    const AnimationFrame& f = animations.getFrame(animation);
+    sprite->setTexture(*f.texture);
+    sprite->setTextureRect(f.rect);
 }
 
 // Aktualizacja (wywołuje animację)
@@ -240,43 +332,30 @@ void SpriteObject::update(float dt) {
 // Player — gracz sterowany klawiaturą
 // ------------------------------
 
-Player::Player(const std::vector<std::vector<BitmapHandler>>& bmps)
-    : SpriteObject(bmps[DOWN], bmps[DOWN].size()), directionalBitmaps(bmps)
+Player::Player(AnimationSystem& system, const std::array<ClipId, 4>& clips, const InputState& input)
+    : SpriteObject(system, clips[DOWN]), walkClips(clips), input(input)
 {
-    auto texPtr = directionalBitmaps[DOWN][0].getTexture();
-    if (!texPtr)
-        throw std::runtime_error("Player: no valid texture for DOWN direction");
-
-    sprite->setOrigin(sf::Vector2f{ texPtr->getSize().x / 2.f, texPtr->getSize().y / 2.f });
 }
 
-// Obsługa ruchu gracza z klawiatury
+// Obsługa ruchu gracza (akcje z migawki wejścia — bez odpytywania systemu)
 void Player::handleKeyboard(float dt) {
     sf::Vector2f movement(0.f, 0.f);
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W)) { movement.y -= speed * dt; dir = UP; }
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S)) { movement.y += speed * dt; dir = DOWN; }
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A)) { movement.x -= speed * dt; dir = LEFT; }
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D)) { movement.x += speed * dt; dir = RIGHT; }
+    moving = false;
+    if (input.isDown(InputAction::MoveUp))    { movement.y -= speed * dt; dir = UP; moving = true; }
+    if (input.isDown(InputAction::MoveDown))  { movement.y += speed * dt; dir = DOWN; moving = true; }
+    if (input.isDown(InputAction::MoveLeft))  { movement.x -= speed * dt; dir = LEFT; moving = true; }
+    if (input.isDown(InputAction::MoveRight)) { movement.x += speed * dt; dir = RIGHT; moving = true; }
 
     sprite->move(movement);
 }
 
-// Animacja gracza (zależna od kierunku i ruchu)
+// Animacja gracza (klip zależny od kierunku, pierwsza klatka w bezruchu)
 void Player::animate(float dt) {
-    animTimer += dt;
-
-    bool moving = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W) ||
-        sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S) ||
-        sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A) ||
-        sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D);
-
-    if (!moving) frame = 0; // Brak ruchu, pierwsza klatka
-    else if (animTimer >= frameTime) {
-        animTimer = 0.f;
-        frame = (frame + 1) % directionalBitmaps[dir].size();
-    }
+    animations.setClip(animation, walkClips[dir]);
+    animations.setSpeed(animation, moving ? 1.f : 0.f);
+    if (!moving) animations.rewind(animation);
 
-    sprite->setTexture(*directionalBitmaps[dir][frame].getTexture());
+    SpriteObject::animate(dt);
 }
 
 // Aktualizacja stanu gracza
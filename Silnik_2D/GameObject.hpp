@@ -4,6 +4,10 @@
 #include <cmath>
 #include "PrimitiveRenderer.hpp"
 #include "BitmapHandler.hpp"
+#include "Animation.hpp"
+#include "SceneGraph.hpp"
+#include "Input.hpp"
+#include <array>
 #include <memory>
 
 // ---------------------------------------------------------
@@ -234,6 +238,107 @@ public:
     void scale(float kx, float ky, const sf::Vector2f& pivot) override;
 };
 
+// ---------------------------------------------------------
+// Obiekty w grafie sceny
+// ---------------------------------------------------------
+
+/**
+ * @class SceneObject
+ * @brief Obiekt, którego przekształcenie jest węzłem SceneGraph.
+ *
+ * Obiekt rysowany jest w swoim układzie lokalnym z macierzą świata węzła,
+ * więc przesunięcie rodzica przesuwa wszystkie dzieci bez wywoływania
+ * ich translate(). Współrzędne jak w SFML (oś Y w dół).
+ *
+ * Tworzony przez Engine::spawn<T>(engine.getScene(), ...) — aktualizowany
+ * i rysowany jak pozostałe obiekty. Domyślnie nie ma własnej logiki.
+ */
+class SceneObject : public UpdatableObject, public DrawableObject, public TransformableObject {
+protected:
+    SceneGraph& scene; ///< Graf sceny.
+    SceneNodeId node;  ///< Węzeł obiektu.
+
+public:
+    /**
+     * @brief Konstruktor — tworzy węzeł w grafie.
+     * @param graph Graf sceny.
+     * @param parent Węzeł rodzica (InvalidNode — korzeń).
+     */
+    SceneObject(SceneGraph& graph, SceneNodeId parent = InvalidNode);
+
+    /**
+     * @brief Destruktor — usuwa węzeł (dzieci stają się korzeniami).
+     */
+    ~SceneObject() override;
+
+    SceneObject(const SceneObject&) = delete;
+    SceneObject& operator=(const SceneObject&) = delete;
+
+    /**
+     * @brief Podpina obiekt pod innego rodzica.
+     * @param parent Rodzic lub nullptr (korzeń).
+     */
+    void attachTo(const SceneObject* parent);
+
+    /**
+     * @brief Zwraca węzeł obiektu.
+     * @return Identyfikator węzła.
+     */
+    SceneNodeId getNode() const { return node; }
+
+    void update(float) override {}
+    void translate(float tx, float ty) override;
+    void rotate(float angleDeg, const sf::Vector2f& center = { 0.f, 0.f }) override;
+    void scale(float kx, float ky, const sf::Vector2f& center = { 0.f, 0.f }) override;
+};
+
+/**
+ * @class SceneSprite
+ * @brief Bitmapa rysowana z macierzą świata węzła.
+ */
+class SceneSprite : public SceneObject {
+private:
+    std::shared_ptr<const sf::Texture> texture; ///< Tekstura sprite'a.
+    sf::Sprite sprite; ///< Sprite w układzie lokalnym (środek w początku układu).
+
+public:
+    /**
+     * @brief Konstruktor.
+     * @param graph Graf sceny.
+     * @param texture Tekstura (np. BitmapHandler::getTexture()).
+     * @param parent Węzeł rodzica.
+     */
+    SceneSprite(SceneGraph& graph, std::shared_ptr<const sf::Texture> texture, SceneNodeId parent = InvalidNode);
+
+    void draw(PrimitiveRenderer& renderer) override;
+};
+
+/**
+ * @class SceneCircle
+ * @brief Koło o środku w początku układu lokalnego węzła.
+ */
+class SceneCircle : public SceneObject {
+private:
+    float radius;    ///< Promień w układzie lokalnym.
+    sf::Color color; ///< Kolor.
+
+public:
+    /**
+     * @brief Konstruktor.
+     * @param graph Graf sceny.
+     * @param r Promień.
+     * @param col Kolor.
+     * @param parent Węzeł rodzica.
+     */
+    SceneCircle(SceneGraph& graph, float r, sf::Color col = sf::Color::White, SceneNodeId parent = InvalidNode);
+
+    /**
+     * @brief Rysuje koło; promień skalowany średnią skalą macierzy świata.
+     * @param renderer Renderer.
+     */
+    void draw(PrimitiveRenderer& renderer) override;
+};
+
 // ---------------------------------------------------------
 // Bitmapy i obiekty animowane
 // ---------------------------------------------------------
@@ -241,11 +346,16 @@ public:
 /**
  * @class BitmapObject
  * @brief Obiekt rysowany na podstawie bitmap.
+ *
+ * Jeśli pierwsza bitmapa ma piramidę mipmap (BitmapHandler::buildMips),
+ * rysowanie wybiera poziom na podstawie skali sprite'a i widoku kanwy.
  */
 class BitmapObject : public DrawableObject, public TransformableObject {
 protected:
-    std::vector<BitmapHandler> bitmaps; ///< Lista bitmap.
-    std::unique_ptr<sf::Sprite> sprite; ///< Główny sprite.
+    std::vector<BitmapHandler> bitmaps;     ///< Lista bitmap.
+    std::unique_ptr<sf::Sprite> sprite;     ///< Główny sprite.
+    std::shared_ptr<const sf::Texture> texture; ///< Tekstura sprite'a (nullptr, gdy należy do wywołującego).
+    std::shared_ptr<const MipPyramid> mips; ///< Piramida pierwszej bitmapy (opcjonalna).
 
 public:
     /**
@@ -259,6 +369,16 @@ public:
      */
     BitmapObject(const std::vector<BitmapHandler>& bmps);
 
+    /**
+     * @brief Konstruktor z pojedynczą teksturą (bez kopiowania listy bitmap).
+     *
+     * Tekstura musi żyć dłużej niż obiekt i renderowanie jego ostatniej klatki
+     * (np. tekstury klipów AnimationSystem).
+     *
+     * @param texture Tekstura początkowa.
+     */
+    explicit BitmapObject(const sf::Texture& texture);
+
     void draw(PrimitiveRenderer& renderer) override;
     void translate(float tx, float ty) override;
     void rotate(float angleDeg, const sf::Vector2f& center = { 0,0 }) override;
@@ -267,23 +387,38 @@ public:
 
 /**
  * @class SpriteObject
- * @brief Obiekt animowany z wieloma klatkami bitmap.
+ * @brief Obiekt animowany klipem ze wspólnego AnimationSystem.
+ *
+ * Sprite nie przechowuje własnych klatek ani zegara — jego stan animacji
+ * (klip, czas, tempo) leży w AnimationSystem i jest przesuwany w czasie
+ * zbiorczo przez AnimationSystem::advance().
  */
 class SpriteObject : public BitmapObject, public AnimatedObject {
 protected:
-    float frameTime = 0.12f; ///< Czas jednej klatki animacji.
-    float animTimer = 0.f;   ///< Zegar animacji.
-    int frame = 0;           ///< Aktualna klatka.
-    int frameCount = 1;      ///< Liczba klatek.
+    AnimationSystem& animations;  ///< Wspólny system animacji.
+    AnimationHandle animation;    ///< Stan animacji tego obiektu.
 
 public:
     /**
      * @brief Konstruktor sprite'a.
-     * @param bmps Wektor bitmap.
-     * @param frameCnt Ilość klatek animacji.
+     * @param system System animacji.
+     * @param clip Odtwarzany klip.
+     * @param speed Mnożnik tempa animacji.
+     */
+    SpriteObject(AnimationSystem& system, ClipId clip, float speed = 1.f);
+
+    /**
+     * @brief Destruktor — zwalnia stan animacji.
      */
-    SpriteObject(const std::vector<BitmapHandler>& bmps, int frameCnt = 1);
+    ~SpriteObject() override;
 
+    SpriteObject(const SpriteObject&) = delete;
+    SpriteObject& operator=(const SpriteObject&) = delete;
+
+    /**
+     * @brief Ustawia na sprite'cie bieżącą klatkę klipu.
+     * @param dt Nieużywany — czas przesuwa AnimationSystem::advance().
+     */
     void animate(float dt) override;
     void update(float dt) override;
 };
@@ -301,17 +436,21 @@ private:
      */
     enum Direction { DOWN, UP, LEFT, RIGHT } dir = DOWN;
 
-    std::vector<std::vector<BitmapHandler>> directionalBitmaps; ///< Bitmapy dla każdego kierunku i klatki.
+    std::array<ClipId, 4> walkClips; ///< Klipy chodu dla każdego kierunku.
+    bool moving = false;             ///< Czy gracz porusza się w bieżącej klatce.
+    const InputState& input;         ///< Migawka wejścia klatki (akcje Move*).
 
 public:
     /**
      * @brief Konstruktor gracza.
-     * @param bmps Bitmapy dla wszystkich kierunków animacji.
+     * @param system System animacji.
+     * @param clips Klipy chodu w kolejności: dół, góra, lewo, prawo.
+     * @param input Migawka wejścia (musi żyć dłużej niż gracz).
      */
-    Player(const std::vector<std::vector<BitmapHandler>>& bmps);
+    Player(AnimationSystem& system, const std::array<ClipId, 4>& clips, const InputState& input);
 
     /**
-     * @brief Obsługuje klawiaturę i ruch gracza.
+     * @brief Obsługuje ruch gracza (akcje z migawki wejścia).
      * @param dt Czas od ostatniej klatki.
      */
     void handleKeyboard(float dt);
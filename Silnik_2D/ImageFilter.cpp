@@ -0,0 +1,348 @@
+﻿#include "ImageFilter.hpp"
+#include "BitmapHandler.hpp"
+#include "PixelKernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <type_traits>
+#include <emmintrin.h>
+
+namespace {
+constexpr int MaxRadius = 64;          ///< Największy promień jąder separowalnych.
+constexpr unsigned int MinBandRows = 16; ///< Najmniejsza liczba wierszy w pasie wątku.
+
+unsigned int bandCount(unsigned int threads, unsigned int height) {
+    return std::max(1u, std::min(threads, height / MinBandRows));
+}
+
+unsigned int bandBegin(unsigned int height, unsigned int band, unsigned int bands) {
+    return static_cast<unsigned int>(static_cast<std::uint64_t>(height) * band / bands);
+}
+
+int clampIndex(int i, int size) {
+    return i < 0 ? 0 : (i >= size ? size - 1 : i);
+}
+} // namespace
+
+// ------------------------------
+// Konstruktor
+// ------------------------------
+FilterPipeline::FilterPipeline(unsigned int threadCount)
+    : threads(threadCount ? threadCount : std::max(1u, std::thread::hardware_concurrency())) {
+    helpers.reserve(threads - 1);
+    for (unsigned int i = 1; i < threads; ++i)
+        helpers.emplace_back(&FilterPipeline::helperLoop, this, i);
+}
+
+FilterPipeline::~FilterPipeline() {
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        stopping = true;
+    }
+    taskReady.notify_all();
+    for (auto& helper : helpers)
+        helper.join();
+}
+
+// ------------------------------
+// Wątki pomocnicze
+// ------------------------------
+void FilterPipeline::helperLoop(unsigned int band) {
+    std::uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(poolMutex);
+    while (true) {
+        taskReady.wait(lock, [&] { return stopping || generation != seen; });
+        if (stopping) break;
+        seen = generation;
+        if (band >= taskBands) continue; // obraz za niski na ten pas
+
+        const unsigned int y0 = bandBegin(taskHeight, band, taskBands);
+        const unsigned int y1 = bandBegin(taskHeight, band + 1, taskBands);
+        lock.unlock();
+        taskCall(taskFn, y0, y1, band);
+        lock.lock();
+        if (--remaining == 0)
+            taskDone.notify_one();
+    }
+}
+
+void FilterPipeline::runBands(unsigned int height, BandCall call, void* fn) {
+    const unsigned int bands = bandCount(threads, height);
+    if (bands == 1) {
+        call(fn, 0u, height, 0u);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        taskCall = call;
+        taskFn = fn;
+        taskHeight = height;
+        taskBands = bands;
+        remaining = bands - 1;
+        ++generation;
+    }
+    taskReady.notify_all();
+    call(fn, 0u, bandBegin(height, 1, bands), 0u);
+
+    std::unique_lock<std::mutex> lock(poolMutex);
+    taskDone.wait(lock, [this] { return remaining == 0; });
+}
+
+// Pas 0 przetwarza wątek wywołujący, pozostałe — stałe wątki pomocnicze
+template <typename Fn>
+void FilterPipeline::parallelRows(unsigned int height, Fn&& fn) {
+    using Body = std::remove_reference_t<Fn>;
+    runBands(height, [](void* body, unsigned int y0, unsigned int y1, unsigned int band) {
+        (*static_cast<Body*>(body))(y0, y1, band);
+    }, &fn);
+}
+
+// ------------------------------
+// Budowa potoku
+// ------------------------------
+FilterPipeline& FilterPipeline::gaussianBlur(float sigma) {
+    if (sigma <= 0.f) return *this;
+    Stage stage{ StageType::Separable };
+    stage.radius = std::min(MaxRadius, static_cast<int>(std::ceil(3.f * sigma)));
+    float sum = 0.f;
+    for (int k = -stage.radius; k <= stage.radius; ++k) {
+        stage.weights.push_back(std::exp(-(k * k) / (2.f * sigma * sigma)));
+        sum += stage.weights.back();
+    }
+    for (float& w : stage.weights) w /= sum;
+    stages.push_back(std::move(stage));
+    return *this;
+}
+
+FilterPipeline& FilterPipeline::boxBlur(int radius) {
+    if (radius <= 0) return *this;
+    Stage stage{ StageType::Box };
+    stage.radius = radius;
+    stages.push_back(std::move(stage));
+    return *this;
+}
+
+FilterPipeline& FilterPipeline::convolve3x3(const std::array<float, 9>& kernel, float bias) {
+    stages.push_back({ StageType::Convolve, std::vector<float>(kernel.begin(), kernel.end()), 1, bias });
+    return *this;
+}
+
+FilterPipeline& FilterPipeline::convolve5x5(const std::array<float, 25>& kernel, float bias) {
+    stages.push_back({ StageType::Convolve, std::vector<float>(kernel.begin(), kernel.end()), 2, bias });
+    return *this;
+}
+
+FilterPipeline& FilterPipeline::colorMatrix(const std::array<float, 20>& matrix) {
+    stages.push_back({ StageType::ColorMatrix, std::vector<float>(matrix.begin(), matrix.end()) });
+    return *this;
+}
+
+FilterPipeline& FilterPipeline::threshold(float level) {
+    stages.push_back({ StageType::Threshold, {}, 0, level });
+    return *this;
+}
+
+FilterPipeline& FilterPipeline::premultiplyAlpha() {
+    stages.push_back({ StageType::Premultiply });
+    return *this;
+}
+
+// ------------------------------
+// Wykonanie
+// ------------------------------
+void FilterPipeline::apply(BitmapHandler& bitmap) {
+    apply(bitmap.editPixels());
+}
+
+void FilterPipeline::apply(sf::Image& image) {
+    const sf::Vector2u size = image.getSize();
+    const std::size_t pixels = static_cast<std::size_t>(size.x) * size.y;
+    if (stages.empty() || pixels == 0) return;
+
+    front.resize(pixels * 4);
+    back.resize(pixels * 4);
+    bytes.resize(pixels * 4);
+
+    const std::uint8_t* src = image.getPixelsPtr();
+    const std::size_t stride = static_cast<std::size_t>(size.x) * 4;
+    parallelRows(size.y, [&](unsigned int y0, unsigned int y1, unsigned int) {
+        PixelKernels::bytesToFloats(src + y0 * stride, front.data() + y0 * stride, static_cast<std::size_t>(y1 - y0) * size.x);
+    });
+
+    for (const Stage& stage : stages) {
+        switch (stage.type) {
+        case StageType::Separable:   runSeparable(stage, size.x, size.y); break;
+        case StageType::Box:         runBox(stage, size.x, size.y); break;
+        case StageType::Convolve:    runConvolve(stage, size.x, size.y); break;
+        default:                     runPointOp(stage, size.x, size.y); break;
+        }
+    }
+
+    parallelRows(size.y, [&](unsigned int y0, unsigned int y1, unsigned int) {
+        PixelKernels::floatsToBytes(front.data() + y0 * stride, bytes.data() + y0 * stride, static_cast<std::size_t>(y1 - y0) * size.x);
+    });
+    image.resize(size, bytes.data());
+}
+
+// Rozmycie separowalne: poziomo front -> back, pionowo back -> front
+void FilterPipeline::runSeparable(const Stage& stage, unsigned int width, unsigned int height) {
+    const int r = stage.radius, taps = 2 * r + 1, w = static_cast<int>(width);
+    const float* weights = stage.weights.data();
+    const std::size_t stride = static_cast<std::size_t>(width) * 4;
+
+    parallelRows(height, [&](unsigned int y0, unsigned int y1, unsigned int) {
+        for (unsigned int y = y0; y < y1; ++y) {
+            const float* s = front.data() + y * stride;
+            float* d = back.data() + y * stride;
+            for (int x = 0; x < w; ++x) {
+                __m128 acc = _mm_setzero_ps();
+                if (x >= r && x + r < w) {
+                    const float* p = s + (x - r) * 4;
+                    for (int k = 0; k < taps; ++k)
+                        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(p + k * 4)));
+                }
+                else {
+                    for (int k = 0; k < taps; ++k)
+                        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(weights[k]),
+                            _mm_loadu_ps(s + clampIndex(x + k - r, w) * 4)));
+                }
+                _mm_storeu_ps(d + x * 4, acc);
+            }
+        }
+    });
+
+    parallelRows(height, [&](unsigned int y0, unsigned int y1, unsigned int) {
+        const float* rows[2 * MaxRadius + 1];
+        for (unsigned int y = y0; y < y1; ++y) {
+            for (int k = 0; k < taps; ++k)
+                rows[k] = back.data() + clampIndex(static_cast<int>(y) + k - r, static_cast<int>(height)) * stride;
+            PixelKernels::weightedRows(rows, weights, taps, front.data() + y * stride, stride);
+        }
+    });
+}
+
+// Rozmycie pudełkowe sumami bieżącymi: poziomo front -> back, pionowo back -> front
+void FilterPipeline::runBox(const Stage& stage, unsigned int width, unsigned int height) {
+    const int r = stage.radius, w = static_cast<int>(width), h = static_cast<int>(height);
+    const float inv = 1.f / (2 * r + 1);
+    const std::size_t stride = static_cast<std::size_t>(width) * 4;
+    scratch.resize(stride * bandCount(threads, height));
+
+    parallelRows(height, [&](unsigned int y0, unsigned int y1, unsigned int) {
+        const __m128 scale = _mm_set1_ps(inv);
+        for (unsigned int y = y0; y < y1; ++y) {
+            const float* s = front.data() + y * stride;
+            float* d = back.data() + y * stride;
+            __m128 sum = _mm_setzero_ps();
+            for (int k = -r; k <= r; ++k)
+                sum = _mm_add_ps(sum, _mm_loadu_ps(s + clampIndex(k, w) * 4));
+            _mm_storeu_ps(d, _mm_mul_ps(sum, scale));
+            for (int x = 1; x < w; ++x) {
+                sum = _mm_add_ps(sum, _mm_sub_ps(_mm_loadu_ps(s + clampIndex(x + r, w) * 4),
+                    _mm_loadu_ps(s + clampIndex(x - r - 1, w) * 4)));
+                _mm_storeu_ps(d + x * 4, _mm_mul_ps(sum, scale));
+            }
+        }
+    });
+
+    parallelRows(height, [&](unsigned int y0, unsigned int y1, unsigned int band) {
+        float* acc = scratch.data() + band * stride;
+        std::fill(acc, acc + stride, 0.f);
+        for (int k = -r; k <= r; ++k) {
+            const float* row = back.data() + clampIndex(static_cast<int>(y0) + k, h) * stride;
+            for (std::size_t i = 0; i < stride; ++i) acc[i] += row[i];
+        }
+        float* d = front.data() + y0 * stride;
+        for (std::size_t i = 0; i < stride; ++i) d[i] = acc[i] * inv;
+
+        for (unsigned int y = y0 + 1; y < y1; ++y) {
+            const float* add = back.data() + clampIndex(static_cast<int>(y) + r, h) * stride;
+            const float* sub = back.data() + clampIndex(static_cast<int>(y) - r - 1, h) * stride;
+            PixelKernels::runningRow(acc, add, sub, inv, front.data() + y * stride, stride);
+        }
+    });
+}
+
+// Splot 3x3 / 5x5 na RGB (alfa bez zmian): front -> back, zamiana buforów
+void FilterPipeline::runConvolve(const Stage& stage, unsigned int width, unsigned int height) {
+    const int r = stage.radius, size = 2 * r + 1, w = static_cast<int>(width), h = static_cast<int>(height);
+    const float* kernel = stage.weights.data();
+    const std::size_t stride = static_cast<std::size_t>(width) * 4;
+
+    parallelRows(height, [&](unsigned int y0, unsigned int y1, unsigned int) {
+        const __m128 bias = _mm_setr_ps(stage.value, stage.value, stage.value, 0.f);
+        const __m128 rgbMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+        for (unsigned int y = y0; y < y1; ++y) {
+            const float* rows[5];
+            for (int k = 0; k < size; ++k)
+                rows[k] = front.data() + clampIndex(static_cast<int>(y) + k - r, h) * stride;
+            float* d = back.data() + y * stride;
+
+            for (int x = 0; x < w; ++x) {
+                __m128 acc = bias;
+                for (int ky = 0; ky < size; ++ky)
+                    for (int kx = 0; kx < size; ++kx)
+                        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(kernel[ky * size + kx]),
+                            _mm_loadu_ps(rows[ky] + clampIndex(x + kx - r, w) * 4)));
+                __m128 source = _mm_loadu_ps(front.data() + y * stride + x * 4);
+                _mm_storeu_ps(d + x * 4, _mm_or_ps(_mm_and_ps(rgbMask, acc), _mm_andnot_ps(rgbMask, source)));
+            }
+        }
+    });
+    front.swap(back);
+}
+
+// Operacje punktowe w miejscu (macierz koloru, próg, mnożenie przez alfę)
+void FilterPipeline::runPointOp(const Stage& stage, unsigned int width, unsigned int height) {
+    const std::size_t stride = static_cast<std::size_t>(width) * 4;
+
+    parallelRows(height, [&](unsigned int y0, unsigned int y1, unsigned int) {
+        const __m128 rgbMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+        const __m128 one = _mm_set1_ps(1.f);
+        float* p = front.data() + y0 * stride;
+        float* end = front.data() + y1 * stride;
+
+        switch (stage.type) {
+        case StageType::ColorMatrix: {
+            const float* m = stage.weights.data();
+            const __m128 c0 = _mm_setr_ps(m[0], m[5], m[10], m[15]);
+            const __m128 c1 = _mm_setr_ps(m[1], m[6], m[11], m[16]);
+            const __m128 c2 = _mm_setr_ps(m[2], m[7], m[12], m[17]);
+            const __m128 c3 = _mm_setr_ps(m[3], m[8], m[13], m[18]);
+            const __m128 offset = _mm_setr_ps(m[4], m[9], m[14], m[19]);
+            for (; p < end; p += 4) {
+                __m128 v = _mm_loadu_ps(p);
+                __m128 out = _mm_add_ps(offset, _mm_mul_ps(c0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0))));
+                out = _mm_add_ps(out, _mm_mul_ps(c1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+                out = _mm_add_ps(out, _mm_mul_ps(c2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+                out = _mm_add_ps(out, _mm_mul_ps(c3, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+                _mm_storeu_ps(p, out);
+            }
+            break;
+        }
+        case StageType::Threshold: {
+            const __m128 luma = _mm_setr_ps(0.2126f, 0.7152f, 0.0722f, 0.f);
+            const __m128 level = _mm_set1_ps(stage.value);
+            for (; p < end; p += 4) {
+                __m128 v = _mm_loadu_ps(p);
+                __m128 t = _mm_mul_ps(v, luma);
+                t = _mm_add_ps(t, _mm_shuffle_ps(t, t, _MM_SHUFFLE(2, 3, 0, 1)));
+                t = _mm_add_ps(t, _mm_shuffle_ps(t, t, _MM_SHUFFLE(1, 0, 3, 2))); // luminancja w każdym kanale
+                __m128 bright = _mm_and_ps(_mm_cmpge_ps(t, level), one);
+                _mm_storeu_ps(p, _mm_or_ps(_mm_and_ps(rgbMask, bright), _mm_andnot_ps(rgbMask, v)));
+            }
+            break;
+        }
+        case StageType::Premultiply:
+            for (; p < end; p += 4) {
+                __m128 v = _mm_loadu_ps(p);
+                __m128 alpha = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+                __m128 factor = _mm_or_ps(_mm_and_ps(rgbMask, alpha), _mm_andnot_ps(rgbMask, one));
+                _mm_storeu_ps(p, _mm_mul_ps(v, factor));
+            }
+            break;
+        default:
+            break;
+        }
+    });
+}
@@ -0,0 +1,183 @@
+﻿#pragma once
+#include <SFML/Graphics.hpp>
+#include "PixelKernels.hpp"
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class BitmapHandler;
+
+/**
+ * @class FilterPipeline
+ * @brief Łańcuch filtrów obrazu wykonywany na buforze pikseli CPU.
+ *
+ * Obraz jest raz zamieniany na piksele float RGBA (0..1, jeden piksel =
+ * jeden rejestr SSE), przechodzi przez wszystkie etapy w dwóch buforach
+ * używanych naprzemiennie i raz wraca do bajtów. Bufory należą do potoku
+ * i są ponownie używane przy kolejnych apply() — przy stałym rozmiarze
+ * obrazu potok nie alokuje pamięci.
+ *
+ * Każdy etap dzieli obraz na pasy wierszy przetwarzane równolegle przez
+ * wątek wywołujący i stałe wątki pomocnicze potoku (uruchamiane raz
+ * w konstruktorze, uśpione między etapami).
+ * Jądra korzystają z SSE (zawsze dostępne na x64), a przebiegi pionowe
+ * z AVX, jeśli procesor je obsługuje. Krawędzie obrazu są powielane.
+ *
+ * Potok nie jest bezpieczny wątkowo — każdy wątek potrzebuje własnego.
+ */
+class FilterPipeline {
+private:
+    /**
+     * @brief Rodzaj etapu.
+     */
+    enum class StageType { Separable, Box, Convolve, ColorMatrix, Threshold, Premultiply };
+
+    /**
+     * @struct Stage
+     * @brief Parametry jednego etapu.
+     */
+    struct Stage {
+        StageType type;             ///< Rodzaj etapu.
+        std::vector<float> weights; ///< Wagi jądra (1D dla separowalnych, 2D dla splotu).
+        int radius = 0;             ///< Promień jądra.
+        float value = 0.f;          ///< Próg lub przesunięcie splotu.
+    };
+
+    std::vector<Stage> stages;          ///< Etapy w kolejności wykonania.
+    std::vector<float> front;           ///< Bieżące piksele (float RGBA).
+    std::vector<float> back;            ///< Bufor docelowy etapów nie działających w miejscu.
+    std::vector<float> scratch;         ///< Sumy bieżące rozmycia pudełkowego (wiersz na pas).
+    std::vector<std::uint8_t> bytes;    ///< Bufor wynikowy RGBA8.
+    unsigned int threads;               ///< Liczba wątków (pasów wierszy).
+
+    /// Wywołanie zadania pasa: body(y0, y1, pas).
+    using BandCall = void (*)(void* body, unsigned int y0, unsigned int y1, unsigned int band);
+
+    std::mutex poolMutex;               ///< Ochrona bieżącego zadania.
+    std::condition_variable taskReady;  ///< Sygnał nowego zadania (lub zakończenia).
+    std::condition_variable taskDone;   ///< Sygnał ukończenia pasów pomocniczych.
+    BandCall taskCall = nullptr;        ///< Bieżące zadanie.
+    void* taskFn = nullptr;             ///< Dane bieżącego zadania.
+    unsigned int taskHeight = 0;        ///< Wysokość obrazu bieżącego zadania.
+    unsigned int taskBands = 0;         ///< Liczba pasów bieżącego zadania.
+    unsigned int remaining = 0;         ///< Pasy pomocnicze w toku.
+    std::uint64_t generation = 0;       ///< Numer zadania (budzi wątki pomocnicze).
+    bool stopping = false;              ///< Flaga zakończenia wątków.
+    std::vector<std::thread> helpers;   ///< Wątki pomocnicze (pas i = wątek i; inicjalizowane jako ostatnie).
+
+    /**
+     * @brief Pętla wątku pomocniczego.
+     * @param band Numer pasu obsługiwanego przez wątek.
+     */
+    void helperLoop(unsigned int band);
+
+    /**
+     * @brief Rozdziela pasy wierszy między wątek wywołujący i pomocnicze, czeka na wszystkie.
+     * @param height Wysokość obrazu.
+     * @param call Wywołanie zadania.
+     * @param fn Dane zadania.
+     */
+    void runBands(unsigned int height, BandCall call, void* fn);
+
+    /**
+     * @brief Wykonuje fn(y0, y1, pas) równolegle dla pasów wierszy obrazu.
+     */
+    template <typename Fn>
+    void parallelRows(unsigned int height, Fn&& fn);
+
+    void runSeparable(const Stage& stage, unsigned int width, unsigned int height);
+    void runBox(const Stage& stage, unsigned int width, unsigned int height);
+    void runConvolve(const Stage& stage, unsigned int width, unsigned int height);
+    void runPointOp(const Stage& stage, unsigned int width, unsigned int height);
+
+public:
+    /**
+     * @brief Konstruktor.
+     * @param threadCount Liczba wątków (0 = liczba rdzeni; 1 = bez wątków pomocniczych).
+     */
+    explicit FilterPipeline(unsigned int threadCount = 0);
+
+    /**
+     * @brief Zatrzymuje wątki pomocnicze.
+     */
+    ~FilterPipeline();
+
+    FilterPipeline(const FilterPipeline&) = delete;
+    FilterPipeline& operator=(const FilterPipeline&) = delete;
+
+    /**
+     * @brief Rozmycie Gaussa (dwa przebiegi 1D).
+     * @param sigma Odchylenie standardowe w pikselach.
+     * @return Potok (łańcuch wywołań).
+     */
+    FilterPipeline& gaussianBlur(float sigma);
+
+    /**
+     * @brief Rozmycie pudełkowe (sumy bieżące — koszt niezależny od promienia).
+     * @param radius Promień w pikselach.
+     * @return Potok.
+     */
+    FilterPipeline& boxBlur(int radius);
+
+    /**
+     * @brief Splot z dowolnym jądrem 3x3.
+     * @param kernel Wagi wierszami.
+     * @param bias Wartość dodawana do wyniku (0..1).
+     * @return Potok.
+     */
+    FilterPipeline& convolve3x3(const std::array<float, 9>& kernel, float bias = 0.f);
+
+    /**
+     * @brief Splot z dowolnym jądrem 5x5.
+     * @param kernel Wagi wierszami.
+     * @param bias Wartość dodawana do wyniku (0..1).
+     * @return Potok.
+     */
+    FilterPipeline& convolve5x5(const std::array<float, 25>& kernel, float bias = 0.f);
+
+    /**
+     * @brief Macierz koloru 4x5 (wiersze R, G, B, A; ostatnia kolumna — przesunięcie 0..1).
+     * @param matrix Macierz wierszami.
+     * @return Potok.
+     */
+    FilterPipeline& colorMatrix(const std::array<float, 20>& matrix);
+
+    /**
+     * @brief Progowanie jasności: RGB = 1 gdy luminancja >= próg, w przeciwnym razie 0.
+     * @param level Próg (0..1).
+     * @return Potok.
+     */
+    FilterPipeline& threshold(float level);
+
+    /**
+     * @brief Mnoży RGB przez kanał alfa.
+     * @return Potok.
+     */
+    FilterPipeline& premultiplyAlpha();
+
+    /**
+     * @brief Usuwa wszystkie etapy.
+     */
+    void clear() { stages.clear(); }
+
+    /**
+     * @brief Wykonuje potok na obrazie.
+     * @param image Obraz (modyfikowany w miejscu).
+     */
+    void apply(sf::Image& image);
+
+    /**
+     * @brief Wykonuje potok na pikselach bitmapy (copy-on-write, tekstura wysyłana leniwie).
+     * @param bitmap Bitmapa.
+     */
+    void apply(BitmapHandler& bitmap);
+
+    /**
+     * @brief Sprawdza, czy procesor i system obsługują AVX.
+     * @return true jeśli przebiegi pionowe używają AVX.
+     */
+    static bool hasAvx() { return PixelKernels::hasAvx(); }
+};
@@ -0,0 +1,142 @@
+﻿#include "Input.hpp"
+#include <algorithm>
+
+// ------------------------------
+// InputMap — przypisania
+// ------------------------------
+InputMap::InputMap() {
+    keys.fill(None);
+    buttons.fill(None);
+}
+
+InputMap InputMap::defaults() {
+    using Key = sf::Keyboard::Key;
+    InputMap map;
+    map.bind(InputAction::MoveUp, Key::W);
+    map.bind(InputAction::MoveDown, Key::S);
+    map.bind(InputAction::MoveLeft, Key::A);
+    map.bind(InputAction::MoveRight, Key::D);
+    map.bind(InputAction::AddPoint, sf::Mouse::Button::Left);
+
+    map.bind(InputAction::ClearCanvas, Key::Backspace);
+    map.bind(InputAction::Line, Key::Space);
+    map.bind(InputAction::Polygon, Key::P);
+    map.bind(InputAction::Polyline, Key::L);
+    map.bind(InputAction::Circle, Key::O);
+    map.bind(InputAction::Ellipse, Key::E);
+    map.bind(InputAction::SpawnCircle, Key::K);
+
+    map.bind(InputAction::LoadBackground, Key::Num1);
+    map.bind(InputAction::SaveCanvas, Key::Num2);
+    map.bind(InputAction::BlankCanvas, Key::Num3);
+    map.bind(InputAction::LoadSnapshot, Key::Num4);
+    map.bind(InputAction::HalveCanvas, Key::Num5);
+
+    map.bind(InputAction::PanLeft, Key::Left);
+    map.bind(InputAction::PanRight, Key::Right);
+    map.bind(InputAction::PanUp, Key::Up);
+    map.bind(InputAction::PanDown, Key::Down);
+
+    map.bind(InputAction::Fill, Key::F);
+    map.bind(InputAction::FillRed, Key::R);
+    map.bind(InputAction::FillGreen, Key::G);
+    map.bind(InputAction::FillBlue, Key::B);
+    map.bind(InputAction::FillYellow, Key::Y);
+    map.bind(InputAction::FillCyan, Key::C);
+    map.bind(InputAction::FillMagenta, Key::M);
+
+    map.bind(InputAction::Undo, Key::Z, true);
+    map.bind(InputAction::Redo, Key::Y, true);
+    map.bind(InputAction::ToggleHud, Key::F3);
+    map.bind(InputAction::Quit, Key::Escape);
+    return map;
+}
+
+void InputMap::bind(InputAction action, sf::Keyboard::Key key, bool control) {
+    if (key == sf::Keyboard::Key::Unknown || action == None) return;
+
+    // Kombinacja należała do innej akcji — usunięcie jej z tamtej listy
+    InputAction& owner = keys[slot({ key, control })];
+    if (owner != None) {
+        auto& list = bindings[static_cast<std::size_t>(owner)];
+        list.erase(std::remove_if(list.begin(), list.end(),
+            [&](const KeyBinding& b) { return b.key == key && b.control == control; }), list.end());
+    }
+    owner = action;
+    bindings[static_cast<std::size_t>(action)].push_back({ key, control });
+}
+
+void InputMap::bind(InputAction action, sf::Mouse::Button button) {
+    buttons[static_cast<std::size_t>(button)] = action;
+}
+
+void InputMap::unbind(InputAction action) {
+    if (action == None) return;
+    for (const KeyBinding& b : bindings[static_cast<std::size_t>(action)])
+        keys[slot(b)] = None;
+    bindings[static_cast<std::size_t>(action)].clear();
+    std::replace(buttons.begin(), buttons.end(), action, None);
+}
+
+InputAction InputMap::find(sf::Keyboard::Key key, bool control) const {
+    if (key == sf::Keyboard::Key::Unknown) return None;
+    return keys[slot({ key, control })];
+}
+
+InputAction InputMap::find(sf::Mouse::Button button) const {
+    return buttons[static_cast<std::size_t>(button)];
+}
+
+// ------------------------------
+// InputState — odczyt akcji
+// ------------------------------
+bool InputState::isDown(InputAction action) const {
+    if (!map || action == InputMap::None) return false;
+    for (const InputMap::KeyBinding& b : map->getBindings(action))
+        if (isKeyDown(b.key) && (!b.control || isControlDown()))
+            return true;
+    for (std::size_t i = 0; i < sf::Mouse::ButtonCount; ++i)
+        if (buttonsDown.test(i) && map->find(static_cast<sf::Mouse::Button>(i)) == action)
+            return true;
+    return false;
+}
+
+// ------------------------------
+// InputSystem — zdarzenia okna
+// ------------------------------
+InputSystem::InputSystem(InputMap initial) : map(std::move(initial)) {
+    state.map = &map;
+}
+
+void InputSystem::handleEvent(const sf::Event& event) {
+    if (const auto* key = event.getIf<sf::Event::KeyPressed>()) {
+        if (key->code != sf::Keyboard::Key::Unknown)
+            state.keysDown.set(static_cast<std::size_t>(key->code));
+        InputAction action = map.find(key->code, key->control);
+        if (action != InputMap::None)
+            state.triggered.push_back({ action, state.mouse });
+    }
+    else if (const auto* key = event.getIf<sf::Event::KeyReleased>()) {
+        if (key->code != sf::Keyboard::Key::Unknown)
+            state.keysDown.reset(static_cast<std::size_t>(key->code));
+    }
+    else if (const auto* moved = event.getIf<sf::Event::MouseMoved>()) {
+        state.mouse = sf::Vector2f(moved->position);
+    }
+    else if (const auto* button = event.getIf<sf::Event::MouseButtonPressed>()) {
+        state.mouse = sf::Vector2f(button->position);
+        state.buttonsDown.set(static_cast<std::size_t>(button->button));
+        InputAction action = map.find(button->button);
+        if (action != InputMap::None)
+            state.triggered.push_back({ action, state.mouse });
+    }
+    else if (const auto* button = event.getIf<sf::Event::MouseButtonReleased>()) {
+        state.mouse = sf::Vector2f(button->position);
+        state.buttonsDown.reset(static_cast<std::size_t>(button->button));
+    }
+    else if (event.is<sf::Event::FocusLost>()) {
+        // Zwolnienia klawiszy poza oknem nie dotrą — nic nie jest trzymane
+        state.keysDown.reset();
+        state.buttonsDown.reset();
+    }
+}
@@ -0,0 +1,213 @@
+﻿#pragma once
+#include <SFML/Graphics.hpp>
+#include <SFML/Window.hpp>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @enum InputAction
+ * @brief Akcje wyzwalane klawiszami (przypisania w InputMap).
+ */
+enum class InputAction : std::uint8_t {
+    MoveUp, MoveDown, MoveLeft, MoveRight,     ///< Ruch gracza (stan trzymania).
+    AddPoint,                                  ///< Punkt w miejscu kursora.
+    ClearCanvas, Line, Polygon, Polyline, Circle, Ellipse, SpawnCircle,
+    LoadBackground, SaveCanvas, BlankCanvas, LoadSnapshot, HalveCanvas,
+    PanLeft, PanRight, PanUp, PanDown,         ///< Przesuwanie widoku kanwy kafelkowej.
+    Fill,                                      ///< Wypełnienie — kolor wybierany kolejną akcją Fill*.
+    FillRed, FillGreen, FillBlue, FillYellow, FillCyan, FillMagenta,
+    Undo, Redo, ToggleHud, Quit,
+    Count                                      ///< Liczba akcji (nie jest akcją).
+};
+
+/**
+ * @struct TriggeredAction
+ * @brief Akcja wyzwolona w klatce wraz z położeniem kursora w chwili zdarzenia.
+ */
+struct TriggeredAction {
+    InputAction action;      ///< Akcja.
+    sf::Vector2f position;   ///< Położenie kursora w oknie.
+};
+
+/**
+ * @class InputMap
+ * @brief Tablica przypisań klawiszy (z Ctrl lub bez) i przycisków myszy do akcji.
+ *
+ * Jedna kombinacja wyzwala co najwyżej jedną akcję, a akcja może mieć
+ * wiele kombinacji. Przypisania można zmieniać w czasie działania.
+ */
+class InputMap {
+public:
+    static constexpr std::size_t ActionCount = static_cast<std::size_t>(InputAction::Count); ///< Liczba akcji.
+    static constexpr InputAction None = InputAction::Count; ///< Brak przypisania.
+
+    /**
+     * @struct KeyBinding
+     * @brief Klawisz z informacją o wymaganym Ctrl.
+     */
+    struct KeyBinding {
+        sf::Keyboard::Key key; ///< Klawisz.
+        bool control = false;  ///< Czy wymagany jest Ctrl.
+    };
+
+private:
+    std::array<InputAction, sf::Keyboard::KeyCount * 2> keys;  ///< [klawisz * 2 + Ctrl] -> akcja.
+    std::array<InputAction, sf::Mouse::ButtonCount> buttons;   ///< Przycisk myszy -> akcja.
+    std::array<std::vector<KeyBinding>, ActionCount> bindings; ///< Akcja -> klawisze (stan trzymania).
+
+    static std::size_t slot(KeyBinding binding) {
+        return static_cast<std::size_t>(binding.key) * 2 + (binding.control ? 1 : 0);
+    }
+
+public:
+    /**
+     * @brief Konstruktor — mapa bez przypisań.
+     */
+    InputMap();
+
+    /**
+     * @brief Tworzy domyślne przypisania silnika.
+     * @return Mapa.
+     */
+    static InputMap defaults();
+
+    /**
+     * @brief Przypisuje kombinację klawiszy do akcji (zastępuje poprzednią akcję tej kombinacji).
+     * @param action Akcja.
+     * @param key Klawisz.
+     * @param control Czy wymagany jest Ctrl.
+     */
+    void bind(InputAction action, sf::Keyboard::Key key, bool control = false);
+
+    /**
+     * @brief Przypisuje przycisk myszy do akcji.
+     * @param action Akcja.
+     * @param button Przycisk.
+     */
+    void bind(InputAction action, sf::Mouse::Button button);
+
+    /**
+     * @brief Usuwa wszystkie przypisania akcji.
+     * @param action Akcja.
+     */
+    void unbind(InputAction action);
+
+    /**
+     * @brief Zwraca akcję kombinacji klawiszy.
+     * @return Akcja lub None.
+     */
+    InputAction find(sf::Keyboard::Key key, bool control) const;
+
+    /**
+     * @brief Zwraca akcję przycisku myszy.
+     * @return Akcja lub None.
+     */
+    InputAction find(sf::Mouse::Button button) const;
+
+    /**
+     * @brief Zwraca klawisze akcji.
+     * @param action Akcja.
+     * @return Przypisane kombinacje.
+     */
+    const std::vector<KeyBinding>& getBindings(InputAction action) const { return bindings[static_cast<std::size_t>(action)]; }
+};
+
+/**
+ * @class InputState
+ * @brief Migawka klawiatury i myszy z jednej klatki.
+ *
+ * Stan jest budowany wyłącznie ze zdarzeń okna — odczyty nie wywołują
+ * funkcji systemowych, więc dowolna liczba obiektów może z niego
+ * korzystać w każdej klatce. Odczyt akcji korzysta z aktywnej InputMap.
+ */
+class InputState {
+private:
+    std::bitset<sf::Keyboard::KeyCount> keysDown;         ///< Trzymane klawisze.
+    std::bitset<sf::Mouse::ButtonCount> buttonsDown;      ///< Trzymane przyciski.
+    sf::Vector2f mouse;                                   ///< Położenie kursora w oknie.
+    std::vector<TriggeredAction> triggered;               ///< Akcje wyzwolone w klatce (kolejność zdarzeń).
+    const InputMap* map = nullptr;                        ///< Przypisania.
+
+    friend class InputSystem;
+
+public:
+    /**
+     * @brief Sprawdza, czy klawisz jest trzymany.
+     */
+    bool isKeyDown(sf::Keyboard::Key key) const {
+        return key != sf::Keyboard::Key::Unknown && keysDown.test(static_cast<std::size_t>(key));
+    }
+
+    /**
+     * @brief Sprawdza, czy przycisk myszy jest trzymany.
+     */
+    bool isButtonDown(sf::Mouse::Button button) const { return buttonsDown.test(static_cast<std::size_t>(button)); }
+
+    /**
+     * @brief Sprawdza, czy trzymany jest Ctrl (lewy lub prawy).
+     */
+    bool isControlDown() const { return isKeyDown(sf::Keyboard::Key::LControl) || isKeyDown(sf::Keyboard::Key::RControl); }
+
+    /**
+     * @brief Sprawdza, czy trzymany jest któryś z klawiszy akcji.
+     * @param action Akcja.
+     * @return true jeśli akcja jest aktywna.
+     */
+    bool isDown(InputAction action) const;
+
+    /**
+     * @brief Zwraca położenie kursora (ostatnie zdarzenie myszy).
+     * @return Położenie w pikselach okna.
+     */
+    sf::Vector2f getMousePosition() const { return mouse; }
+
+    /**
+     * @brief Zwraca akcje wyzwolone w klatce, w kolejności zdarzeń.
+     * @return Lista akcji.
+     */
+    const std::vector<TriggeredAction>& getTriggered() const { return triggered; }
+};
+
+/**
+ * @class InputSystem
+ * @brief Buduje InputState ze zdarzeń okna i mapuje je na akcje.
+ */
+class InputSystem {
+private:
+    InputMap map;       ///< Przypisania (zmienne w czasie działania).
+    InputState state;   ///< Migawka bieżącej klatki.
+
+public:
+    /**
+     * @brief Konstruktor.
+     * @param map Przypisania początkowe.
+     */
+    explicit InputSystem(InputMap map = InputMap::defaults());
+    InputSystem(const InputSystem&) = delete;
+    InputSystem& operator=(const InputSystem&) = delete;
+
+    /**
+     * @brief Rozpoczyna klatkę — czyści listę wyzwolonych akcji.
+     */
+    void beginFrame() { state.triggered.clear(); }
+
+    /**
+     * @brief Uwzględnia zdarzenie okna w migawce.
+     * @param event Zdarzenie.
+     */
+    void handleEvent(const sf::Event& event);
+
+    /**
+     * @brief Zwraca migawkę bieżącej klatki.
+     * @return Stan wejścia.
+     */
+    const InputState& getState() const { return state; }
+
+    /**
+     * @brief Zwraca przypisania (do zmiany sterowania).
+     * @return Mapa.
+     */
+    InputMap& getMap() { return map; }
+};
@@ -0,0 +1,124 @@
+﻿#include "ObjectStore.hpp"
+
+namespace {
+constexpr std::uint32_t NoIndex = 0xFFFFFFFF;
+}
+
+// ------------------------------
+// BlockPool
+// ------------------------------
+BlockPool::BlockPool(std::size_t size, std::size_t perChunk)
+    : blockSize((size + sizeof(Unit) - 1) / sizeof(Unit) * sizeof(Unit)),
+    blocksPerChunk(perChunk) {
+}
+
+void* BlockPool::allocate() {
+    if (freeBlocks.empty()) {
+        const std::size_t unitsPerBlock = blockSize / sizeof(Unit);
+        chunks.push_back(std::make_unique<Unit[]>(unitsPerBlock * blocksPerChunk));
+        Unit* base = chunks.back().get();
+        freeBlocks.reserve(freeBlocks.size() + blocksPerChunk);
+        for (std::size_t i = blocksPerChunk; i-- > 0;)
+            freeBlocks.push_back(base + i * unitsPerBlock);
+    }
+    void* block = freeBlocks.back();
+    freeBlocks.pop_back();
+    return block;
+}
+
+// ------------------------------
+// ObjectStore — miejsca i uchwyty
+// ------------------------------
+BlockPool& ObjectStore::poolFor(std::size_t size) {
+    std::size_t rounded = (size + sizeof(BlockPool::Unit) - 1) / sizeof(BlockPool::Unit) * sizeof(BlockPool::Unit);
+    for (auto& pool : pools)
+        if (pool->getBlockSize() == rounded) return *pool;
+    pools.push_back(std::make_unique<BlockPool>(rounded));
+    return *pools.back();
+}
+
+ObjectHandle ObjectStore::insert(UpdatableObject* object, void* memory, BlockPool* pool) {
+    std::uint32_t index;
+    if (!freeSlots.empty()) {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        index = static_cast<std::uint32_t>(slots.size());
+        slots.emplace_back();
+    }
+
+    Slot& s = slots[index];
+    s.object = object;
+    s.memory = memory;
+    s.pool = pool;
+    s.dense = NoIndex;
+    s.despawnQueued = false;
+    pendingSpawns.push_back(index);
+    return { index, s.generation };
+}
+
+void ObjectStore::despawn(ObjectHandle handle) {
+    if (!get(handle)) return;
+    Slot& s = slots[handle.index];
+    if (s.despawnQueued) return;
+    s.despawnQueued = true;
+    pendingDespawns.push_back(handle.index);
+}
+
+void ObjectStore::destroy(std::uint32_t index) {
+    Slot& s = slots[index];
+    if (s.pool) {
+        s.object->~UpdatableObject();
+        s.pool->deallocate(s.memory);
+    }
+    else {
+        delete s.object;
+    }
+    s.object = nullptr;
+    s.memory = nullptr;
+    s.pool = nullptr;
+    s.dense = NoIndex;
+    s.despawnQueued = false;
+    ++s.generation; // unieważnia wszystkie wydane uchwyty
+    freeSlots.push_back(index);
+}
+
+// ------------------------------
+// Bezpieczny punkt klatki
+// ------------------------------
+void ObjectStore::applyPending() {
+    // Aktywacja — obiekt mógł zostać usunięty zanim zdążył się pojawić
+    for (std::uint32_t index : pendingSpawns) {
+        Slot& s = slots[index];
+        if (!s.object || s.despawnQueued) continue;
+        s.dense = static_cast<std::uint32_t>(active.size());
+        active.push_back(s.object);
+        activeSlots.push_back(index);
+    }
+    pendingSpawns.clear();
+
+    // Usuwanie — zamiana z ostatnim aktywnym
+    for (std::uint32_t index : pendingDespawns) {
+        Slot& s = slots[index];
+        if (s.dense != NoIndex) {
+            std::uint32_t last = static_cast<std::uint32_t>(active.size() - 1);
+            active[s.dense] = active[last];
+            activeSlots[s.dense] = activeSlots[last];
+            slots[activeSlots[s.dense]].dense = s.dense;
+            active.pop_back();
+            activeSlots.pop_back();
+        }
+        destroy(index);
+    }
+    pendingDespawns.clear();
+}
+
+void ObjectStore::clear() {
+    for (std::uint32_t i = 0; i < slots.size(); ++i)
+        if (slots[i].object) destroy(i);
+    active.clear();
+    activeSlots.clear();
+    pendingSpawns.clear();
+    pendingDespawns.clear();
+}
@@ -0,0 +1,187 @@
+﻿#pragma once
+#include "GameObject.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct ObjectHandle
+ * @brief Stabilny uchwyt obiektu w ObjectStore (indeks miejsca + generacja).
+ *
+ * Po usunięciu obiektu generacja miejsca rośnie, więc stare uchwyty
+ * przestają być ważne, nawet gdy miejsce zostanie ponownie użyte.
+ */
+struct ObjectHandle {
+    std::uint32_t index = 0xFFFFFFFF; ///< Indeks miejsca.
+    std::uint32_t generation = 0;     ///< Generacja miejsca w chwili utworzenia.
+
+    bool operator==(const ObjectHandle& o) const { return index == o.index && generation == o.generation; }
+    bool operator!=(const ObjectHandle& o) const { return !(*this == o); }
+};
+
+/**
+ * @class BlockPool
+ * @brief Pula bloków stałego rozmiaru przydzielanych porcjami.
+ *
+ * Zwolnione bloki trafiają na listę wolnych i są używane ponownie,
+ * więc tworzenie i usuwanie obiektów nie korzysta ze sterty po rozgrzaniu.
+ */
+class BlockPool {
+public:
+    /// Jednostka pamięci o maksymalnym wyrównaniu podstawowym.
+    struct alignas(std::max_align_t) Unit { std::byte bytes[alignof(std::max_align_t)]; };
+
+private:
+    std::size_t blockSize;       ///< Rozmiar bloku (wielokrotność sizeof(Unit)).
+    std::size_t blocksPerChunk;  ///< Liczba bloków w jednej porcji.
+    std::vector<std::unique_ptr<Unit[]>> chunks; ///< Przydzielone porcje.
+    std::vector<void*> freeBlocks; ///< Wolne bloki.
+
+public:
+    /**
+     * @brief Konstruktor.
+     * @param blockSize Rozmiar bloku w bajtach.
+     * @param blocksPerChunk Liczba bloków w porcji.
+     */
+    BlockPool(std::size_t blockSize, std::size_t blocksPerChunk = 256);
+
+    void* allocate();                 ///< Pobiera wolny blok.
+    void deallocate(void* block) { freeBlocks.push_back(block); } ///< Zwraca blok do puli.
+    std::size_t getBlockSize() const { return blockSize; }         ///< Rozmiar bloku.
+    std::size_t getChunkCount() const { return chunks.size(); }    ///< Liczba porcji.
+};
+
+/**
+ * @class ObjectStore
+ * @brief Magazyn obiektów gry z uchwytami generacyjnymi i odroczonymi zmianami.
+ *
+ * Obiekty tworzone przez spawn<T>() są umieszczane w pulach bloków
+ * (po jednej na klasę rozmiaru), a nie osobno na stercie. spawn() i despawn()
+ * wywołane w trakcie aktualizacji tylko kolejkują zmianę — lista aktywnych
+ * obiektów zmienia się dopiero w applyPending(), w bezpiecznym punkcie klatki.
+ * Aktywne obiekty leżą w ciągłej tablicy, a usuwanie to zamiana z ostatnim (O(1)).
+ */
+class ObjectStore {
+private:
+    struct Slot {
+        UpdatableObject* object = nullptr; ///< Obiekt (nullptr = wolne miejsce).
+        void* memory = nullptr;            ///< Blok w puli (nullptr = obiekt przejęty z unique_ptr).
+        BlockPool* pool = nullptr;         ///< Pula właściciela bloku.
+        std::uint32_t generation = 1;      ///< Bieżąca generacja.
+        std::uint32_t dense = 0xFFFFFFFF;  ///< Pozycja w tablicy aktywnych (lub brak).
+        bool despawnQueued = false;        ///< Czy usunięcie czeka w kolejce.
+    };
+
+    std::vector<Slot> slots;                    ///< Miejsca obiektów.
+    std::vector<std::uint32_t> freeSlots;       ///< Wolne miejsca do ponownego użycia.
+    std::vector<UpdatableObject*> active;       ///< Aktywne obiekty (ciągle, do iteracji).
+    std::vector<std::uint32_t> activeSlots;     ///< Miejsce odpowiadające pozycji w active.
+    std::vector<std::uint32_t> pendingSpawns;   ///< Miejsca czekające na aktywację.
+    std::vector<std::uint32_t> pendingDespawns; ///< Miejsca czekające na usunięcie.
+    std::vector<std::unique_ptr<BlockPool>> pools; ///< Pule wg rozmiaru bloku.
+
+    /**
+     * @brief Zwraca pulę dla danego rozmiaru obiektu.
+     * @param size Rozmiar obiektu w bajtach.
+     * @return Referencja do puli.
+     */
+    BlockPool& poolFor(std::size_t size);
+
+    /**
+     * @brief Rezerwuje miejsce i kolejkuje aktywację obiektu.
+     * @param object Obiekt.
+     * @param memory Blok pamięci obiektu (lub nullptr).
+     * @param pool Pula bloku (lub nullptr).
+     * @return Uchwyt obiektu.
+     */
+    ObjectHandle insert(UpdatableObject* object, void* memory, BlockPool* pool);
+
+    /**
+     * @brief Niszczy obiekt z miejsca i zwalnia miejsce.
+     * @param index Indeks miejsca.
+     */
+    void destroy(std::uint32_t index);
+
+public:
+    ObjectStore() = default;
+    ObjectStore(const ObjectStore&) = delete;
+    ObjectStore& operator=(const ObjectStore&) = delete;
+    ~ObjectStore() { clear(); }
+
+    /**
+     * @brief Tworzy obiekt typu T w puli (aktywny od najbliższego applyPending()).
+     * @param args Argumenty konstruktora T.
+     * @return Uchwyt obiektu.
+     */
+    template <typename T, typename... Args>
+    ObjectHandle spawn(Args&&... args) {
+        static_assert(std::is_base_of_v<UpdatableObject, T>, "ObjectStore przechowuje obiekty UpdatableObject");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Nieobsługiwane wyrównanie");
+        BlockPool& pool = poolFor(sizeof(T));
+        void* memory = pool.allocate();
+        T* object;
+        try {
+            object = new (memory) T(std::forward<Args>(args)...);
+        }
+        catch (...) {
+            pool.deallocate(memory);
+            throw;
+        }
+        return insert(object, memory, &pool);
+    }
+
+    /**
+     * @brief Przejmuje obiekt utworzony poza magazynem.
+     * @param object Obiekt.
+     * @return Uchwyt obiektu.
+     */
+    ObjectHandle adopt(std::unique_ptr<UpdatableObject> object) {
+        return insert(object.release(), nullptr, nullptr);
+    }
+
+    /**
+     * @brief Kolejkuje usunięcie obiektu (wykonywane w applyPending()).
+     * @param handle Uchwyt obiektu.
+     */
+    void despawn(ObjectHandle handle);
+
+    /**
+     * @brief Zwraca obiekt dla uchwytu.
+     * @param handle Uchwyt obiektu.
+     * @return Wskaźnik na obiekt lub nullptr, jeśli uchwyt jest nieaktualny.
+     */
+    UpdatableObject* get(ObjectHandle handle) const {
+        if (handle.index >= slots.size()) return nullptr;
+        const Slot& s = slots[handle.index];
+        return s.generation == handle.generation ? s.object : nullptr;
+    }
+
+    /**
+     * @brief Zwraca obiekt dla uchwytu jako konkretny typ.
+     * @param handle Uchwyt obiektu.
+     * @return Wskaźnik na obiekt lub nullptr (nieaktualny uchwyt lub inny typ).
+     */
+    template <typename T>
+    T* getAs(ObjectHandle handle) const { return dynamic_cast<T*>(get(handle)); }
+
+    /**
+     * @brief Wykonuje zakolejkowane utworzenia i usunięcia (bezpieczny punkt klatki).
+     */
+    void applyPending();
+
+    /**
+     * @brief Niszczy wszystkie obiekty.
+     */
+    void clear();
+
+    // --- Iteracja po aktywnych obiektach ---
+    auto begin() const { return active.begin(); }
+    auto end() const { return active.end(); }
+    std::size_t size() const { return active.size(); } ///< Liczba aktywnych obiektów.
+    std::size_t getPendingCount() const { return pendingSpawns.size() + pendingDespawns.size(); } ///< Zmiany w kolejce.
+    bool hasPendingDespawns() const { return !pendingDespawns.empty(); } ///< Czy applyPending() zniszczy obiekty.
+};
@@ -0,0 +1,190 @@
+﻿#include "PerfHud.hpp"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+constexpr unsigned int CellWidth = 6;    ///< Kafel glifu w atlasie (5 kolumn + odstęp).
+constexpr unsigned int CellHeight = 8;   ///< Wysokość kafla (7 wierszy + wydłużenia).
+constexpr unsigned int AtlasColumns = 16;
+constexpr unsigned int GlyphCount = 95;  ///< ASCII 32..126; kafel 95 jest pełny.
+constexpr float Scale = 2.f;             ///< Powiększenie czcionki na ekranie.
+constexpr float LineHeight = (CellHeight + 1) * Scale;
+constexpr float Padding = 8.f;
+constexpr float GraphHeight = 64.f;
+constexpr float BarWidth = 3.f;
+
+// Czcionka 5x7: pięć kolumn na znak, bit 0 = górny wiersz
+constexpr std::uint8_t Font[GlyphCount][5] = {
+    {0x00,0x00,0x00,0x00,0x00}, {0x00,0x00,0x5F,0x00,0x00}, {0x00,0x07,0x00,0x07,0x00}, {0x14,0x7F,0x14,0x7F,0x14},
+    {0x24,0x2A,0x7F,0x2A,0x12}, {0x23,0x13,0x08,0x64,0x62}, {0x36,0x49,0x56,0x20,0x50}, {0x00,0x08,0x07,0x03,0x00},
+    {0x00,0x1C,0x22,0x41,0x00}, {0x00,0x41,0x22,0x1C,0x00}, {0x2A,0x1C,0x7F,0x1C,0x2A}, {0x08,0x08,0x3E,0x08,0x08},
+    {0x00,0x80,0x70,0x30,0x00}, {0x08,0x08,0x08,0x08,0x08}, {0x00,0x00,0x60,0x60,0x00}, {0x20,0x10,0x08,0x04,0x02},
+    {0x3E,0x51,0x49,0x45,0x3E}, {0x00,0x42,0x7F,0x40,0x00}, {0x72,0x49,0x49,0x49,0x46}, {0x21,0x41,0x49,0x4D,0x33},
+    {0x18,0x14,0x12,0x7F,0x10}, {0x27,0x45,0x45,0x45,0x39}, {0x3C,0x4A,0x49,0x49,0x31}, {0x41,0x21,0x11,0x09,0x07},
+    {0x36,0x49,0x49,0x49,0x36}, {0x46,0x49,0x49,0x29,0x1E}, {0x00,0x00,0x14,0x00,0x00}, {0x00,0x40,0x34,0x00,0x00},
+    {0x00,0x08,0x14,0x22,0x41}, {0x14,0x14,0x14,0x14,0x14}, {0x00,0x41,0x22,0x14,0x08}, {0x02,0x01,0x59,0x09,0x06},
+    {0x3E,0x41,0x5D,0x59,0x4E}, {0x7C,0x12,0x11,0x12,0x7C}, {0x7F,0x49,0x49,0x49,0x36}, {0x3E,0x41,0x41,0x41,0x22},
+    {0x7F,0x41,0x41,0x41,0x3E}, {0x7F,0x49,0x49,0x49,0x41}, {0x7F,0x09,0x09,0x09,0x01}, {0x3E,0x41,0x41,0x51,0x73},
+    {0x7F,0x08,0x08,0x08,0x7F}, {0x00,0x41,0x7F,0x41,0x00}, {0x20,0x40,0x41,0x3F,0x01}, {0x7F,0x08,0x14,0x22,0x41},
+    {0x7F,0x40,0x40,0x40,0x40}, {0x7F,0x02,0x1C,0x02,0x7F}, {0x7F,0x04,0x08,0x10,0x7F}, {0x3E,0x41,0x41,0x41,0x3E},
+    {0x7F,0x09,0x09,0x09,0x06}, {0x3E,0x41,0x51,0x21,0x5E}, {0x7F,0x09,0x19,0x29,0x46}, {0x26,0x49,0x49,0x49,0x32},
+    {0x03,0x01,0x7F,0x01,0x03}, {0x3F,0x40,0x40,0x40,0x3F}, {0x1F,0x20,0x40,0x20,0x1F}, {0x3F,0x40,0x38,0x40,0x3F},
+    {0x63,0x14,0x08,0x14,0x63}, {0x03,0x04,0x78,0x04,0x03}, {0x61,0x59,0x49,0x4D,0x43}, {0x00,0x7F,0x41,0x41,0x41},
+    {0x02,0x04,0x08,0x10,0x20}, {0x00,0x41,0x41,0x41,0x7F}, {0x04,0x02,0x01,0x02,0x04}, {0x40,0x40,0x40,0x40,0x40},
+    {0x00,0x03,0x07,0x08,0x00}, {0x20,0x54,0x54,0x78,0x40}, {0x7F,0x28,0x44,0x44,0x38}, {0x38,0x44,0x44,0x44,0x28},
+    {0x38,0x44,0x44,0x28,0x7F}, {0x38,0x54,0x54,0x54,0x18}, {0x00,0x08,0x7E,0x09,0x02}, {0x18,0xA4,0xA4,0x9C,0x78},
+    {0x7F,0x08,0x04,0x04,0x78}, {0x00,0x44,0x7D,0x40,0x00}, {0x20,0x40,0x40,0x3D,0x00}, {0x7F,0x10,0x28,0x44,0x00},
+    {0x00,0x41,0x7F,0x40,0x00}, {0x7C,0x04,0x78,0x04,0x78}, {0x7C,0x08,0x04,0x04,0x78}, {0x38,0x44,0x44,0x44,0x38},
+    {0xFC,0x18,0x24,0x24,0x18}, {0x18,0x24,0x24,0x18,0xFC}, {0x7C,0x08,0x04,0x04,0x08}, {0x48,0x54,0x54,0x54,0x24},
+    {0x04,0x04,0x3F,0x44,0x24}, {0x3C,0x40,0x40,0x20,0x7C}, {0x1C,0x20,0x40,0x20,0x1C}, {0x3C,0x40,0x30,0x40,0x3C},
+    {0x44,0x28,0x10,0x28,0x44}, {0x4C,0x90,0x90,0x90,0x7C}, {0x44,0x64,0x54,0x4C,0x44}, {0x00,0x08,0x36,0x41,0x00},
+    {0x00,0x00,0x77,0x00,0x00}, {0x00,0x41,0x36,0x08,0x00}, {0x02,0x01,0x02,0x04,0x02},
+};
+
+sf::Vector2f cellOrigin(unsigned int index) {
+    return { static_cast<float>(index % AtlasColumns * CellWidth), static_cast<float>(index / AtlasColumns * CellHeight) };
+}
+} // namespace
+
+// ------------------------------
+// Atlas glifów
+// ------------------------------
+PerfHud::PerfHud(unsigned int targetFps)
+    : atlas(TextureTracker::get().createUnique("PerfHud.atlas")),
+      budgetMs(1000.f / (targetFps ? targetFps : 60))
+{
+    const sf::Vector2u size{ AtlasColumns * CellWidth, (GlyphCount / AtlasColumns + 1) * CellHeight };
+    sf::Image image(size, sf::Color::Transparent);
+    for (unsigned int g = 0; g < GlyphCount; ++g) {
+        sf::Vector2f origin = cellOrigin(g);
+        for (unsigned int col = 0; col < 5; ++col)
+            for (unsigned int row = 0; row < CellHeight; ++row)
+                if (Font[g][col] >> row & 1)
+                    image.setPixel({ static_cast<unsigned int>(origin.x) + col, static_cast<unsigned int>(origin.y) + row }, sf::Color::White);
+    }
+    sf::Vector2f solidCell = cellOrigin(GlyphCount);
+    for (unsigned int x = 0; x < CellWidth; ++x)
+        for (unsigned int y = 0; y < CellHeight; ++y)
+            image.setPixel({ static_cast<unsigned int>(solidCell.x) + x, static_cast<unsigned int>(solidCell.y) + y }, sf::Color::White);
+
+    if (atlas->loadFromImage(image))
+        TextureTracker::get().refresh(atlas.get());
+    vertices.reserve(6 * 256);
+}
+
+// ------------------------------
+// Pomiary
+// ------------------------------
+void PerfHud::record(const HudSample& sample) {
+    last = sample;
+    frameTimes[cursor] = sample.frameMs;
+    cursor = (cursor + 1) % GraphFrames;
+    recorded = std::min(recorded + 1, GraphFrames);
+}
+
+// ------------------------------
+// Budowa wierzchołków
+// ------------------------------
+void PerfHud::quad(sf::Vector2f pos, sf::Vector2f size, sf::Vector2f uv, sf::Vector2f uvSize, sf::Color color) {
+    const sf::Vector2f p1{ pos.x + size.x, pos.y }, p2{ pos.x, pos.y + size.y }, p3 = pos + size;
+    const sf::Vector2f t1{ uv.x + uvSize.x, uv.y }, t2{ uv.x, uv.y + uvSize.y }, t3 = uv + uvSize;
+    vertices.push_back({ pos, color, uv });
+    vertices.push_back({ p1, color, t1 });
+    vertices.push_back({ p2, color, t2 });
+    vertices.push_back({ p2, color, t2 });
+    vertices.push_back({ p1, color, t1 });
+    vertices.push_back({ p3, color, t3 });
+}
+
+void PerfHud::solid(sf::Vector2f pos, sf::Vector2f size, sf::Color color) {
+    // Środek pełnego kafla — bez próbkowania sąsiednich glifów
+    sf::Vector2f center = cellOrigin(GlyphCount) + sf::Vector2f{ CellWidth / 2.f, CellHeight / 2.f };
+    quad(pos, size, center, { 0.f, 0.f }, color);
+}
+
+float PerfHud::text(sf::Vector2f pos, const char* str, sf::Color color) {
+    const sf::Vector2f cell{ CellWidth * Scale, CellHeight * Scale };
+    float x = pos.x;
+    for (; *str; ++str, x += cell.x) {
+        unsigned char c = static_cast<unsigned char>(*str);
+        if (c <= ' ' || c > '~') continue;
+        quad({ x, pos.y }, cell, cellOrigin(c - ' '), { static_cast<float>(CellWidth), static_cast<float>(CellHeight) }, color);
+    }
+    return x - pos.x;
+}
+
+// ------------------------------
+// Rysowanie
+// ------------------------------
+std::size_t PerfHud::draw(sf::RenderTarget& target) {
+    if (!visible) return 0;
+    vertices.clear();
+
+    float average = 0.f, worst = 0.f;
+    for (std::size_t i = 0; i < recorded; ++i) {
+        average += frameTimes[i];
+        worst = std::max(worst, frameTimes[i]);
+    }
+    average = recorded ? average / recorded : 0.f;
+
+    const sf::Color label(220, 220, 220);
+    const float mib = 1.f / (1024.f * 1024.f);
+    char line[96];
+    sf::Vector2f pos{ Padding * 2, Padding * 2 };
+    float width = 0.f;
+
+    std::snprintf(line, sizeof(line), "FPS %5.1f  %6.2f ms  max %6.2f ms",
+        average > 0.f ? 1000.f / average : 0.f, last.frameMs, worst);
+    width = std::max(width, text(pos, line, sf::Color::White));
+    pos.y += LineHeight;
+
+    std::snprintf(line, sizeof(line), "input %5.2f  update %5.2f  render %5.2f ms",
+        last.inputMs, last.updateMs, last.renderMs);
+    width = std::max(width, text(pos, line, label));
+    pos.y += LineHeight;
+
+    std::snprintf(line, sizeof(line), "objects %zu  nodes %zu", last.objects, last.sceneNodes);
+    width = std::max(width, text(pos, line, label));
+    pos.y += LineHeight;
+
+    if (last.textureBudget)
+        std::snprintf(line, sizeof(line), "textures %.1f / %.0f MiB (%zu)",
+            last.textureBytes * mib, last.textureBudget * mib, last.textureCount);
+    else
+        std::snprintf(line, sizeof(line), "textures %.1f MiB (%zu)", last.textureBytes * mib, last.textureCount);
+    width = std::max(width, text(pos, line, label));
+    pos.y += LineHeight;
+
+    const RenderStats& gpu = last.render;
+    std::snprintf(line, sizeof(line), "draws %zu  vertices %zu  pixels %zu", gpu.drawCalls, gpu.vertices, gpu.pixels);
+    width = std::max(width, text(pos, line, label));
+    pos.y += LineHeight;
+
+    // Odczyty z GPU wstrzymują potok — wyróżnione kolorem
+    std::snprintf(line, sizeof(line), "readbacks %zu (%.1f MiB)  uploads %zu (%.1f MiB)",
+        gpu.readbacks, gpu.bytesRead * mib, gpu.uploads, gpu.bytesUploaded * mib);
+    width = std::max(width, text(pos, line, gpu.readbacks ? sf::Color(240, 180, 40) : label));
+    pos.y += LineHeight + Padding / 2;
+
+    // Wykres czasów klatek: pełna wysokość = dwa budżety klatki
+    const float fullScale = budgetMs * 2.f;
+    for (std::size_t i = 0; i < recorded; ++i) {
+        float ms = frameTimes[(cursor + GraphFrames - recorded + i) % GraphFrames];
+        float h = std::min(ms / fullScale, 1.f) * GraphHeight;
+        sf::Color color = ms <= budgetMs ? sf::Color(80, 220, 80) : ms <= fullScale ? sf::Color(240, 180, 40) : sf::Color(240, 60, 60);
+        solid({ pos.x + i * BarWidth, pos.y + GraphHeight - h }, { BarWidth - 1.f, h }, color);
+    }
+    solid({ pos.x, pos.y + GraphHeight / 2 }, { GraphFrames * BarWidth, 1.f }, sf::Color(255, 255, 255, 140));
+    width = std::max(width, GraphFrames * BarWidth);
+    pos.y += GraphHeight;
+
+    // Tło pod całą nakładką — przeniesione na początek, aby było rysowane pierwsze
+    solid({ Padding, Padding }, { width + Padding * 2, pos.y }, sf::Color(0, 0, 0, 170));
+    std::rotate(vertices.begin(), vertices.end() - 6, vertices.end());
+
+    sf::View view = target.getView();
+    target.setView(target.getDefaultView());
+    target.draw(vertices.data(), vertices.size(), sf::PrimitiveType::Triangles, sf::RenderStates(atlas.get()));
+    target.setView(view);
+    return vertices.size();
+}
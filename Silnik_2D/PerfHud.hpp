@@ -0,0 +1,96 @@
+﻿#pragma once
+#include <SFML/Graphics.hpp>
+#include "RenderStats.hpp"
+#include "TextureTracker.hpp"
+#include <array>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @struct HudSample
+ * @brief Pomiary jednej klatki wyświetlane przez PerfHud.
+ */
+struct HudSample {
+    float frameMs = 0.f;           ///< Czas całej klatki (z oczekiwaniem na termin).
+    float inputMs = 0.f;           ///< Obsługa wejścia i odtwarzania.
+    float updateMs = 0.f;          ///< Aktualizacja obiektów.
+    float renderMs = 0.f;          ///< Renderowanie i wyświetlenie.
+    std::size_t objects = 0;       ///< Liczba aktywnych obiektów.
+    std::size_t sceneNodes = 0;    ///< Liczba węzłów hierarchii przekształceń.
+    std::size_t textureBytes = 0;  ///< Pamięć tekstur.
+    std::size_t textureBudget = 0; ///< Budżet pamięci tekstur (0 = brak).
+    std::size_t textureCount = 0;  ///< Liczba tekstur.
+    RenderStats render;            ///< Liczniki pracy GPU.
+};
+
+/**
+ * @class PerfHud
+ * @brief Nakładka z wydajnością silnika rysowana jednym wywołaniem.
+ *
+ * Tekst pochodzi z wbudowanej czcionki bitmapowej 5x7 (ASCII 32..126),
+ * z której przy tworzeniu powstaje mała tekstura-atlas. Tło, tekst
+ * i wykres czasów klatek to trójkąty z jednym atlasem (tło i słupki
+ * próbkują pełny kafel atlasu), więc cała nakładka to jeden draw call.
+ * Bufor wierzchołków jest używany ponownie — rysowanie nie alokuje.
+ */
+class PerfHud {
+public:
+    static constexpr std::size_t GraphFrames = 120; ///< Liczba klatek na wykresie.
+
+private:
+    TextureTracker::UniqueTexture atlas; ///< Atlas glifów (i pełny kafel).
+    std::vector<sf::Vertex> vertices;    ///< Trójkąty nakładki (bufor wielokrotnego użytku).
+    std::array<float, GraphFrames> frameTimes{}; ///< Czasy ostatnich klatek [ms].
+    std::size_t cursor = 0;              ///< Pozycja zapisu w frameTimes.
+    std::size_t recorded = 0;            ///< Liczba zapisanych klatek (do GraphFrames).
+    HudSample last;                      ///< Ostatnia próbka.
+    float budgetMs;                      ///< Budżet klatki (linia na wykresie).
+    bool visible = false;                ///< Czy nakładka jest widoczna.
+
+    /**
+     * @brief Dodaje prostokąt (dwa trójkąty).
+     */
+    void quad(sf::Vector2f pos, sf::Vector2f size, sf::Vector2f uv, sf::Vector2f uvSize, sf::Color color);
+
+    /**
+     * @brief Dodaje prostokąt w jednolitym kolorze.
+     */
+    void solid(sf::Vector2f pos, sf::Vector2f size, sf::Color color);
+
+    /**
+     * @brief Dodaje wiersz tekstu.
+     * @return Szerokość tekstu w pikselach.
+     */
+    float text(sf::Vector2f pos, const char* str, sf::Color color);
+
+public:
+    /**
+     * @brief Konstruktor — buduje atlas glifów.
+     * @param targetFps Docelowa liczba klatek (wyznacza budżet na wykresie; 0 = 60).
+     */
+    explicit PerfHud(unsigned int targetFps = 60);
+
+    /**
+     * @brief Przełącza widoczność.
+     */
+    void toggle() { visible = !visible; }
+
+    /**
+     * @brief Sprawdza widoczność.
+     * @return true jeśli nakładka jest rysowana.
+     */
+    bool isVisible() const { return visible; }
+
+    /**
+     * @brief Zapisuje pomiary klatki (również gdy nakładka jest ukryta).
+     * @param sample Pomiary.
+     */
+    void record(const HudSample& sample);
+
+    /**
+     * @brief Rysuje nakładkę (jeden draw call), jeśli jest widoczna.
+     * @param target Cel rysowania (okno).
+     * @return Liczba wysłanych wierzchołków (0 gdy ukryta).
+     */
+    std::size_t draw(sf::RenderTarget& target);
+};
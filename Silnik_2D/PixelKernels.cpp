@@ -0,0 +1,133 @@
+﻿#include "PixelKernels.hpp"
+#include <algorithm>
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#if defined(_MSC_VER) || defined(__AVX__)
+#include <immintrin.h>
+#define PIXEL_KERNELS_AVX 1
+#endif
+
+namespace {
+// Wiersze od kolumny begin do n (krokami po 4 liczby)
+void weightedRowsSse(const float* const* rows, const float* w, int taps, float* d, std::size_t begin, std::size_t n) {
+    for (std::size_t i = begin; i < n; i += 4) {
+        __m128 acc = _mm_setzero_ps();
+        for (int k = 0; k < taps; ++k)
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(w[k]), _mm_loadu_ps(rows[k] + i)));
+        _mm_storeu_ps(d + i, acc);
+    }
+}
+
+void runningRowSse(float* acc, const float* add, const float* sub, float scale, float* d, std::size_t begin, std::size_t n) {
+    const __m128 s = _mm_set1_ps(scale);
+    for (std::size_t i = begin; i < n; i += 4) {
+        __m128 a = _mm_add_ps(_mm_loadu_ps(acc + i), _mm_sub_ps(_mm_loadu_ps(add + i), _mm_loadu_ps(sub + i)));
+        _mm_storeu_ps(acc + i, a);
+        _mm_storeu_ps(d + i, _mm_mul_ps(a, s));
+    }
+}
+
+#ifdef PIXEL_KERNELS_AVX
+void weightedRowsAvx(const float* const* rows, const float* w, int taps, float* d, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 acc = _mm256_setzero_ps();
+        for (int k = 0; k < taps; ++k)
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(w[k]), _mm256_loadu_ps(rows[k] + i)));
+        _mm256_storeu_ps(d + i, acc);
+    }
+    weightedRowsSse(rows, w, taps, d, i, n);
+}
+
+void runningRowAvx(float* acc, const float* add, const float* sub, float scale, float* d, std::size_t n) {
+    const __m256 s = _mm256_set1_ps(scale);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 a = _mm256_add_ps(_mm256_loadu_ps(acc + i), _mm256_sub_ps(_mm256_loadu_ps(add + i), _mm256_loadu_ps(sub + i)));
+        _mm256_storeu_ps(acc + i, a);
+        _mm256_storeu_ps(d + i, _mm256_mul_ps(a, s));
+    }
+    runningRowSse(acc, add, sub, scale, d, i, n);
+}
+#endif
+} // namespace
+
+// ------------------------------
+// Wykrywanie AVX
+// ------------------------------
+bool PixelKernels::hasAvx() {
+    static const bool avx = [] {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool cpuAvx = (info[2] & (1 << 28)) != 0;
+        return osxsave && cpuAvx && (_xgetbv(0) & 6) == 6; // system zapisuje rejestry YMM
+#elif defined(__AVX__)
+        return true;
+#else
+        return false;
+#endif
+    }();
+    return avx;
+}
+
+// ------------------------------
+// Konwersja RGBA8 <-> float RGBA
+// ------------------------------
+void PixelKernels::bytesToFloats(const std::uint8_t* src, float* dst, std::size_t pixels) {
+    const __m128 scale = _mm_set1_ps(1.f / 255.f);
+    const __m128i zero = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 4 <= pixels; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+        __m128i lo = _mm_unpacklo_epi8(v, zero), hi = _mm_unpackhi_epi8(v, zero);
+        _mm_storeu_ps(dst + i * 4 + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+        _mm_storeu_ps(dst + i * 4 + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+        _mm_storeu_ps(dst + i * 4 + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+        _mm_storeu_ps(dst + i * 4 + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+    }
+    for (std::size_t k = i * 4; k < pixels * 4; ++k)
+        dst[k] = src[k] / 255.f;
+}
+
+void PixelKernels::floatsToBytes(const float* src, std::uint8_t* dst, std::size_t pixels) {
+    const __m128 scale = _mm_set1_ps(255.f);
+    std::size_t i = 0;
+    for (; i + 4 <= pixels; i += 4) {
+        // Zaokrąglenie do najbliższej, nasycenie do 0..255 przy pakowaniu
+        __m128i a = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i * 4 + 0), scale));
+        __m128i b = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i * 4 + 4), scale));
+        __m128i c = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i * 4 + 8), scale));
+        __m128i d = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i * 4 + 12), scale));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4),
+            _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+    }
+    for (std::size_t k = i * 4; k < pixels * 4; ++k)
+        dst[k] = static_cast<std::uint8_t>(std::clamp(src[k] * 255.f + 0.5f, 0.f, 255.f));
+}
+
+// ------------------------------
+// Operacje na całych wierszach
+// ------------------------------
+void PixelKernels::weightedRows(const float* const* rows, const float* weights, int taps, float* d, std::size_t n) {
+#ifdef PIXEL_KERNELS_AVX
+    if (hasAvx()) {
+        weightedRowsAvx(rows, weights, taps, d, n);
+        return;
+    }
+#endif
+    weightedRowsSse(rows, weights, taps, d, 0, n);
+}
+
+void PixelKernels::runningRow(float* acc, const float* add, const float* sub, float scale, float* d, std::size_t n) {
+#ifdef PIXEL_KERNELS_AVX
+    if (hasAvx()) {
+        runningRowAvx(acc, add, sub, scale, d, n);
+        return;
+    }
+#endif
+    runningRowSse(acc, add, sub, scale, d, 0, n);
+}
@@ -0,0 +1,59 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class PixelKernels
+ * @brief Wektorowe jądra operujące na wierszach pikseli float RGBA.
+ *
+ * Wspólne dla FilterPipeline i Resampler: konwersja RGBA8 <-> float
+ * (0..1, jeden piksel = jeden rejestr SSE) oraz sumy ważone całych
+ * wierszy, z których korzystają przebiegi pionowe. SSE2 jest zawsze
+ * dostępne na x64; operacje na wierszach używają AVX, jeśli procesor
+ * i system je obsługują.
+ */
+class PixelKernels {
+public:
+    /**
+     * @brief Sprawdza, czy procesor i system obsługują AVX.
+     * @return true jeśli operacje na wierszach używają AVX.
+     */
+    static bool hasAvx();
+
+    /**
+     * @brief Zamienia piksele RGBA8 na float RGBA 0..1.
+     * @param src Piksele źródłowe.
+     * @param dst Bufor docelowy (4 liczby na piksel).
+     * @param pixels Liczba pikseli.
+     */
+    static void bytesToFloats(const std::uint8_t* src, float* dst, std::size_t pixels);
+
+    /**
+     * @brief Zamienia float RGBA na RGBA8 (zaokrąglenie i nasycenie do 0..255).
+     * @param src Piksele źródłowe.
+     * @param dst Bufor docelowy.
+     * @param pixels Liczba pikseli.
+     */
+    static void floatsToBytes(const float* src, std::uint8_t* dst, std::size_t pixels);
+
+    /**
+     * @brief Suma ważona wierszy: d = suma w[k] * rows[k].
+     * @param rows Wiersze wejściowe.
+     * @param weights Wagi wierszy.
+     * @param taps Liczba wierszy.
+     * @param d Wiersz wynikowy.
+     * @param n Długość wierszy w liczbach float (wielokrotność 4).
+     */
+    static void weightedRows(const float* const* rows, const float* weights, int taps, float* d, std::size_t n);
+
+    /**
+     * @brief Krok sumy bieżącej: acc += add - sub; d = acc * scale.
+     * @param acc Akumulator (aktualizowany).
+     * @param add Wiersz wchodzący do okna.
+     * @param sub Wiersz wychodzący z okna.
+     * @param scale Mnożnik wyniku.
+     * @param d Wiersz wynikowy.
+     * @param n Długość wierszy w liczbach float (wielokrotność 4).
+     */
+    static void runningRow(float* acc, const float* add, const float* sub, float scale, float* d, std::size_t n);
+};
@@ -1,99 +1,189 @@
 ﻿#include "PrimitiveRenderer.hpp"
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <iostream>
 #include <stack>
 
+// ------------------------------
+// Wysłanie wierzchołków (rysowanie lub nagranie)
+// ------------------------------
+void PrimitiveRenderer::submit(const sf::Vertex* vertices, std::size_t count, sf::PrimitiveType type) {
+    if (commands) commands->draw(vertices, count, type);
+    else canvas.draw(vertices, count, type);
+
+    if (dirtyRects && count > 0) {
+        sf::Vector2f low = vertices[0].position, high = low;
+        for (std::size_t i = 1; i < count; ++i) {
+            low = { std::min(low.x, vertices[i].position.x), std::min(low.y, vertices[i].position.y) };
+            high = { std::max(high.x, vertices[i].position.x), std::max(high.y, vertices[i].position.y) };
+        }
+        markDirty({ low, high - low });
+    }
+}
+
+void PrimitiveRenderer::markDirty(const sf::FloatRect& bounds) {
+    if (!dirtyRects) return;
+    const int left = static_cast<int>(std::floor(bounds.position.x)) - 1;
+    const int top = static_cast<int>(std::floor(bounds.position.y)) - 1;
+    const int right = static_cast<int>(std::ceil(bounds.position.x + bounds.size.x)) + 1;
+    const int bottom = static_cast<int>(std::ceil(bounds.position.y + bounds.size.y)) + 1;
+    dirtyRects->push_back({ { left, top }, { right - left, bottom - top } });
+}
+
+sf::Vector2u PrimitiveRenderer::getTargetSize() const {
+    return commands ? commands->getTargetSize() : canvas.getSize();
+}
+
+const sf::View& PrimitiveRenderer::getTargetView() const {
+    return commands ? commands->getTargetView() : canvas.getView();
+}
+
 // ------------------------------
 // Rysowanie pojedynczego punktu
 // ------------------------------
 void PrimitiveRenderer::drawPoint(const sf::Vector2f& position, sf::Color color) {
     // Zaokrąglenie pozycji do najbliższej pikselowej
     sf::Vertex vertex{ sf::Vector2f(std::round(position.x), std::round(position.y)), color };
-    canvas.draw(&vertex, 1, sf::PrimitiveType::Points);
+    submit(&vertex, 1, sf::PrimitiveType::Points);
+    stats.draw(1, 1);
 }
 
 // ------------------------------
-// Algorytm wypełniania kolorem (flood fill)
+// Wypełnianie liniami poziomymi (scanline)
 // ------------------------------
-void PrimitiveRenderer::flood_fill(const sf::Vector2f& P, sf::Color fill_color, sf::Color background_color) {
-    sf::Vector2u size = canvas.getSize();
+namespace {
+
+// Wyznacza spójny (4-sąsiedztwo) obszar pikseli spełniających warunek inside
+template <typename Inside>
+std::vector<FillSpan> scanlineFill(const sf::Image& image, const sf::Vector2f& P, Inside inside) {
+    std::vector<FillSpan> spans;
+    const sf::Vector2u size = image.getSize();
     if (P.x < 0 || P.y < 0 || P.x >= size.x || P.y >= size.y)
-        return;
+        return spans;
 
-    sf::Image image = canvas.getTexture().copyToImage();
     const unsigned int width = size.x;
     const unsigned int height = size.y;
+    const std::uint8_t* pixels = image.getPixelsPtr();
+    std::vector<std::uint8_t> visited(static_cast<std::size_t>(width) * height, 0);
+
+    auto test = [&](unsigned int x, unsigned int y) {
+        const std::size_t i = static_cast<std::size_t>(y) * width + x;
+        if (visited[i]) return false;
+        const std::uint8_t* p = pixels + i * 4;
+        return inside(sf::Color(p[0], p[1], p[2], p[3]));
+    };
 
-    sf::Color startColor = image.getPixel(sf::Vector2u{ (unsigned int)P.x, (unsigned int)P.y });
-    if (startColor == fill_color || startColor != background_color)
-        return;
-
-    // Stos do iteracyjnego wypełniania
     std::stack<sf::Vector2u> stack;
     stack.push({ (unsigned int)P.x, (unsigned int)P.y });
 
     while (!stack.empty()) {
         auto p = stack.top();
         stack.pop();
-
-        if (p.x >= width || p.y >= height)
+        if (!test(p.x, p.y))
             continue;
 
-        sf::Color current = image.getPixel(p);
-        if (current == background_color) {
-            image.setPixel(sf::Vector2u{ p.x, p.y }, fill_color);
-
-            // Dodanie sąsiadów do stosu
-            if (p.x > 0) stack.push({ p.x - 1, p.y });
-            if (p.x + 1 < width) stack.push({ p.x + 1, p.y });
-            if (p.y > 0) stack.push({ p.x, p.y - 1 });
-            if (p.y + 1 < height) stack.push({ p.x, p.y + 1 });
+        // Rozszerzenie odcinka w lewo i w prawo
+        unsigned int x0 = p.x, x1 = p.x;
+        while (x0 > 0 && test(x0 - 1, p.y)) --x0;
+        while (x1 + 1 < width && test(x1 + 1, p.y)) ++x1;
+
+        std::uint8_t* row = visited.data() + static_cast<std::size_t>(p.y) * width;
+        std::fill(row + x0, row + x1 + 1, std::uint8_t(1));
+        spans.push_back({ p.y, x0, x1 });
+
+        // Jeden punkt startowy na każdy ciągły fragment sąsiednich wierszy
+        for (int dy : { -1, 1 }) {
+            if ((dy < 0 && p.y == 0) || (dy > 0 && p.y + 1 >= height))
+                continue;
+            unsigned int ny = p.y + dy;
+            bool inRun = false;
+            for (unsigned int x = x0; x <= x1; ++x) {
+                bool ok = test(x, ny);
+                if (ok && !inRun) stack.push({ x, ny });
+                inRun = ok;
+            }
         }
     }
+    return spans;
+}
+
+} // namespace
+
+std::vector<FillSpan> PrimitiveRenderer::floodFillSpans(const sf::Image& image, const sf::Vector2f& P, sf::Color fill_color, sf::Color background_color) {
+    if (fill_color == background_color)
+        return {};
+    return scanlineFill(image, P, [&](sf::Color c) { return c == background_color; });
+}
 
-    // Aktualizacja tekstury i rysowanie
-    sf::Texture newTexture;
-    newTexture.loadFromImage(image);
-    sf::Sprite sprite(newTexture);
-    canvas.draw(sprite);
+std::vector<FillSpan> PrimitiveRenderer::boundryFillSpans(const sf::Image& image, const sf::Vector2f& P, sf::Color fill_color, sf::Color boundry_color) {
+    return scanlineFill(image, P, [&](sf::Color c) { return c != boundry_color && c != fill_color; });
 }
 
 // ------------------------------
-// Algorytm wypełniania kolorem z granicą (boundary fill)
+// Rysowanie odcinków wypełnienia
 // ------------------------------
-void PrimitiveRenderer::boundry_fill(const sf::Vector2f& P, sf::Color fill_color, sf::Color boundry_color) {
-    sf::Vector2u size = canvas.getSize();
+void PrimitiveRenderer::drawSpans(const std::vector<FillSpan>& spans, sf::Color color) {
+    if (spans.empty()) return;
+
+    // Każdy odcinek jako prostokąt [x0, x1 + 1) x [y, y + 1) — dwa trójkąty
+    std::vector<sf::Vertex> vertices;
+    vertices.reserve(spans.size() * 6);
+    std::size_t pixels = 0;
+    for (const auto& span : spans) {
+        pixels += span.x1 - span.x0 + 1;
+        const float left = static_cast<float>(span.x0);
+        const float right = static_cast<float>(span.x1 + 1);
+        const float top = static_cast<float>(span.y);
+        const float bottom = top + 1.f;
+        vertices.push_back({ { left, top }, color });
+        vertices.push_back({ { right, top }, color });
+        vertices.push_back({ { right, bottom }, color });
+        vertices.push_back({ { left, top }, color });
+        vertices.push_back({ { right, bottom }, color });
+        vertices.push_back({ { left, bottom }, color });
+    }
+    submit(vertices.data(), vertices.size(), sf::PrimitiveType::Triangles);
+    stats.draw(vertices.size(), pixels);
+}
+
+// ------------------------------
+// Kontrola odczytu kanwy w trybie nagrywania
+// ------------------------------
+bool PrimitiveRenderer::canReadBack() const {
+    if (!commands) return true;
+    // Kanwę rysuje wątek renderujący; odczyt z wątku głównego widziałby
+    // nieaktualną klatkę i ścigałby się z odtwarzaniem listy
+    std::cerr << "[PrimitiveRenderer] Wypełnienie odczytujące kanwę nie jest obsługiwane w trybie nagrywania (użyj RenderContext)" << std::endl;
+    return false;
+}
+
+// ------------------------------
+// Algorytm wypełniania kolorem (flood fill)
+// ------------------------------
+void PrimitiveRenderer::flood_fill(const sf::Vector2f& P, sf::Color fill_color, sf::Color background_color) {
+    sf::Vector2u size = getTargetSize();
     if (P.x < 0 || P.y < 0 || P.x >= size.x || P.y >= size.y)
         return;
+    if (!canReadBack()) return;
 
     sf::Image image = canvas.getTexture().copyToImage();
-    const unsigned int width = size.x;
-    const unsigned int height = size.y;
-
-    std::stack<sf::Vector2u> stack;
-    stack.push({ (unsigned int)P.x, (unsigned int)P.y });
-
-    while (!stack.empty()) {
-        auto p = stack.top();
-        stack.pop();
-
-        if (p.x >= width || p.y >= height)
-            continue;
-
-        sf::Color current = image.getPixel(p);
-        if (current != boundry_color && current != fill_color) {
-            image.setPixel(sf::Vector2u{ p.x, p.y }, fill_color);
+    stats.readback(size);
+    drawSpans(floodFillSpans(image, P, fill_color, background_color), fill_color);
+}
 
-            if (p.x > 0) stack.push({ p.x - 1, p.y });
-            if (p.x + 1 < width) stack.push({ p.x + 1, p.y });
-            if (p.y > 0) stack.push({ p.x, p.y - 1 });
-            if (p.y + 1 < height) stack.push({ p.x, p.y + 1 });
-        }
-    }
+// ------------------------------
+// Algorytm wypełniania kolorem z granicą (boundary fill)
+// ------------------------------
+void PrimitiveRenderer::boundry_fill(const sf::Vector2f& P, sf::Color fill_color, sf::Color boundry_color) {
+    sf::Vector2u size = getTargetSize();
+    if (P.x < 0 || P.y < 0 || P.x >= size.x || P.y >= size.y)
+        return;
+    if (!canReadBack()) return;
 
-    sf::Texture newTexture;
-    newTexture.loadFromImage(image);
-    sf::Sprite sprite(newTexture);
-    canvas.draw(sprite);
+    sf::Image image = canvas.getTexture().copyToImage();
+    stats.readback(size);
+    drawSpans(boundryFillSpans(image, P, fill_color, boundry_color), fill_color);
 }
 
 // ------------------------------
@@ -129,64 +219,228 @@ void PrimitiveRenderer::drawLineDom(const sf::Vector2f& start, const sf::Vector2
         sf::Vertex{start, color},
         sf::Vertex{end, color}
     };
-    canvas.draw(line, 2, sf::PrimitiveType::Lines);
+    submit(line, 2, sf::PrimitiveType::Lines);
+    stats.draw(2, static_cast<std::size_t>(std::max(std::abs(end.x - start.x), std::abs(end.y - start.y))) + 1);
+}
+
+// ------------------------------
+// Wypełnianie analityczne
+// ------------------------------
+namespace {
+
+// Prostokąt [x, x + w) x [y, y + 1) jako dwa trójkąty
+void pushRow(std::vector<sf::Vertex>& out, float x, float y, float w, sf::Color color) {
+    out.push_back({ { x, y }, color });
+    out.push_back({ { x + w, y }, color });
+    out.push_back({ { x + w, y + 1.f }, color });
+    out.push_back({ { x, y }, color });
+    out.push_back({ { x + w, y + 1.f }, color });
+    out.push_back({ { x, y + 1.f }, color });
+}
+
+// Przedziały elipsy (rx + offset, ry + offset) w wierszu y
+int ellipseRows(sf::Vector2f c, float rx, float ry, float y, float offset, RowInterval* out) {
+    rx += offset;
+    ry += offset;
+    const float dy = y - c.y;
+    if (rx <= 0.f || ry <= 0.f || std::abs(dy) >= ry) return 0;
+    const float dx = rx * std::sqrt(1.f - (dy / ry) * (dy / ry));
+    out[0] = { c.x - dx, c.x + dx };
+    return 1;
+}
+
+// Przybliżona odległość od elipsy ze znakiem (dokładna dla koła)
+float ellipseDistance(sf::Vector2f c, float rx, float ry, sf::Vector2f p) {
+    const sf::Vector2f d = p - c;
+    if (rx == ry) return std::sqrt(d.x * d.x + d.y * d.y) - rx;
+    const float k0 = std::sqrt((d.x / rx) * (d.x / rx) + (d.y / ry) * (d.y / ry));
+    const float k1 = std::sqrt((d.x / (rx * rx)) * (d.x / (rx * rx)) + (d.y / (ry * ry)) * (d.y / (ry * ry)));
+    return k1 > 0.f ? k0 * (k0 - 1.f) / k1 : -std::min(rx, ry);
+}
+
+} // namespace
+
+template <typename Rows, typename Distance>
+void PrimitiveRenderer::fillAnalytic(float top, float bottom, Rows rows, Distance distance, sf::Color color, bool antialias) {
+    const sf::Vector2u size = getTargetSize();
+    const int y0 = std::max(0, static_cast<int>(std::floor(top)) - 1);
+    const int y1 = std::min(static_cast<int>(size.y) - 1, static_cast<int>(std::ceil(bottom)) + 1);
+    const int maxX = static_cast<int>(size.x) - 1;
+    if (y0 > y1 || maxX < 0) return;
+
+    // Piksele, których środek leży w przedziale [left, right], przycięte do kanwy
+    auto pixelRange = [maxX](const RowInterval& in, int& x0, int& x1) {
+        x0 = std::max(0, static_cast<int>(std::ceil(in.left - 0.5f)));
+        x1 = std::min(maxX, static_cast<int>(std::floor(in.right - 0.5f)));
+        return x0 <= x1;
+    };
+
+    std::vector<sf::Vertex> vertices;
+    std::size_t pixels = 0;
+    RowInterval inner[2], outer[2];
+    for (int y = y0; y <= y1; ++y) {
+        const float cy = y + 0.5f;
+        const float fy = static_cast<float>(y);
+
+        if (!antialias) {
+            int count = rows(cy, 0.f, outer);
+            for (int i = 0; i < count; ++i) {
+                int x0, x1;
+                if (!pixelRange(outer[i], x0, x1)) continue;
+                pushRow(vertices, static_cast<float>(x0), fy, static_cast<float>(x1 - x0 + 1), color);
+                pixels += x1 - x0 + 1;
+            }
+            continue;
+        }
+
+        // Wnętrze kształtu pomniejszonego o piksel jest w pełni pokryte;
+        // pokrycie liczone jest tylko w pasie do kształtu powiększonego o piksel
+        int innerCount = rows(cy, -1.f, inner);
+        int outerCount = rows(cy, 1.f, outer);
+        int solid0[2], solid1[2];
+        for (int j = 0; j < innerCount; ++j)
+            if (!pixelRange(inner[j], solid0[j], solid1[j])) solid1[j] = -1;
+
+        for (int i = 0; i < outerCount; ++i) {
+            int x0, x1;
+            if (!pixelRange(outer[i], x0, x1)) continue;
+            for (int x = x0; x <= x1;) {
+                int solidEnd = -1;
+                for (int j = 0; j < innerCount; ++j)
+                    if (x >= solid0[j] && x <= solid1[j]) solidEnd = solid1[j];
+
+                if (solidEnd >= x) {
+                    const int end = std::min(solidEnd, x1);
+                    pushRow(vertices, static_cast<float>(x), fy, static_cast<float>(end - x + 1), color);
+                    pixels += end - x + 1;
+                    x = end + 1;
+                    continue;
+                }
+
+                const float coverage = std::clamp(0.5f - distance(sf::Vector2f(x + 0.5f, cy)), 0.f, 1.f);
+                const auto alpha = static_cast<std::uint8_t>(color.a * coverage + 0.5f);
+                if (alpha > 0) {
+                    pushRow(vertices, static_cast<float>(x), fy, 1.f, sf::Color(color.r, color.g, color.b, alpha));
+                    ++pixels;
+                }
+                ++x;
+            }
+        }
+    }
+
+    if (vertices.empty()) return;
+    submit(vertices.data(), vertices.size(), sf::PrimitiveType::Triangles);
+    stats.draw(vertices.size(), pixels);
+}
+
+void PrimitiveRenderer::drawFilledCircle(const sf::Vector2f& center, float R, sf::Color color, bool antialias) {
+    drawFilledEllipse(center, R, R, color, antialias);
+}
+
+void PrimitiveRenderer::drawFilledEllipse(const sf::Vector2f& center, float Rx, float Ry, sf::Color color, bool antialias) {
+    if (Rx <= 0.f || Ry <= 0.f) return;
+    fillAnalytic(center.y - Ry, center.y + Ry,
+        [&](float y, float offset, RowInterval* out) { return ellipseRows(center, Rx, Ry, y, offset, out); },
+        [&](sf::Vector2f p) { return ellipseDistance(center, Rx, Ry, p); },
+        color, antialias);
+}
+
+void PrimitiveRenderer::drawRing(const sf::Vector2f& center, float outerR, float innerR, sf::Color color, bool antialias) {
+    drawEllipseRing(center, outerR, outerR, outerR - innerR, color, antialias);
+}
+
+void PrimitiveRenderer::drawEllipseRing(const sf::Vector2f& center, float Rx, float Ry, float thickness, sf::Color color, bool antialias) {
+    if (Rx <= 0.f || Ry <= 0.f || thickness <= 0.f) return;
+    const float innerRx = Rx - thickness, innerRy = Ry - thickness;
+    if (innerRx <= 0.f || innerRy <= 0.f) {
+        drawFilledEllipse(center, Rx, Ry, color, antialias);
+        return;
+    }
+    fillAnalytic(center.y - Ry, center.y + Ry,
+        [&](float y, float offset, RowInterval* out) {
+            RowInterval hole;
+            if (!ellipseRows(center, Rx, Ry, y, offset, out)) return 0;
+            if (!ellipseRows(center, innerRx, innerRy, y, -offset, &hole)) return 1;
+            // Otwór dzieli wiersz na dwa przedziały
+            out[1] = { hole.right, out[0].right };
+            out[0].right = hole.left;
+            return 2;
+        },
+        [&](sf::Vector2f p) {
+            return std::max(ellipseDistance(center, Rx, Ry, p), -ellipseDistance(center, innerRx, innerRy, p));
+        },
+        color, antialias);
+}
+
+void PrimitiveRenderer::drawFilledRoundedRect(const sf::Vector2f& position, const sf::Vector2f& size, float radius, sf::Color color, bool antialias) {
+    if (size.x <= 0.f || size.y <= 0.f) return;
+    radius = std::clamp(radius, 0.f, std::min(size.x, size.y) / 2.f);
+    const sf::Vector2f half = size / 2.f;
+    const sf::Vector2f center = position + half;
+
+    fillAnalytic(position.y, position.y + size.y,
+        [&](float y, float offset, RowInterval* out) {
+            // Przesunięcie o offset: boki dalej o offset, promień narożników r + offset
+            const float r = radius + offset;
+            const float top = position.y - offset, bottom = position.y + size.y + offset;
+            const float left = position.x - offset, right = position.x + size.x + offset;
+            if (y <= top || y >= bottom || left >= right) return 0;
+
+            float inset = 0.f;
+            const float dy = std::max(top + r - y, y - (bottom - r));
+            if (r > 0.f && dy > 0.f)
+                inset = r - std::sqrt(std::max(0.f, r * r - dy * dy));
+            if (left + inset >= right - inset) return 0;
+            out[0] = { left + inset, right - inset };
+            return 1;
+        },
+        [&](sf::Vector2f p) {
+            const float qx = std::abs(p.x - center.x) - (half.x - radius);
+            const float qy = std::abs(p.y - center.y) - (half.y - radius);
+            return std::hypot(std::max(qx, 0.f), std::max(qy, 0.f)) + std::min(std::max(qx, qy), 0.f) - radius;
+        },
+        color, antialias);
 }
 
 // ------------------------------
 // Rysowanie okręgu i wypełnienie
 // ------------------------------
 void PrimitiveRenderer::drawCircle(const sf::Vector2f& pos, float R, sf::Color color, sf::Color fill) {
-    float a = 0;
-    while (a <= 45) { // Rysowanie okręgu w 8 symetrycznych ćwiartkach
-        float cosA = std::cos(a);
-        float sinA = std::sin(a);
-
-        drawPoint({ pos.x + R * cosA, pos.y + R * sinA }, color);
-        drawPoint({ pos.x - R * cosA, pos.y + R * sinA }, color);
-        drawPoint({ pos.x + R * cosA, pos.y - R * sinA }, color);
-        drawPoint({ pos.x - R * cosA, pos.y - R * sinA }, color);
-
-        drawPoint({ pos.x + R * sinA, pos.y + R * cosA }, color);
-        drawPoint({ pos.x - R * sinA, pos.y + R * cosA }, color);
-        drawPoint({ pos.x + R * sinA, pos.y - R * cosA }, color);
-        drawPoint({ pos.x - R * sinA, pos.y - R * cosA }, color);
-
-        a += 0.1f;
+    // Wnętrze i kontur wyznaczane analitycznie — bez odczytu kanwy i bez
+    // zależności od kolorów już na niej narysowanych
+    if (fill == color) {
+        drawFilledCircle(pos, R, fill);
+        return;
     }
-    boundry_fill(pos, fill, color); // wypełnienie wnętrza kolorem
+    drawFilledCircle(pos, R - 1.f, fill);
+    drawRing(pos, R, R - 1.f, color);
 }
 
 // ------------------------------
 // Rysowanie elipsy i wypełnienie
 // ------------------------------
 void PrimitiveRenderer::drawElips(const sf::Vector2f& pos, float Rx, float Ry, sf::Color color, sf::Color fill) {
-    float a = 0;
-    while (a <= 45) { // Rysowanie w 8 symetrycznych ćwiartkach
-        float cosA = std::cos(a);
-        float sinA = std::sin(a);
-
-        drawPoint({ pos.x + Rx * cosA, pos.y + Ry * sinA }, color);
-        drawPoint({ pos.x - Rx * cosA, pos.y + Ry * sinA }, color);
-        drawPoint({ pos.x + Rx * cosA, pos.y - Ry * sinA }, color);
-        drawPoint({ pos.x - Rx * cosA, pos.y - Ry * sinA }, color);
-
-        drawPoint({ pos.x + Rx * sinA, pos.y + Ry * cosA }, color);
-        drawPoint({ pos.x - Rx * sinA, pos.y + Ry * cosA }, color);
-        drawPoint({ pos.x + Rx * sinA, pos.y - Ry * cosA }, color);
-        drawPoint({ pos.x - Rx * sinA, pos.y - Ry * cosA }, color);
-
-        a += 0.1f;
+    // Jak w drawCircle: wnętrze i kontur rozłączne, więc półprzezroczyste
+    // wypełnienie nie miesza się z konturem
+    if (fill == color) {
+        drawFilledEllipse(pos, Rx, Ry, fill);
+        return;
     }
-    boundry_fill(pos, fill, color); // wypełnienie wnętrza elipsy
+    drawFilledEllipse(pos, Rx - 1.f, Ry - 1.f, fill);
+    drawEllipseRing(pos, Rx, Ry, 1.f, color);
 }
 
 // ------------------------------
 // Rysowanie łamanej (polilinii)
 // ------------------------------
 void PrimitiveRenderer::drawPolyline(const std::vector<sf::Vector2f>& points, sf::Color color) {
-    if (points.size() < 2) return;
+    drawPolyline(points.data(), points.size(), color);
+}
+
+void PrimitiveRenderer::drawPolyline(const sf::Vector2f* points, std::size_t count, sf::Color color) {
+    if (count < 2) return;
 
-    for (size_t i = 0; i < points.size() - 1; ++i) {
+    for (size_t i = 0; i < count - 1; ++i) {
         drawLine(points[i], points[i + 1], color);
     }
 }
@@ -195,8 +449,24 @@ void PrimitiveRenderer::drawPolyline(const std::vector<sf::Vector2f>& points, sf
 // Rysowanie poligonu (zamkniętej łamanej)
 // ------------------------------
 void PrimitiveRenderer::drawPolygon(const std::vector<sf::Vector2f>& points, sf::Color color) {
-    if (points.size() < 2) return;
+    drawPolygon(points.data(), points.size(), color);
+}
+
+void PrimitiveRenderer::drawPolygon(const sf::Vector2f* points, std::size_t count, sf::Color color) {
+    if (count < 2) return;
+
+    drawPolyline(points, count, color);                  // rysowanie kolejnych segmentów
+    drawLine(points[count - 1], points[0], color);       // zamknięcie poligonu
+}
 
-    drawPolyline(points, color);              // rysowanie kolejnych segmentów
-    drawLine(points.back(), points.front(), color); // zamknięcie poligonu
+// ------------------------------
+// Rysowanie sprite'a
+// ------------------------------
+void PrimitiveRenderer::drawSprite(const sf::Sprite& sprite, const sf::RenderStates& states,
+    std::shared_ptr<const sf::Texture> texture) {
+    if (commands) commands->drawSprite(sprite, states, std::move(texture));
+    else canvas.draw(sprite, states);
+    const sf::FloatRect bounds = states.transform.transformRect(sprite.getGlobalBounds());
+    markDirty(bounds);
+    stats.draw(4, static_cast<std::size_t>(std::max(0.f, bounds.size.x) * std::max(0.f, bounds.size.y)));
 }
@@ -1,7 +1,29 @@
 ﻿#pragma once
 #include <SFML/Graphics.hpp>
+#include "RenderStats.hpp"
+#include "RenderCommandList.hpp"
+#include <memory>
 #include <vector>
 
+/**
+ * @struct FillSpan
+ * @brief Poziomy odcinek pikseli [x0, x1] w wierszu y, wynik wypełniania.
+ */
+struct FillSpan {
+    unsigned int y;  ///< Wiersz.
+    unsigned int x0; ///< Pierwsza kolumna (włącznie).
+    unsigned int x1; ///< Ostatnia kolumna (włącznie).
+};
+
+/**
+ * @struct RowInterval
+ * @brief Przedział [left, right] wnętrza kształtu w jednym wierszu (współrzędne ciągłe).
+ */
+struct RowInterval {
+    float left;  ///< Lewa krawędź.
+    float right; ///< Prawa krawędź.
+};
+
 /**
  * @class PrimitiveRenderer
  * @brief Klasa odpowiedzialna za rysowanie prymitywów 2D na sf::RenderTexture.
@@ -10,12 +32,62 @@
  * - punktów,
  * - linii (DDA i domyślną),
  * - okręgów i elips,
+ * - wypełnionych okręgów, elips, pierścieni i zaokrąglonych prostokątów
+ *   (odcinki wyznaczane analitycznie, opcjonalne wygładzanie krawędzi),
  * - łamanych otwartych i zamkniętych,
  * - wypełnień metodą flood fill i boundary fill.
+ *
+ * Każde wywołanie draw i odczyt kanwy jest zliczany w RenderStats.
+ * Renderer utworzony z RenderCommandList nagrywa rysowanie zamiast je
+ * wykonywać. Wypełnienia odczytujące kanwę (flood_fill, boundry_fill) są
+ * wtedy odrzucane — kanwę rysuje wątek renderujący; wypełnienia odroczone
+ * rozwiązuje RenderContext::flush.
  */
 class PrimitiveRenderer {
 private:
     sf::RenderTexture& canvas; ///< Referencja do tekstury, na której rysujemy.
+    RenderStats stats;         ///< Liczniki pracy GPU od utworzenia lub resetStats().
+    RenderCommandList* commands = nullptr; ///< Lista nagrywania (nullptr = rysowanie na canvas).
+    std::vector<sf::IntRect>* dirtyRects = nullptr; ///< Obszary zmienione przez rysowanie (nullptr = bez zapisu).
+
+    /**
+     * @brief Dopisuje obszar rysowania do listy zmienionych obszarów (jeśli włączona).
+     * @param bounds Obszar we współrzędnych widoku kanwy.
+     */
+    void markDirty(const sf::FloatRect& bounds);
+
+    /**
+     * @brief Sprawdza, czy wypełnienie może odczytać kanwę (nie w trybie nagrywania).
+     * @return true, gdy odczyt jest dozwolony.
+     */
+    bool canReadBack() const;
+
+    /**
+     * @brief Rysuje wierzchołki na kanwie lub dopisuje je do listy nagrywania.
+     * @param vertices Wierzchołki.
+     * @param count Liczba wierzchołków.
+     * @param type Typ prymitywu.
+     */
+    void submit(const sf::Vertex* vertices, std::size_t count, sf::PrimitiveType type);
+
+    /**
+     * @brief Wypełnia kształt odcinkami wyznaczonymi analitycznie dla każdego wiersza.
+     *
+     * rows(y, offset, out) zapisuje do out (maks. 2) przedziały wnętrza
+     * kształtu przesuniętego o offset pikseli na zewnątrz w wierszu o środku y
+     * i zwraca ich liczbę. distance(p) to odległość ze znakiem od krawędzi
+     * (ujemna wewnątrz) — używana tylko dla pikseli brzegowych przy wygładzaniu.
+     * Całość rysowana jest jednym wywołaniem draw, bez odczytu kanwy.
+     *
+     * @param top Górna krawędź kształtu.
+     * @param bottom Dolna krawędź kształtu.
+     * @param rows Przedziały wiersza.
+     * @param distance Odległość ze znakiem.
+     * @param color Kolor.
+     * @param antialias Czy wygładzać krawędzie (pokrycie jako przezroczystość).
+     */
+    template <typename Rows, typename Distance>
+    void fillAnalytic(float top, float bottom, Rows rows, Distance distance, sf::Color color, bool antialias);
 
 public:
     /**
@@ -26,6 +98,15 @@ public:
         : canvas(canvas) {
     }
 
+    /**
+     * @brief Konstruktor renderera nagrywającego.
+     * @param canvas Kanwa (tylko dla wypełnień, które odczytują piksele).
+     * @param commands Lista, do której trafia rysowanie.
+     */
+    PrimitiveRenderer(sf::RenderTexture& canvas, RenderCommandList& commands)
+        : canvas(canvas), commands(&commands) {
+    }
+
     /**
      * @brief Rysuje pojedynczy punkt.
      * @param position Pozycja punktu.
@@ -49,6 +130,33 @@ public:
      */
     void boundry_fill(const sf::Vector2f& P, sf::Color fill_color, sf::Color boundry_color);
 
+    /**
+     * @brief Wyznacza obszar flood fill jako listę poziomych odcinków (bez rysowania).
+     * @param image Obraz, na którym wyznaczany jest obszar.
+     * @param P Punkt startowy wypełnienia.
+     * @param fill_color Kolor wypełnienia.
+     * @param background_color Kolor tła, który ma zostać zastąpiony.
+     * @return Odcinki tworzące wypełniany obszar (pusta lista, gdy nie ma czego wypełniać).
+     */
+    static std::vector<FillSpan> floodFillSpans(const sf::Image& image, const sf::Vector2f& P, sf::Color fill_color, sf::Color background_color);
+
+    /**
+     * @brief Wyznacza obszar boundary fill jako listę poziomych odcinków (bez rysowania).
+     * @param image Obraz, na którym wyznaczany jest obszar.
+     * @param P Punkt startowy wypełnienia.
+     * @param fill_color Kolor wypełnienia.
+     * @param boundry_color Kolor granicy.
+     * @return Odcinki tworzące wypełniany obszar.
+     */
+    static std::vector<FillSpan> boundryFillSpans(const sf::Image& image, const sf::Vector2f& P, sf::Color fill_color, sf::Color boundry_color);
+
+    /**
+     * @brief Rysuje listę odcinków jednym wywołaniem draw.
+     * @param spans Odcinki do zamalowania.
+     * @param color Kolor odcinków.
+     */
+    void drawSpans(const std::vector<FillSpan>& spans, sf::Color color);
+
     /**
      * @brief Rysuje linię metodą przyrostową (DDA).
      * @param start Punkt początkowy.
@@ -66,7 +174,7 @@ public:
     void drawLineDom(const sf::Vector2f& start, const sf::Vector2f& end, sf::Color color);
 
     /**
-     * @brief Rysuje okrąg i wypełnia go kolorem.
+     * @brief Rysuje okrąg (kontur o grubości 1 piksela) wypełniony kolorem.
      * @param pos Środek okręgu.
      * @param R Promień okręgu.
      * @param color Kolor konturu.
@@ -75,7 +183,7 @@ public:
     void drawCircle(const sf::Vector2f& pos, const float R, sf::Color color, sf::Color fill);
 
     /**
-     * @brief Rysuje elipsę i wypełnia ją kolorem.
+     * @brief Rysuje elipsę (kontur o grubości 1 piksela) wypełnioną kolorem.
      * @param pos Środek elipsy.
      * @param Rx Promień w osi X.
      * @param Ry Promień w osi Y.
@@ -84,6 +192,56 @@ public:
      */
     void drawElips(const sf::Vector2f& pos, const float Rx, const float Ry, sf::Color color, sf::Color fill);
 
+    /**
+     * @brief Rysuje wypełnione koło.
+     * @param center Środek.
+     * @param R Promień.
+     * @param color Kolor.
+     * @param antialias Czy wygładzać krawędź.
+     */
+    void drawFilledCircle(const sf::Vector2f& center, float R, sf::Color color, bool antialias = false);
+
+    /**
+     * @brief Rysuje wypełnioną elipsę.
+     * @param center Środek.
+     * @param Rx Promień w osi X.
+     * @param Ry Promień w osi Y.
+     * @param color Kolor.
+     * @param antialias Czy wygładzać krawędź.
+     */
+    void drawFilledEllipse(const sf::Vector2f& center, float Rx, float Ry, sf::Color color, bool antialias = false);
+
+    /**
+     * @brief Rysuje pierścień (koło z otworem).
+     * @param center Środek.
+     * @param outerR Promień zewnętrzny.
+     * @param innerR Promień otworu.
+     * @param color Kolor.
+     * @param antialias Czy wygładzać krawędzie.
+     */
+    void drawRing(const sf::Vector2f& center, float outerR, float innerR, sf::Color color, bool antialias = false);
+
+    /**
+     * @brief Rysuje pierścień eliptyczny (elipsa z otworem mniejszym o grubość).
+     * @param center Środek.
+     * @param Rx Zewnętrzny promień w osi X.
+     * @param Ry Zewnętrzny promień w osi Y.
+     * @param thickness Grubość pierścienia.
+     * @param color Kolor.
+     * @param antialias Czy wygładzać krawędzie.
+     */
+    void drawEllipseRing(const sf::Vector2f& center, float Rx, float Ry, float thickness, sf::Color color, bool antialias = false);
+
+    /**
+     * @brief Rysuje wypełniony prostokąt o zaokrąglonych narożnikach.
+     * @param position Lewy górny róg.
+     * @param size Rozmiar.
+     * @param radius Promień narożników (ograniczany do połowy krótszego boku).
+     * @param color Kolor.
+     * @param antialias Czy wygładzać krawędzie.
+     */
+    void drawFilledRoundedRect(const sf::Vector2f& position, const sf::Vector2f& size, float radius, sf::Color color, bool antialias = false);
+
     /**
      * @brief Rysuje łamaną otwartą z podanych punktów.
      * @param points Wektor punktów łamanej.
@@ -91,6 +249,14 @@ public:
      */
     void drawPolyline(const std::vector<sf::Vector2f>& points, sf::Color color);
 
+    /**
+     * @brief Rysuje łamaną otwartą z tablicy punktów (np. z FrameArena).
+     * @param points Wskaźnik na pierwszy punkt.
+     * @param count Liczba punktów.
+     * @param color Kolor łamanej.
+     */
+    void drawPolyline(const sf::Vector2f* points, std::size_t count, sf::Color color);
+
     /**
      * @brief Rysuje łamaną zamkniętą (poligon).
      * @param points Wektor punktów poligonu.
@@ -98,6 +264,58 @@ public:
      */
     void drawPolygon(const std::vector<sf::Vector2f>& points, sf::Color color);
 
+    /**
+     * @brief Rysuje łamaną zamkniętą z tablicy punktów (np. z FrameArena).
+     * @param points Wskaźnik na pierwszy punkt.
+     * @param count Liczba punktów.
+     * @param color Kolor poligonu.
+     */
+    void drawPolygon(const sf::Vector2f* points, std::size_t count, sf::Color color);
+
+    /**
+     * @brief Rysuje sprite (z licznikiem wywołań i pikseli).
+     * @param sprite Sprite.
+     * @param states Stany renderowania (np. macierz świata).
+     * @param texture Uchwyt tekstury sprite'a — lista poleceń utrzymuje go do końca
+     *                odtworzenia (nullptr, gdy czas życia tekstury zapewnia wywołujący).
+     */
+    void drawSprite(const sf::Sprite& sprite, const sf::RenderStates& states = sf::RenderStates::Default,
+        std::shared_ptr<const sf::Texture> texture = nullptr);
+
+    /**
+     * @brief Zwraca liczniki pracy GPU.
+     * @return Liczniki.
+     */
+    const RenderStats& getStats() const { return stats; }
+
+    /**
+     * @brief Zeruje liczniki pracy GPU.
+     */
+    void resetStats() { stats.reset(); }
+
+    /**
+     * @brief Włącza zapis obszarów zmienianych przez rysowanie.
+     *
+     * Każde rysowanie dopisuje prostokąt obejmujący wierzchołki (z marginesem
+     * piksela na reguły rasteryzacji) we współrzędnych widoku kanwy — przy
+     * domyślnym widoku są to piksele kanwy.
+     *
+     * @param rects Lista docelowa (nullptr = wyłączenie).
+     */
+    void trackDirtyRects(std::vector<sf::IntRect>* rects) { dirtyRects = rects; }
+
+    /**
+     * @brief Zwraca rozmiar celu rysowania (kanwy lub celu nagrania).
+     * @return Rozmiar w pikselach.
+     */
+    sf::Vector2u getTargetSize() const;
+
+    /**
+     * @brief Zwraca widok celu rysowania (kanwy lub celu nagrania).
+     * @return Widok.
+     */
+    const sf::View& getTargetView() const;
+
     /**
      * @brief Zwraca referencję do tekstury renderującej.
      * @return Referencja do sf::RenderTexture.
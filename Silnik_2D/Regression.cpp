@@ -0,0 +1,307 @@
+﻿#include "Regression.hpp"
+#include "RenderContext.hpp"
+#include <SFML/OpenGL.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+namespace {
+constexpr unsigned int SceneSeed = 2024;   ///< Stałe ziarno scen testowych.
+const char* const TimingsFile = "timings.txt";
+
+const char* statusName(RegressionStatus status) {
+    switch (status) {
+    case RegressionStatus::Passed:        return "PASS";
+    case RegressionStatus::Updated:       return "UPDATED";
+    case RegressionStatus::MissingGolden: return "MISSING";
+    case RegressionStatus::ImageMismatch: return "IMAGE MISMATCH";
+    default:                              return "SLOWER";
+    }
+}
+
+// Prostokąt z białą ramką (obszar do wypełnienia)
+void drawFrame(sf::RenderTexture& canvas, sf::Vector2f origin, float side) {
+    sf::RectangleShape frame({ side - 2.f, side - 2.f });
+    frame.setPosition(origin + sf::Vector2f(1.f, 1.f));
+    frame.setFillColor(sf::Color::Black);
+    frame.setOutlineColor(sf::Color::White);
+    frame.setOutlineThickness(1.f);
+    canvas.draw(frame);
+}
+} // namespace
+
+// ------------------------------
+// Konstruktor i przypadki domyślne
+// ------------------------------
+RegressionSuite::RegressionSuite(const std::string& directory, const RegressionOptions& options, sf::Vector2u canvasSize)
+    : canvas(canvasSize), directory(directory), options(options)
+{
+    addDefaultCases();
+    addDefaultChecks();
+}
+
+void RegressionSuite::addDefaultCases() {
+    const sf::Vector2f size(canvas.getSize());
+    const sf::Vector2f center = size / 2.f;
+    auto clear = [](sf::RenderTexture& target) { target.clear(sf::Color::Black); };
+
+    add({ "points", clear, [size](PrimitiveRenderer& renderer) {
+        std::mt19937 rng(SceneSeed);
+        std::uniform_real_distribution<float> x(0.f, size.x), y(0.f, size.y);
+        for (int i = 0; i < 5000; ++i) renderer.drawPoint({ x(rng), y(rng) }, sf::Color::White);
+    } });
+
+    // Wachlarz odcinków o wszystkich nachyleniach
+    for (bool incremental : { true, false }) {
+        add({ incremental ? "lines_incremental" : "lines_default", clear, [center, incremental](PrimitiveRenderer& renderer) {
+            for (int deg = 0; deg < 360; deg += 5) {
+                const float rad = deg * 3.14159265f / 180.f;
+                const sf::Vector2f end = center + sf::Vector2f(std::cos(rad), std::sin(rad)) * 200.f;
+                if (incremental) renderer.drawLine(center, end, sf::Color::Cyan);
+                else renderer.drawLineDom(center, end, sf::Color::Cyan);
+            }
+        } });
+    }
+
+    add({ "polylines", clear, [size](PrimitiveRenderer& renderer) {
+        std::mt19937 rng(SceneSeed);
+        std::uniform_real_distribution<float> x(0.f, size.x), y(0.f, size.y);
+        std::vector<sf::Vector2f> points(64);
+        for (auto& p : points) p = { x(rng), y(rng) };
+        renderer.drawPolyline(points, sf::Color::Magenta);
+        renderer.drawPolygon(points.data(), 8, sf::Color::Yellow);
+    } });
+
+    add({ "circles", clear, [](PrimitiveRenderer& renderer) {
+        renderer.drawCircle({ 60.f, 60.f }, 8.f, sf::Color::Green, sf::Color::Green);
+        renderer.drawCircle({ 140.f, 100.f }, 40.f, sf::Color::Green, sf::Color::Blue);
+        renderer.drawCircle({ 330.f, 330.f }, 150.f, sf::Color::Green, sf::Color::Green);
+    } });
+
+    add({ "ellipses", clear, [](PrimitiveRenderer& renderer) {
+        renderer.drawElips({ 130.f, 100.f }, 100.f, 50.f, sf::Color::Red, sf::Color::Red);
+        renderer.drawElips({ 330.f, 330.f }, 60.f, 150.f, sf::Color::Red, sf::Color::Yellow);
+    } });
+
+    // Kształty wypełniane analitycznie, z wygładzaniem krawędzi i bez
+    for (bool antialias : { false, true }) {
+        add({ antialias ? "filled_shapes_aa" : "filled_shapes", clear, [antialias](PrimitiveRenderer& renderer) {
+            renderer.drawFilledCircle({ 100.3f, 100.7f }, 70.f, sf::Color::Green, antialias);
+            renderer.drawFilledEllipse({ 360.f, 110.f }, 120.f, 45.f, sf::Color::Red, antialias);
+            renderer.drawRing({ 130.f, 360.f }, 100.f, 60.f, sf::Color::Cyan, antialias);
+            renderer.drawFilledRoundedRect({ 270.f, 250.f }, { 200.f, 220.f }, 30.f, sf::Color::Yellow, antialias);
+        } });
+    }
+
+    // "Grzebień" — kręty obszar wymuszający wiele odcinków wypełnienia
+    const float side = std::min(size.x, size.y) - 32.f;
+    const sf::Vector2f origin = center - sf::Vector2f(side / 2.f, side / 2.f);
+    auto comb = [origin, side](sf::RenderTexture& target) {
+        target.clear(sf::Color::Black);
+        drawFrame(target, origin, side);
+        for (float x = 8.f; x < side - 8.f; x += 8.f) {
+            bool fromTop = static_cast<int>(x / 8.f) % 2 == 0;
+            sf::RectangleShape wall({ 1.f, side - 8.f });
+            wall.setPosition(origin + sf::Vector2f(x, fromTop ? 0.f : 8.f));
+            wall.setFillColor(sf::Color::White);
+            target.draw(wall);
+        }
+        target.display();
+    };
+    auto rect = [origin, side](sf::RenderTexture& target) {
+        target.clear(sf::Color::Black);
+        drawFrame(target, origin, side);
+        target.display();
+    };
+    const sf::Vector2f seed = origin + sf::Vector2f(4.f, 4.f);
+
+    add({ "flood_fill_rect", rect, [seed](PrimitiveRenderer& renderer) { renderer.flood_fill(seed, sf::Color::Blue, sf::Color::Black); } });
+    add({ "flood_fill_comb", comb, [seed](PrimitiveRenderer& renderer) { renderer.flood_fill(seed, sf::Color::Blue, sf::Color::Black); } });
+    add({ "boundry_fill_comb", comb, [seed](PrimitiveRenderer& renderer) { renderer.boundry_fill(seed, sf::Color::Blue, sf::Color::White); } });
+}
+
+void RegressionSuite::addDefaultChecks() {
+    // Trafienie FillCache po odczycie kanwy, a po nim zależne chybienie w tym samym flush():
+    // chybienie musi widzieć odcinki trafienia. Ściana dzieli kanwę na lewą i prawą część.
+    addCheck({ "fill_cache_hit_then_miss", [] {
+        RenderContext context({ 64, 32 });
+        context.enableHistory(1 << 20);
+        const sf::Vector2f left(10.f, 10.f), wall(32.f, 10.f);
+
+        context.execute(DrawCommand::line({ 32.f, -4.f }, { 32.f, 36.f }));
+        context.flush();
+        context.execute(DrawCommand::fill(left, sf::Color::Blue)); // zapamiętane dla wersji ze ścianą
+        context.flush();
+        context.undo(); // wersja ze ścianą wraca — wpis dla lewej części znów pasuje
+
+        context.execute(DrawCommand::fill(wall, sf::Color::Green)); // chybienie bez odcinków: odczyt kanwy
+        context.execute(DrawCommand::fill(left, sf::Color::Blue));  // trafienie
+        context.execute(DrawCommand::fill(left, sf::Color::Red));   // chybienie: lewa część jest już niebieska
+        const sf::Image image = context.capture();
+        return image.getPixel({ 10, 10 }) == sf::Color::Blue && image.getPixel({ 50, 10 }) == sf::Color::Black;
+    } });
+}
+
+// ------------------------------
+// Wykonanie przypadku
+// ------------------------------
+RegressionResult RegressionSuite::runCase(const Case& test) {
+    using clock = std::chrono::steady_clock;
+    RegressionResult result;
+    result.name = test.name;
+
+    // Mediana czasu z kilku powtórzeń; obraz pochodzi z ostatniego
+    std::vector<double> samples;
+    for (int i = 0; i < std::max(1, options.repetitions); ++i) {
+        if (test.setup) test.setup(canvas);
+        PrimitiveRenderer renderer(canvas);
+        glFinish();
+
+        auto start = clock::now();
+        test.draw(renderer);
+        canvas.display();
+        glFinish();
+        samples.push_back(std::chrono::duration<double, std::milli>(clock::now() - start).count());
+        result.stats = renderer.getStats();
+    }
+    std::sort(samples.begin(), samples.end());
+    result.renderMs = samples[samples.size() / 2];
+
+    const sf::Image image = canvas.getTexture().copyToImage();
+    const std::string goldenFile = path(test.name + ".png");
+
+    if (options.update) {
+        if (!image.saveToFile(goldenFile)) {
+            std::cerr << "Nie udało się zapisać wzorca: " << goldenFile << std::endl;
+            result.status = RegressionStatus::MissingGolden;
+            return result;
+        }
+        baselines[test.name] = result.renderMs;
+        result.status = RegressionStatus::Updated;
+        return result;
+    }
+
+    sf::Image golden;
+    if (!golden.loadFromFile(goldenFile)) {
+        result.status = RegressionStatus::MissingGolden;
+        return result;
+    }
+
+    compare(image, golden, result, path(test.name + ".diff.png"));
+    const std::size_t total = static_cast<std::size_t>(image.getSize().x) * image.getSize().y;
+    if (result.diffPixels > total * options.maxDiffFraction) {
+        result.status = RegressionStatus::ImageMismatch;
+        return result;
+    }
+
+    auto baseline = baselines.find(test.name);
+    if (baseline != baselines.end()) {
+        result.baselineMs = baseline->second;
+        if (result.renderMs > result.baselineMs * options.slowdownLimit
+            && result.renderMs - result.baselineMs > options.minSlowdownMs)
+            result.status = RegressionStatus::Slower;
+    }
+    return result;
+}
+
+void RegressionSuite::compare(const sf::Image& image, const sf::Image& golden, RegressionResult& result, const std::string& diffFile) const {
+    const sf::Vector2u size = image.getSize();
+    if (golden.getSize() != size) {
+        result.diffPixels = static_cast<std::size_t>(size.x) * size.y;
+        result.maxChannelDiff = 255;
+        return;
+    }
+
+    const std::uint8_t* a = image.getPixelsPtr();
+    const std::uint8_t* b = golden.getPixelsPtr();
+    const std::size_t count = static_cast<std::size_t>(size.x) * size.y;
+    std::vector<std::uint8_t> diff(count * 4, 0);
+    for (std::size_t i = 0; i < count; ++i) {
+        int worst = 0;
+        for (int ch = 0; ch < 4; ++ch)
+            worst = std::max(worst, std::abs(a[i * 4 + ch] - b[i * 4 + ch]));
+        result.maxChannelDiff = std::max(result.maxChannelDiff, worst);
+        // Obraz różnic: czerwień proporcjonalna do różnicy, wyszarzony wzorzec w tle
+        diff[i * 4] = static_cast<std::uint8_t>(worst > options.channelTolerance ? 255 : b[i * 4] / 4);
+        diff[i * 4 + 1] = static_cast<std::uint8_t>(b[i * 4 + 1] / 4);
+        diff[i * 4 + 2] = static_cast<std::uint8_t>(b[i * 4 + 2] / 4);
+        diff[i * 4 + 3] = 255;
+        if (worst > options.channelTolerance) ++result.diffPixels;
+    }
+
+    if (result.diffPixels > 0) {
+        sf::Image diffImage;
+        diffImage.resize(size, diff.data());
+        if (!diffImage.saveToFile(diffFile))
+            std::cerr << "Nie udało się zapisać obrazu różnic: " << diffFile << std::endl;
+    }
+}
+
+// ------------------------------
+// Uruchomienie i raport
+// ------------------------------
+bool RegressionSuite::run() {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    results.clear();
+    baselines.clear();
+    missing = 0;
+    if (!options.update) loadBaselines();
+
+    bool passed = true;
+    for (const Case& test : cases) {
+        RegressionResult r = runCase(test);
+        // W trybie aktualizacji MissingGolden oznacza nieudany zapis wzorca — to błąd
+        if (r.status == RegressionStatus::MissingGolden && !options.update)
+            ++missing;
+        else if (r.status != RegressionStatus::Passed && r.status != RegressionStatus::Updated)
+            passed = false;
+
+        std::cout << "[Regression] " << r.name << ": " << statusName(r.status)
+            << "  diff " << r.diffPixels << " px (max " << r.maxChannelDiff << ")  "
+            << r.renderMs << " ms";
+        if (r.baselineMs > 0.0) std::cout << " (baseline " << r.baselineMs << " ms)";
+        std::cout << "  draws " << r.stats.drawCalls << ", readbacks " << r.stats.readbacks << "\n";
+        results.push_back(std::move(r));
+    }
+
+    for (const Check& check : checks) {
+        const bool ok = check.run();
+        if (!ok) passed = false;
+        std::cout << "[Regression] " << check.name << ": " << (ok ? "PASS" : "FAIL") << "\n";
+    }
+
+    if (options.update && !saveBaselines()) {
+        std::cerr << "Nie udało się zapisać czasów: " << path(TimingsFile) << std::endl;
+        passed = false;
+    }
+    return passed;
+}
+
+// ------------------------------
+// Pliki wzorców
+// ------------------------------
+std::string RegressionSuite::path(const std::string& file) const {
+    return (std::filesystem::path(directory) / file).string();
+}
+
+void RegressionSuite::loadBaselines() {
+    std::ifstream in(path(TimingsFile));
+    std::string name;
+    double ms = 0.0;
+    while (in >> name >> ms)
+        baselines[name] = ms;
+}
+
+bool RegressionSuite::saveBaselines() const {
+    std::ofstream out(path(TimingsFile));
+    if (!out) return false;
+    for (const auto& entry : baselines)
+        out << entry.first << " " << entry.second << "\n";
+    return static_cast<bool>(out);
+}
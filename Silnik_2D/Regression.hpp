@@ -0,0 +1,168 @@
+﻿#pragma once
+#include <SFML/Graphics.hpp>
+#include "PrimitiveRenderer.hpp"
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @enum RegressionStatus
+ * @brief Wynik porównania przypadku z wzorcem.
+ */
+enum class RegressionStatus {
+    Passed,        ///< Obraz w tolerancji, czas w progu.
+    Updated,       ///< Zapisano nowy wzorzec (tryb aktualizacji).
+    MissingGolden, ///< Brak obrazu wzorcowego.
+    ImageMismatch, ///< Zbyt wiele różniących się pikseli.
+    Slower         ///< Obraz poprawny, ale renderowanie wolniejsze niż próg.
+};
+
+/**
+ * @struct RegressionOptions
+ * @brief Progi porównania i tryb pracy.
+ */
+struct RegressionOptions {
+    int channelTolerance = 2;       ///< Dopuszczalna różnica kanału, by piksel uznać za zgodny.
+    double maxDiffFraction = 0.0005; ///< Dopuszczalny ułamek niezgodnych pikseli.
+    double slowdownLimit = 1.25;    ///< Dopuszczalny iloraz czasu do czasu wzorcowego.
+    double minSlowdownMs = 0.1;     ///< Wzrost czasu poniżej tej wartości jest pomijany (szum pomiaru).
+    int repetitions = 15;           ///< Liczba mierzonych próbek (wynikiem jest mediana).
+    bool update = false;            ///< Zapis nowych wzorców zamiast porównania.
+};
+
+/**
+ * @struct RegressionResult
+ * @brief Wynik jednego przypadku.
+ */
+struct RegressionResult {
+    std::string name;             ///< Nazwa przypadku.
+    RegressionStatus status = RegressionStatus::Passed; ///< Wynik.
+    std::size_t diffPixels = 0;   ///< Liczba pikseli poza tolerancją.
+    int maxChannelDiff = 0;       ///< Największa różnica kanału.
+    double renderMs = 0.0;        ///< Mediana czasu renderowania.
+    double baselineMs = 0.0;      ///< Czas wzorcowy (0 = brak).
+    RenderStats stats;            ///< Praca GPU jednego renderowania.
+};
+
+/**
+ * @class RegressionSuite
+ * @brief Testy regresji obrazu i czasu dla PrimitiveRenderer (bez okna).
+ *
+ * Każdy przypadek to deterministyczna scena rysowana na kanwie
+ * pozaekranowej. Wynik jest porównywany z plikiem <nazwa>.png w katalogu
+ * wzorców, a mediana czasu renderowania z czasem zapisanym w timings.txt.
+ * Przy niezgodności obok wzorca zapisywany jest obraz różnic
+ * <nazwa>.diff.png. Tryb aktualizacji zapisuje obrazy i czasy od nowa —
+ * należy go uruchamiać tylko dla zweryfikowanej wersji renderera.
+ *
+ * Wzorce nie są częścią repozytorium: zależą od sterownika i karty
+ * graficznej, więc każde stanowisko tworzy własny zestaw (--update).
+ * Brak wzorca nie jest regresją — run() go nie liczy, a getMissingCount()
+ * pozwala zgłosić go osobno.
+ *
+ * Sprawdzenia (Check) to sceny, których poprawny wynik znany jest z góry
+ * (np. zgodność pamięci podręcznej z rysowaniem bez niej) — nie wymagają
+ * wzorców i wykonywane są przy każdym uruchomieniu.
+ */
+class RegressionSuite {
+public:
+    /**
+     * @struct Case
+     * @brief Przypadek testowy: przygotowanie kanwy i mierzone rysowanie.
+     */
+    struct Case {
+        std::string name;                                ///< Nazwa (i nazwa pliku wzorca).
+        std::function<void(sf::RenderTexture&)> setup;   ///< Przygotowanie kanwy (niemierzone).
+        std::function<void(PrimitiveRenderer&)> draw;    ///< Mierzone rysowanie.
+    };
+
+    /**
+     * @struct Check
+     * @brief Sprawdzenie bez wzorca: scena o znanym z góry wyniku.
+     */
+    struct Check {
+        std::string name;          ///< Nazwa.
+        std::function<bool()> run; ///< Zwraca true, jeśli wynik jest poprawny.
+    };
+
+private:
+    sf::RenderTexture canvas;                 ///< Kanwa pozaekranowa.
+    std::string directory;                    ///< Katalog wzorców.
+    RegressionOptions options;                ///< Progi porównania.
+    std::vector<Case> cases;                  ///< Zarejestrowane przypadki.
+    std::vector<Check> checks;                ///< Zarejestrowane sprawdzenia.
+    std::vector<RegressionResult> results;    ///< Wyniki ostatniego uruchomienia.
+    std::map<std::string, double> baselines;  ///< Czasy wzorcowe [ms].
+    std::size_t missing = 0;                  ///< Przypadki bez wzorca w ostatnim uruchomieniu.
+
+    /**
+     * @brief Rejestruje przypadki domyślne (punkty, linie, okręgi, elipsy, kształty wypełnione, łamane, wypełnienia).
+     */
+    void addDefaultCases();
+
+    /**
+     * @brief Rejestruje sprawdzenia domyślne (pamięć wypełnień RenderContext).
+     */
+    void addDefaultChecks();
+
+    /**
+     * @brief Wykonuje jeden przypadek.
+     * @param test Przypadek.
+     * @return Wynik.
+     */
+    RegressionResult runCase(const Case& test);
+
+    /**
+     * @brief Porównuje obraz z wzorcem i zapisuje obraz różnic.
+     * @param image Wynik renderowania.
+     * @param golden Wzorzec.
+     * @param result Wynik (liczba i wielkość różnic).
+     * @param diffFile Plik obrazu różnic.
+     */
+    void compare(const sf::Image& image, const sf::Image& golden, RegressionResult& result, const std::string& diffFile) const;
+
+    std::string path(const std::string& file) const; ///< Ścieżka pliku w katalogu wzorców.
+    void loadBaselines();                            ///< Wczytuje timings.txt.
+    bool saveBaselines() const;                      ///< Zapisuje timings.txt.
+
+public:
+    /**
+     * @brief Konstruktor.
+     * @param directory Katalog obrazów wzorcowych i czasów.
+     * @param options Progi porównania.
+     * @param canvasSize Rozmiar kanwy.
+     */
+    RegressionSuite(const std::string& directory, const RegressionOptions& options = {},
+        sf::Vector2u canvasSize = { 512, 512 });
+
+    /**
+     * @brief Dodaje przypadek testowy.
+     * @param test Przypadek.
+     */
+    void add(Case test) { cases.push_back(std::move(test)); }
+
+    /**
+     * @brief Dodaje sprawdzenie bez wzorca.
+     * @param check Sprawdzenie.
+     */
+    void addCheck(Check check) { checks.push_back(std::move(check)); }
+
+    /**
+     * @brief Wykonuje wszystkie przypadki i wypisuje raport.
+     * @return true jeśli żaden przypadek nie wykazał regresji (brak wzorca nie jest regresją).
+     */
+    bool run();
+
+    /**
+     * @brief Zwraca wyniki ostatniego uruchomienia.
+     * @return Lista wyników.
+     */
+    const std::vector<RegressionResult>& getResults() const { return results; }
+
+    /**
+     * @brief Zwraca liczbę przypadków bez wzorca w ostatnim uruchomieniu.
+     * @return Liczba przypadków MissingGolden.
+     */
+    std::size_t getMissingCount() const { return missing; }
+};
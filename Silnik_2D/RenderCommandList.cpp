@@ -0,0 +1,52 @@
+﻿#include "RenderCommandList.hpp"
+
+// ------------------------------
+// Nagrywanie
+// ------------------------------
+void RenderCommandList::reset(sf::Vector2u size, const sf::View& view) {
+    vertices.clear();
+    sprites.clear();
+    textures.clear();
+    commands.clear();
+    stats.reset();
+    targetSize = size;
+    targetView = view;
+}
+
+bool RenderCommandList::canMerge(sf::PrimitiveType type, const sf::RenderStates& states) const {
+    if (commands.empty()) return false;
+    const Command& last = commands.back();
+    if (last.count == 0 || last.type != type) return false;
+    if (type != sf::PrimitiveType::Points && type != sf::PrimitiveType::Lines && type != sf::PrimitiveType::Triangles)
+        return false;
+    return !states.texture && !states.shader && !last.states.texture && !last.states.shader
+        && last.states.blendMode == states.blendMode && last.states.transform == states.transform;
+}
+
+void RenderCommandList::draw(const sf::Vertex* data, std::size_t count, sf::PrimitiveType type, const sf::RenderStates& states) {
+    if (count == 0) return;
+    if (canMerge(type, states)) commands.back().count += count;
+    else commands.push_back({ type, vertices.size(), count, states });
+    vertices.insert(vertices.end(), data, data + count);
+}
+
+void RenderCommandList::drawSprite(const sf::Sprite& sprite, const sf::RenderStates& states,
+    std::shared_ptr<const sf::Texture> texture) {
+    commands.push_back({ sf::PrimitiveType::Triangles, sprites.size(), 0, states });
+    sprites.push_back(sprite);
+    if (texture) textures.push_back(std::move(texture));
+}
+
+// ------------------------------
+// Odtwarzanie
+// ------------------------------
+RenderStats RenderCommandList::replay(sf::RenderTarget& target) const {
+    for (const Command& cmd : commands) {
+        if (cmd.count) target.draw(vertices.data() + cmd.first, cmd.count, cmd.type, cmd.states);
+        else target.draw(sprites[cmd.first], cmd.states);
+    }
+
+    RenderStats result = stats;
+    result.drawCalls = commands.size();
+    return result;
+}
@@ -0,0 +1,106 @@
+﻿#pragma once
+#include <SFML/Graphics.hpp>
+#include "RenderStats.hpp"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * @class RenderCommandList
+ * @brief Zapis rysowania jednej klatki do odtworzenia w innym wątku.
+ *
+ * Lista przechowuje kopie wierzchołków, sprite'ów i stanów renderowania,
+ * więc po nagraniu nie zależy od stanu obiektów — wątek renderujący może
+ * ją odtwarzać, gdy wątek główny aktualizuje już kolejną klatkę. Tekstury
+ * są wskazywane, nie kopiowane; lista trzyma przekazane jej uchwyty tekstur
+ * do następnego reset(), więc tekstura zwolniona lub zastąpiona w wątku
+ * głównym (BitmapHandler nie aktualizuje w miejscu tekstury trzymanej
+ * przez innych) pozostaje ważna do końca odtworzenia.
+ *
+ * Kolejne polecenia bez tekstury, z tym samym typem listowym (punkty,
+ * linie, trójkąty) i tymi samymi stanami są łączone w jedno wywołanie draw.
+ */
+class RenderCommandList {
+private:
+    /**
+     * @struct Command
+     * @brief Jedno wywołanie draw.
+     */
+    struct Command {
+        sf::PrimitiveType type;   ///< Typ prymitywu (wierzchołki).
+        std::size_t first = 0;    ///< Pierwszy wierzchołek lub indeks sprite'a.
+        std::size_t count = 0;    ///< Liczba wierzchołków (0 = sprite).
+        sf::RenderStates states;  ///< Stany renderowania.
+    };
+
+    std::vector<sf::Vertex> vertices;   ///< Wierzchołki wszystkich poleceń.
+    std::vector<sf::Sprite> sprites;    ///< Kopie sprite'ów.
+    std::vector<std::shared_ptr<const sf::Texture>> textures; ///< Tekstury sprite'ów utrzymywane do końca odtworzenia.
+    std::vector<Command> commands;      ///< Polecenia w kolejności rysowania.
+    RenderStats stats;                  ///< Liczniki nagrania (przed łączeniem poleceń).
+    sf::Vector2u targetSize;            ///< Rozmiar celu, dla którego nagrano klatkę.
+    sf::View targetView;                ///< Widok celu, dla którego nagrano klatkę.
+
+    /**
+     * @brief Sprawdza, czy polecenie wierzchołków można dołączyć do poprzedniego.
+     */
+    bool canMerge(sf::PrimitiveType type, const sf::RenderStates& states) const;
+
+public:
+    /**
+     * @brief Czyści listę (bez zwalniania pamięci) i ustala cel nagrania.
+     * @param size Rozmiar celu.
+     * @param view Widok celu.
+     */
+    void reset(sf::Vector2u size, const sf::View& view);
+
+    /**
+     * @brief Nagrywa rysowanie wierzchołków.
+     * @param data Wierzchołki.
+     * @param count Liczba wierzchołków.
+     * @param type Typ prymitywu.
+     * @param states Stany renderowania.
+     */
+    void draw(const sf::Vertex* data, std::size_t count, sf::PrimitiveType type,
+        const sf::RenderStates& states = sf::RenderStates::Default);
+
+    /**
+     * @brief Nagrywa rysowanie sprite'a (kopia).
+     * @param sprite Sprite.
+     * @param states Stany renderowania.
+     * @param texture Uchwyt tekstury sprite'a (nullptr, gdy jej czas życia zapewnia wywołujący).
+     */
+    void drawSprite(const sf::Sprite& sprite, const sf::RenderStates& states = sf::RenderStates::Default,
+        std::shared_ptr<const sf::Texture> texture = nullptr);
+
+    /**
+     * @brief Zapamiętuje liczniki rysowania nagranej klatki.
+     * @param recorded Liczniki renderera nagrywającego.
+     */
+    void setStats(const RenderStats& recorded) { stats = recorded; }
+
+    /**
+     * @brief Odtwarza polecenia na celu.
+     * @param target Cel rysowania.
+     * @return Liczniki (wywołania draw po łączeniu poleceń).
+     */
+    RenderStats replay(sf::RenderTarget& target) const;
+
+    /**
+     * @brief Zwraca rozmiar celu nagrania.
+     * @return Rozmiar w pikselach.
+     */
+    sf::Vector2u getTargetSize() const { return targetSize; }
+
+    /**
+     * @brief Zwraca widok celu nagrania.
+     * @return Widok.
+     */
+    const sf::View& getTargetView() const { return targetView; }
+
+    /**
+     * @brief Zwraca liczbę poleceń draw.
+     * @return Liczba poleceń.
+     */
+    std::size_t size() const { return commands.size(); }
+};
@@ -0,0 +1,350 @@
+﻿#include "RenderContext.hpp"
+#include "BitmapHandler.hpp"
+#include "PrimitiveRenderer.hpp"
+#include "SnapshotWriter.hpp"
+#include <optional>
+
+// ------------------------------
+// Konstruktor i ponowne użycie
+// ------------------------------
+RenderContext::RenderContext(sf::Vector2u size, sf::Color background)
+    : canvas(size), clearColor(background)
+{
+    canvas.clear(clearColor);
+    canvas.display();
+}
+
+bool RenderContext::reset(sf::Vector2u size, sf::Color background) {
+    clearColor = background;
+    bool ok = canvas.getSize() == size || canvas.resize(size);
+    points.clear();
+    lines.clear();
+    polylines.clear();
+    polygons.clear();
+    circles.clear();
+    ellipses.clear();
+    fills.clear();
+    arena.reset();
+    clear();
+    canvas.display();
+    resetHistory();
+    return ok;
+}
+
+void RenderContext::clear() {
+    fillCache.clear(); // wpisy dla starych wersji kanwy nie będą już trafione
+    canvas.clear(clearColor);
+    drawnPoints = 0;
+    touch();
+}
+
+std::vector<sf::Vector2f> RenderContext::takePoints() {
+    std::vector<sf::Vector2f> taken = std::move(points);
+    points.clear();
+    drawnPoints = 0;
+    return taken;
+}
+
+// ------------------------------
+// Polecenia
+// ------------------------------
+bool RenderContext::execute(const DrawCommand& cmd) {
+    switch (cmd.type) {
+    case CommandType::Point:
+        points.push_back(cmd.points[0]);
+        return true;
+
+    case CommandType::Line:
+        lines.push_back({ cmd.points[0], cmd.points[1] });
+        return true;
+
+    case CommandType::Polyline:
+    case CommandType::Polygon:
+        (cmd.type == CommandType::Polygon ? polygons : polylines).push_back(arena.copy(cmd.points.data(), cmd.points.size()));
+        points.clear();
+        drawnPoints = 0;
+        return true;
+
+    case CommandType::Circle:
+        circles.push_back(cmd.points[0]);
+        return true;
+
+    case CommandType::Ellipse:
+        ellipses.push_back(cmd.points[0]);
+        return true;
+
+    case CommandType::Fill:
+        fills.push_back({ cmd.points[0], cmd.color });
+        return true;
+
+    case CommandType::LoadCanvas:
+        loadImage(cmd.filename);
+        return true;
+
+    case CommandType::SaveCanvas:
+        SnapshotWriter::write(capture(), cmd.filename, SnapshotFormat::Png);
+        return true;
+
+    case CommandType::BlankCanvas:
+        flush();
+        if (canvas.getSize() != cmd.size && !canvas.resize(cmd.size))
+            return true;
+        canvas.clear(cmd.color);
+        canvas.display();
+        touch();
+        return true;
+
+    case CommandType::ResizeCanvas:
+        resizeImage(cmd.size, cmd.filter);
+        return true;
+
+    case CommandType::ClearCanvas:
+        clear();
+        return true;
+
+    case CommandType::FrameEnd:
+        flush();
+        return true;
+
+    case CommandType::Undo:
+        undo();
+        return true;
+
+    case CommandType::Redo:
+        redo();
+        return true;
+
+    case CommandType::SpawnOkreg:
+        break;
+    }
+    return false;
+}
+
+bool RenderContext::loadImage(const std::string& filename) {
+    BitmapHandler image;
+    if (!image.loadFromFile(filename))
+        return false;
+
+    canvas.clear(clearColor);
+    canvas.draw(sf::Sprite(*image.getTexture()));
+    canvas.display();
+    stats.upload(image.getSize());
+    stats.draw(4, static_cast<std::size_t>(image.getSize().x) * image.getSize().y);
+    touch();
+    return true;
+}
+
+bool RenderContext::resizeImage(sf::Vector2u size, ResampleFilter filter) {
+    if (size.x == 0 || size.y == 0) return false;
+    BitmapHandler image;
+    image.create(size.x, size.y);
+    Resampler().resize(capture(), image.editPixels(), size, filter);
+    auto texture = image.getTexture();
+    if (!texture) return false;
+
+    canvas.clear(clearColor);
+    canvas.draw(sf::Sprite(*texture));
+    canvas.display();
+    stats.upload(size);
+    stats.draw(4, static_cast<std::size_t>(size.x) * size.y);
+    touch();
+    return true;
+}
+
+// ------------------------------
+// Rysowanie list
+// ------------------------------
+void RenderContext::flush() {
+    PrimitiveRenderer renderer(canvas);
+    if (history || trackingDamage) renderer.trackDirtyRects(&dirtyRects);
+
+    bool changed = !polygons.empty() || !polylines.empty() || !circles.empty() || !ellipses.empty()
+        || !lines.empty() || drawnPoints < points.size();
+    for (auto& poly : polygons) renderer.drawPolygon(poly.data, poly.count, sf::Color::Yellow);
+    for (auto& polyline : polylines) renderer.drawPolyline(polyline.data, polyline.count, sf::Color::Magenta);
+    for (auto& circle : circles) renderer.drawCircle(circle, 75.0, sf::Color::Green, sf::Color::Green);
+    for (auto& ellipse : ellipses) renderer.drawElips(ellipse, 75.0, 100.0, sf::Color::Red, sf::Color::Red);
+    for (auto& line : lines) renderer.drawLine(line.first, line.second, sf::Color::Cyan);
+    for (; drawnPoints < points.size(); ++drawnPoints)
+        renderer.drawPoint(points[drawnPoints], sf::Color::White);
+    if (changed)
+        version = nextVersion++;
+
+    // Wypełnienia — wynik zapamiętany dla (ziarno, kolor, wersja kanwy),
+    // odczyt z GPU tylko przy braku wpisu w pamięci podręcznej. Po odczycie
+    // obraz przyjmuje odcinki każdego wypełnienia (także trafień), by kolejne
+    // chybienia przeszukiwały aktualną zawartość
+    std::optional<sf::Image> image;
+    for (auto& fill : fills) {
+        FillCache::Key key{ static_cast<int>(fill.pos.x), static_cast<int>(fill.pos.y),
+            fill.color.toInteger(), sf::Color::Black.toInteger(), version };
+        const FillCache::Entry* entry = fillCache.find(key);
+        if (!entry) {
+            if (!image) {
+                canvas.display();
+                image = canvas.getTexture().copyToImage();
+                stats.readback(canvas.getSize());
+            }
+            auto spans = PrimitiveRenderer::floodFillSpans(*image, fill.pos, fill.color, sf::Color::Black);
+            std::uint64_t result = spans.empty() ? version : nextVersion++;
+            entry = &fillCache.store(key, { std::move(spans), result });
+        }
+        if (image) {
+            for (const auto& span : entry->spans)
+                for (unsigned int x = span.x0; x <= span.x1; ++x)
+                    image->setPixel({ x, span.y }, fill.color);
+        }
+        renderer.drawSpans(entry->spans, fill.color);
+        version = entry->resultVersion;
+    }
+
+    canvas.display();
+    stats += renderer.getStats();
+
+    lines.clear();
+    polylines.clear();
+    polygons.clear();
+    circles.clear();
+    ellipses.clear();
+    fills.clear();
+
+    // Zwolnienie geometrii klatki w O(1); sterta używana tylko przy wzroście areny
+    arena.reset();
+
+    if (trackingDamage) damage.insert(damage.end(), dirtyRects.begin(), dirtyRects.end());
+    commitHistory();
+}
+
+// ------------------------------
+// Historia cofania
+// ------------------------------
+void RenderContext::enableHistory(std::size_t budgetBytes) {
+    if (budgetBytes == 0) {
+        history.reset();
+        return;
+    }
+    if (history) {
+        history->setBudget(budgetBytes);
+        return;
+    }
+    history = std::make_unique<CanvasHistory>(budgetBytes);
+    resetHistory();
+}
+
+void RenderContext::resetHistory() {
+    if (!history) return;
+    history->reset(canvas.getTexture().copyToImage());
+    stats.readback(canvas.getSize());
+    historyVersion = version;
+    dirtyRects.clear();
+    dirtyAll = false;
+}
+
+void RenderContext::adoptContent(const sf::Image& content, sf::Vector2i origin, bool keepSteps) {
+    fillCache.clear(); // nowa zawartość — dotychczasowe wersje nie wrócą
+    version = nextVersion++;
+    dirtyRects.clear();
+    dirtyAll = false;
+    damage.clear();
+    damageAll = false;
+    if (!history) return;
+    if (keepSteps) history->rebase(content, origin);
+    else history->reset(content, origin);
+    historyVersion = version;
+}
+
+void RenderContext::commitHistory() {
+    if (history && version != historyVersion) {
+        if (dirtyAll) {
+            history->commit(canvas.getTexture().copyToImage(), historyVersion, version);
+            stats.readback(canvas.getSize());
+        }
+        else history->commit(canvas.getTexture(), dirtyRects, historyVersion, version, stats);
+        historyVersion = version;
+    }
+    dirtyRects.clear();
+    dirtyAll = false;
+}
+
+bool RenderContext::undo() {
+    if (!history) return false;
+    flush(); // niezatwierdzone zmiany stają się krokiem, który zostanie cofnięty
+    std::optional<std::uint64_t> restored = history->undo(canvas, stats, trackingDamage ? &damage : nullptr);
+    if (!restored) return false;
+    // Zawartość jest identyczna z wersją sprzed kroku — wpisy FillCache znów pasują
+    version = historyVersion = *restored;
+    return true;
+}
+
+bool RenderContext::redo() {
+    if (!history) return false;
+    flush();
+    std::optional<std::uint64_t> restored = history->redo(canvas, stats, trackingDamage ? &damage : nullptr);
+    if (!restored) return false;
+    version = historyVersion = *restored;
+    return true;
+}
+
+// ------------------------------
+// Zapis zwrotny zmienionych obszarów
+// ------------------------------
+void RenderContext::setDamageTracking(bool enabled) {
+    trackingDamage = enabled;
+    damage.clear();
+    damageAll = false;
+}
+
+void RenderContext::takeDamage(const std::function<void(const sf::Image&, sf::Vector2i)>& sink) {
+    flush();
+    const sf::Vector2u size = canvas.getSize();
+    const int tile = static_cast<int>(CanvasHistory::TileSize);
+    const int columns = static_cast<int>((size.x + CanvasHistory::TileSize - 1) / CanvasHistory::TileSize);
+    const int rows = static_cast<int>((size.y + CanvasHistory::TileSize - 1) / CanvasHistory::TileSize);
+
+    // Zmienione kafle; każdy wiersz kafli daje ciągłe odcinki jako jeden obszar
+    std::vector<std::uint8_t> marks(static_cast<std::size_t>(columns) * rows, damageAll ? 1 : 0);
+    for (const sf::IntRect& rect : damage) {
+        const int x0 = std::max(0, rect.position.x), y0 = std::max(0, rect.position.y);
+        const int x1 = std::min(static_cast<int>(size.x), rect.position.x + rect.size.x);
+        const int y1 = std::min(static_cast<int>(size.y), rect.position.y + rect.size.y);
+        for (int ty = y0 / tile; x0 < x1 && ty * tile < y1; ++ty)
+            for (int tx = x0 / tile; tx * tile < x1; ++tx)
+                marks[static_cast<std::size_t>(ty) * columns + tx] = 1;
+    }
+    damage.clear();
+    damageAll = false;
+
+    std::vector<sf::IntRect> regions;
+    for (int ty = 0; ty < rows; ++ty) {
+        for (int tx = 0; tx < columns;) {
+            if (!marks[static_cast<std::size_t>(ty) * columns + tx]) { ++tx; continue; }
+            const int first = tx;
+            while (tx < columns && marks[static_cast<std::size_t>(ty) * columns + tx]) ++tx;
+            const sf::Vector2i position(first * tile, ty * tile);
+            regions.push_back({ position, { std::min(tx * tile, static_cast<int>(size.x)) - position.x,
+                std::min(position.y + tile, static_cast<int>(size.y)) - position.y } });
+        }
+    }
+    if (regions.empty()) return;
+
+    // Kopia historii odpowiada kanwie po flush() — wtedy bez odczytu z GPU
+    if (history && historyVersion == version) {
+        for (const sf::IntRect& region : regions)
+            sink(history->copyRegion(region), region.position);
+        return;
+    }
+
+    const sf::Image content = canvas.getTexture().copyToImage();
+    stats.readback(size);
+    for (const sf::IntRect& region : regions) {
+        sf::Image pixels(sf::Vector2u(region.size));
+        if (pixels.copy(content, { 0, 0 }, region))
+            sink(pixels, region.position);
+    }
+}
+
+sf::Image RenderContext::capture() {
+    flush();
+    stats.readback(canvas.getSize());
+    return canvas.getTexture().copyToImage();
+}
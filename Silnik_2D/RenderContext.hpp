@@ -0,0 +1,257 @@
+﻿#pragma once
+#include <SFML/Graphics.hpp>
+#include "CanvasHistory.hpp"
+#include "CommandLog.hpp"
+#include "FillCache.hpp"
+#include "FrameArena.hpp"
+#include "RenderStats.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @class RenderContext
+ * @brief Samodzielny kontekst rysowania: kanwa, listy rysowania i pamięci podręczne.
+ *
+ * Przechowuje wszystko, czego potrzeba do wykonania poleceń DrawCommand
+ * na jednej kanwie — bez okna i bez stanu globalnego — więc wiele
+ * kontekstów może działać równocześnie w różnych wątkach. Kontekst
+ * (a z nim kontekst OpenGL kanwy) należy tworzyć, używać i niszczyć
+ * w jednym wątku.
+ *
+ * Polecenia trafiają do list rysowania, a flush() rysuje je na kanwie
+ * w stałej kolejności (wielokąty, łamane, okręgi, elipsy, odcinki,
+ * punkty, wypełnienia) — tak jak jedna klatka silnika.
+ */
+class RenderContext {
+public:
+    /**
+     * @struct FillRequest
+     * @brief Struktura reprezentująca żądanie wypełnienia kolorem.
+     */
+    struct FillRequest {
+        sf::Vector2f pos; ///< Punkt startowy wypełnienia
+        sf::Color color;  ///< Kolor wypełnienia
+    };
+
+private:
+    sf::RenderTexture canvas; ///< Kanwa (warstwa statyczna).
+    sf::Color clearColor;     ///< Kolor czyszczenia kanwy.
+
+    FrameArena arena;                          ///< Geometria żyjąca do najbliższego flush().
+    std::vector<sf::Vector2f> points;          ///< Punkty (także wierzchołki budowanej łamanej).
+    std::size_t drawnPoints = 0;               ///< Liczba punktów już utrwalonych na kanwie.
+    std::vector<std::pair<sf::Vector2f, sf::Vector2f>> lines; ///< Odcinki.
+    std::vector<ArenaSpan<sf::Vector2f>> polylines; ///< Łamane (wierzchołki w arenie).
+    std::vector<ArenaSpan<sf::Vector2f>> polygons;  ///< Wielokąty (wierzchołki w arenie).
+    std::vector<sf::Vector2f> circles;         ///< Środki okręgów.
+    std::vector<sf::Vector2f> ellipses;        ///< Środki elips.
+    std::vector<FillRequest> fills;            ///< Wypełnienia.
+
+    FillCache fillCache;              ///< Zapamiętane wyniki wypełnień.
+    std::uint64_t version = 0;        ///< Wersja zawartości kanwy.
+    std::uint64_t nextVersion = 1;    ///< Kolejny wolny numer wersji.
+
+    std::unique_ptr<CanvasHistory> history; ///< Historia cofania (nullptr = wyłączona).
+    std::uint64_t historyVersion = 0;       ///< Wersja kanwy zapisana w historii.
+    std::vector<sf::IntRect> dirtyRects;    ///< Obszary narysowane od ostatniego zatwierdzenia historii.
+    bool dirtyAll = false;                  ///< Czy od zatwierdzenia kanwę zmieniono poza listami (touch()).
+
+    bool trackingDamage = false;            ///< Czy zbierać obszary do zapisu zwrotnego (takeDamage()).
+    std::vector<sf::IntRect> damage;        ///< Obszary zmienione od ostatniego takeDamage().
+    bool damageAll = false;                 ///< Czy od takeDamage() zmieniono całą kanwę.
+
+    RenderStats stats; ///< Liczniki pracy GPU od ostatniego resetStats().
+
+    /**
+     * @brief Zapisuje w historii zmiany od ostatniego zatwierdzenia.
+     *
+     * Wywoływane na końcu flush(); odczyt kanwy tylko, gdy zmieniła się wersja,
+     * i tylko kafli pod obszarami narysowanymi przez listy — całość wyłącznie
+     * po zmianie oznaczonej przez touch().
+     */
+    void commitHistory();
+
+    /**
+     * @brief Wczytuje obraz z pliku i rysuje go na kanwie.
+     * @param filename Ścieżka do pliku.
+     * @return true jeśli wczytano poprawnie.
+     */
+    bool loadImage(const std::string& filename);
+
+    /**
+     * @brief Przeskalowuje obraz kanwy i rysuje go w lewym górnym rogu.
+     * @param size Rozmiar wyniku.
+     * @param filter Filtr.
+     * @return true jeśli przeskalowano.
+     */
+    bool resizeImage(sf::Vector2u size, ResampleFilter filter);
+
+public:
+    /**
+     * @brief Konstruktor.
+     * @param size Rozmiar kanwy.
+     * @param background Kolor czyszczenia kanwy.
+     */
+    explicit RenderContext(sf::Vector2u size, sf::Color background = sf::Color::Black);
+
+    RenderContext(const RenderContext&) = delete;
+    RenderContext& operator=(const RenderContext&) = delete;
+
+    /**
+     * @brief Wykonuje polecenie rysowania.
+     *
+     * Obsługuje polecenia kanwy (rysowanie, wypełnienia, wczytanie, zapis,
+     * czyszczenie, cofanie); FrameEnd wywołuje flush(). SpawnOkreg dotyczy obiektów
+     * silnika i nie jest obsługiwane.
+     *
+     * @param cmd Polecenie.
+     * @return false jeśli polecenie nie dotyczy kontekstu.
+     */
+    bool execute(const DrawCommand& cmd);
+
+    /**
+     * @brief Rysuje oczekujące listy na kanwie i je opróżnia.
+     */
+    void flush();
+
+    /**
+     * @brief Czyści kanwę, listy punktów i pamięć wypełnień.
+     */
+    void clear();
+
+    /**
+     * @brief Przygotowuje kontekst do nowej sceny (ponowne użycie kanwy).
+     * @param size Rozmiar kanwy.
+     * @param background Kolor czyszczenia.
+     * @return true jeśli kanwa ma żądany rozmiar.
+     */
+    bool reset(sf::Vector2u size, sf::Color background);
+
+    /**
+     * @brief Włącza historię cofania (tylko zmienione kafle).
+     *
+     * Każdy flush() zmieniający kanwę staje się jednym krokiem historii,
+     * również zmiany wprowadzone poza kontekstem i oznaczone przez touch().
+     *
+     * @param budgetBytes Limit pamięci historii (0 = wyłączenie).
+     */
+    void enableHistory(std::size_t budgetBytes);
+
+    /**
+     * @brief Przyjmuje bieżącą zawartość kanwy za punkt wyjścia historii.
+     *
+     * Czyści kroki i odczytuje całą kanwę z GPU.
+     */
+    void resetHistory();
+
+    /**
+     * @brief Przyjmuje zawartość narysowaną poza kontekstem, której nie należy cofać.
+     *
+     * Np. przesunięcie widoku kanwy kafelkowej: kopia historii pochodzi
+     * z podanego obrazu (bez odczytu kanwy), a kroki zapisane w poprzednich
+     * położeniach zostają — cofnięcie wymaga powrotu do położenia kroku
+     * (CanvasHistory::getUndoOrigin()).
+     *
+     * @param content Zawartość kanwy (pomijana, gdy historia jest wyłączona).
+     * @param origin Położenie kanwy w dokumencie.
+     * @param keepSteps false dla nowego dokumentu (historia od nowa).
+     */
+    void adoptContent(const sf::Image& content, sf::Vector2i origin, bool keepSteps);
+
+    /**
+     * @brief Włącza zbieranie obszarów zmienionych na kanwie (zapis zwrotny, np. do kafli).
+     * @param enabled Czy zbierać; zmiana stanu odrzuca zebrane obszary.
+     */
+    void setDamageTracking(bool enabled);
+
+    /**
+     * @brief Rysuje oczekujące listy i przekazuje obszary zmienione od poprzedniego wywołania.
+     *
+     * Obszary są scalane w kafle CanvasHistory::TileSize. Piksele pochodzą
+     * z kopii historii, gdy ta odpowiada kanwie — inaczej z jednego odczytu
+     * całej kanwy.
+     *
+     * @param sink Wywoływane dla każdego obszaru: piksele i lewy górny róg na kanwie.
+     */
+    void takeDamage(const std::function<void(const sf::Image&, sf::Vector2i)>& sink);
+
+    /**
+     * @brief Cofa ostatni krok historii.
+     * @return true jeśli cofnięto.
+     */
+    bool undo();
+
+    /**
+     * @brief Ponawia ostatnio cofnięty krok.
+     * @return true jeśli ponowiono.
+     */
+    bool redo();
+
+    /**
+     * @brief Zwraca historię cofania.
+     * @return Historia lub nullptr, jeśli wyłączona.
+     */
+    const CanvasHistory* getHistory() const { return history.get(); }
+
+    /**
+     * @brief Oznacza zmianę zawartości kanwy (nowa wersja).
+     */
+    void touch() { version = nextVersion++; dirtyAll = damageAll = true; }
+
+    /**
+     * @brief Odbiera punkty zebrane do budowy łamanej lub wielokąta.
+     * @return Punkty (lista w kontekście zostaje pusta).
+     */
+    std::vector<sf::Vector2f> takePoints();
+
+    /**
+     * @brief Rysuje oczekujące listy i odczytuje piksele kanwy.
+     * @return Obraz kanwy.
+     */
+    sf::Image capture();
+
+    /**
+     * @brief Zwraca kanwę.
+     * @return Referencja do kanwy.
+     */
+    sf::RenderTexture& getCanvas() { return canvas; }
+
+    /**
+     * @brief Zwraca rozmiar kanwy.
+     * @return Rozmiar w pikselach.
+     */
+    sf::Vector2u getSize() const { return canvas.getSize(); }
+
+    /**
+     * @brief Zwraca kolor czyszczenia.
+     * @return Kolor tła.
+     */
+    sf::Color getClearColor() const { return clearColor; }
+
+    /**
+     * @brief Zwraca wersję zawartości kanwy.
+     * @return Numer wersji.
+     */
+    std::uint64_t getVersion() const { return version; }
+
+    /**
+     * @brief Zwraca arenę geometrii klatki (statystyki).
+     * @return Arena.
+     */
+    const FrameArena& getArena() const { return arena; }
+
+    /**
+     * @brief Zwraca liczniki pracy GPU (rysowanie, odczyty, wysłania).
+     * @return Liczniki od ostatniego resetStats().
+     */
+    const RenderStats& getStats() const { return stats; }
+
+    /**
+     * @brief Zeruje liczniki pracy GPU (na początku klatki).
+     */
+    void resetStats() { stats.reset(); }
+};
@@ -0,0 +1,291 @@
+﻿#include "RenderGraph.hpp"
+#include "TextureTracker.hpp"
+#include <algorithm>
+#include <iostream>
+
+// ------------------------------
+// Dostęp przebiegu do zasobów
+// ------------------------------
+sf::RenderTarget& RenderPassContext::target(RenderResource resource) {
+    auto& r = graph.resources[resource];
+    return r.texture ? static_cast<sf::RenderTarget&>(*r.texture) : *r.target;
+}
+
+sf::RenderTexture& RenderPassContext::canvas(RenderResource resource) {
+    return *graph.resources[resource].texture;
+}
+
+const sf::Texture& RenderPassContext::texture(RenderResource resource) {
+    return graph.resources[resource].texture->getTexture();
+}
+
+// ------------------------------
+// Deklaracje zasobów i przebiegów
+// ------------------------------
+RenderGraph::~RenderGraph() {
+    for (auto& entry : pool)
+        TextureTracker::get().untrack(&entry.texture->getTexture());
+}
+
+RenderResource RenderGraph::importTexture(const std::string& name, sf::RenderTexture& texture) {
+    Resource r;
+    r.name = name;
+    r.target = &texture;
+    r.texture = &texture;
+    resources.push_back(r);
+    compiled = false;
+    return static_cast<RenderResource>(resources.size() - 1);
+}
+
+RenderResource RenderGraph::importTarget(const std::string& name, sf::RenderTarget& target) {
+    Resource r;
+    r.name = name;
+    r.target = &target;
+    resources.push_back(r);
+    compiled = false;
+    return static_cast<RenderResource>(resources.size() - 1);
+}
+
+RenderResource RenderGraph::createTransient(const std::string& name, sf::Vector2u size, sf::Color clearColor) {
+    Resource r;
+    r.name = name;
+    r.size = size;
+    r.clearColor = clearColor;
+    r.transient = true;
+    resources.push_back(r);
+    compiled = false;
+    return static_cast<RenderResource>(resources.size() - 1);
+}
+
+void RenderGraph::setOutput(RenderResource resource) {
+    resources[resource].output = true;
+    compiled = false;
+}
+
+std::size_t RenderGraph::addPass(RenderPass pass) {
+    passes.push_back({ std::move(pass) });
+    compiled = false;
+    return passes.size() - 1;
+}
+
+std::size_t RenderGraph::addComposite(const std::string& name, RenderResource output, sf::Color clearColor) {
+    Pass pass;
+    pass.desc.name = name;
+    pass.desc.writes = { output };
+    pass.clearColor = clearColor;
+    pass.composite = true;
+    passes.push_back(std::move(pass));
+    compiled = false;
+    return passes.size() - 1;
+}
+
+void RenderGraph::addLayer(std::size_t composite, RenderResource layer, sf::BlendMode blend) {
+    Pass& pass = passes[composite];
+    pass.layers.push_back({ layer, blend });
+    pass.desc.reads.push_back(layer);
+    compiled = false;
+}
+
+// ------------------------------
+// Kompilacja grafu
+// ------------------------------
+bool RenderGraph::compile() {
+    const std::size_t count = passes.size();
+    std::vector<std::vector<std::size_t>> edges(count);
+    std::vector<std::size_t> incoming(count, 0);
+    auto link = [&](std::size_t from, std::size_t to) {
+        if (from == to) return;
+        edges[from].push_back(to);
+        ++incoming[to];
+    };
+
+    // Kolejne zapisy zasobu w kolejności deklaracji, każdy zapis przed odczytami
+    // (przebieg czytający i zapisujący ten sam zasób porządkuje łańcuch zapisów)
+    for (RenderResource res = 0; res < resources.size(); ++res) {
+        std::vector<std::size_t> writers;
+        for (std::size_t p = 0; p < count; ++p) {
+            const auto& w = passes[p].desc.writes;
+            if (std::find(w.begin(), w.end(), res) != w.end()) writers.push_back(p);
+        }
+        for (std::size_t i = 1; i < writers.size(); ++i)
+            link(writers[i - 1], writers[i]);
+        for (std::size_t p = 0; p < count; ++p) {
+            const auto& r = passes[p].desc.reads;
+            if (std::find(r.begin(), r.end(), res) == r.end()) continue;
+            if (std::find(writers.begin(), writers.end(), p) != writers.end()) continue;
+            for (std::size_t w : writers) link(w, p);
+        }
+    }
+
+    // Sortowanie topologiczne; przy wyborze wygrywa wcześniejsza deklaracja
+    std::vector<std::size_t> sorted;
+    std::vector<bool> done(count, false);
+    while (sorted.size() < count) {
+        std::size_t next = count;
+        for (std::size_t p = 0; p < count && next == count; ++p)
+            if (!done[p] && incoming[p] == 0) next = p;
+        if (next == count) {
+            std::cerr << "[RenderGraph] Cykl zależności między przebiegami" << std::endl;
+            return false;
+        }
+        done[next] = true;
+        sorted.push_back(next);
+        for (std::size_t to : edges[next]) --incoming[to];
+    }
+
+    // Odrzucenie przebiegów, których wyniki nie prowadzą do wyjść grafu
+    std::vector<bool> needed(resources.size(), false);
+    bool anyOutput = false;
+    for (std::size_t i = 0; i < resources.size(); ++i) {
+        needed[i] = resources[i].output;
+        anyOutput = anyOutput || needed[i];
+    }
+    if (!anyOutput) {
+        std::cerr << "[RenderGraph] Graf nie ma wyjścia (setOutput)" << std::endl;
+        return false;
+    }
+
+    std::vector<bool> live(count, false);
+    for (auto it = sorted.rbegin(); it != sorted.rend(); ++it) {
+        const RenderPass& desc = passes[*it].desc;
+        for (RenderResource res : desc.writes) live[*it] = live[*it] || needed[res];
+        if (!live[*it]) continue;
+        for (RenderResource res : desc.reads) needed[res] = true;
+    }
+
+    order.clear();
+    for (std::size_t p : sorted)
+        if (live[p]) order.push_back(p);
+
+    stats = {};
+    stats.passes = count;
+    stats.culled = count - order.size();
+    allocateTransients();
+    compiled = true;
+    return true;
+}
+
+void RenderGraph::allocateTransients() {
+    // Czas życia zasobu: od pierwszego do ostatniego przebiegu, który go używa
+    const std::size_t unused = order.size();
+    std::vector<std::size_t> first(resources.size(), unused), last(resources.size(), 0);
+    for (std::size_t step = 0; step < order.size(); ++step) {
+        const RenderPass& desc = passes[order[step]].desc;
+        for (const auto* list : { &desc.reads, &desc.writes }) {
+            for (RenderResource res : *list) {
+                first[res] = std::min(first[res], step);
+                last[res] = std::max(last[res], step);
+            }
+        }
+    }
+
+    std::vector<RenderResource> transients;
+    for (RenderResource res = 0; res < resources.size(); ++res) {
+        if (!resources[res].transient) continue;
+        resources[res].texture = nullptr;
+        ++stats.transientResources;
+        if (first[res] != unused) transients.push_back(res);
+    }
+    std::sort(transients.begin(), transients.end(),
+        [&](RenderResource a, RenderResource b) { return first[a] < first[b]; });
+
+    // Zasoby o rozłącznym czasie życia i równym rozmiarze dzielą teksturę
+    for (auto& entry : pool) entry.assigned = false;
+    for (RenderResource res : transients) {
+        Resource& r = resources[res];
+        PooledTexture* slot = nullptr;
+        for (auto& entry : pool) {
+            if (entry.texture->getSize() == r.size && (!entry.assigned || entry.busyUntil < first[res])) {
+                slot = &entry;
+                break;
+            }
+        }
+        if (!slot) {
+            auto texture = std::make_unique<sf::RenderTexture>();
+            if (!texture->resize(r.size)) {
+                std::cerr << "[RenderGraph] Nie udało się utworzyć tekstury: " << r.name << std::endl;
+                continue;
+            }
+            TextureTracker::get().track(&texture->getTexture(), "RenderGraph.transient");
+            pool.push_back({ std::move(texture) });
+            slot = &pool.back();
+        }
+        slot->assigned = true;
+        slot->busyUntil = last[res];
+        r.texture = slot->texture.get();
+    }
+
+    // Tekstury bez przydziału są zwalniane
+    auto unusedTexture = [](const PooledTexture& entry) {
+        if (entry.assigned) return false;
+        TextureTracker::get().untrack(&entry.texture->getTexture());
+        return true;
+    };
+    pool.erase(std::remove_if(pool.begin(), pool.end(), unusedTexture), pool.end());
+    stats.transientTextures = pool.size();
+}
+
+// ------------------------------
+// Wykonanie klatki
+// ------------------------------
+bool RenderGraph::execute() {
+    if (!compiled && !compile())
+        return false;
+
+    renderStats.reset();
+    stats.executed = 0;
+    stats.skipped = 0;
+    dirty.assign(resources.size(), false);
+    RenderPassContext context(*this, renderStats);
+
+    for (std::size_t p : order) {
+        const Pass& pass = passes[p];
+        const RenderPass& desc = pass.desc;
+
+        bool run = !desc.changed || desc.changed();
+        for (RenderResource res : desc.reads) run = run || dirty[res];
+        for (RenderResource res : desc.writes) run = run || resources[res].transient;
+        if (!run) {
+            ++stats.skipped;
+            continue;
+        }
+
+        // Zasób tymczasowy jest czyszczony przed pierwszym zapisem w klatce
+        for (RenderResource res : desc.writes) {
+            Resource& r = resources[res];
+            if (r.transient && !dirty[res] && r.texture) r.texture->clear(r.clearColor);
+        }
+
+        if (pass.composite) executeComposite(pass, context);
+        else if (desc.execute) desc.execute(context);
+
+        for (RenderResource res : desc.writes) {
+            dirty[res] = true;
+            if (resources[res].texture) resources[res].texture->display();
+        }
+        ++stats.executed;
+    }
+    return true;
+}
+
+void RenderGraph::executeComposite(const Pass& pass, RenderPassContext& context) {
+    sf::RenderTarget& output = context.target(pass.desc.writes.front());
+    const sf::Vector2u size = output.getSize();
+    const std::size_t pixels = static_cast<std::size_t>(size.x) * size.y;
+
+    output.clear(pass.clearColor);
+    for (const Layer& layer : pass.layers) {
+        if (!resources[layer.resource].texture) continue;
+        output.draw(sf::Sprite(context.texture(layer.resource)), sf::RenderStates(layer.blend));
+        context.stats.draw(4, pixels);
+    }
+}
+
+std::vector<std::string> RenderGraph::getExecutionOrder() {
+    std::vector<std::string> names;
+    if (!compiled && !compile())
+        return names;
+    for (std::size_t p : order)
+        names.push_back(passes[p].desc.name);
+    return names;
+}
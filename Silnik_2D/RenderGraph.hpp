@@ -0,0 +1,258 @@
+﻿#pragma once
+#include <SFML/Graphics.hpp>
+#include "RenderStats.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+using RenderResource = std::uint32_t;                  ///< Identyfikator zasobu grafu renderowania.
+constexpr RenderResource InvalidRenderResource = ~0u;  ///< Brak zasobu.
+
+class RenderGraph;
+
+/**
+ * @class RenderPassContext
+ * @brief Dostęp przebiegu do zasobów grafu w czasie wykonania.
+ */
+class RenderPassContext {
+private:
+    RenderGraph& graph;
+
+public:
+    RenderStats& stats; ///< Liczniki pracy GPU klatki (przebieg dolicza swoje rysowanie).
+
+    RenderPassContext(RenderGraph& graph, RenderStats& stats) : graph(graph), stats(stats) {}
+
+    /**
+     * @brief Zwraca cel rysowania zasobu.
+     * @param resource Zasób zadeklarowany w writes przebiegu.
+     * @return Cel rysowania.
+     */
+    sf::RenderTarget& target(RenderResource resource);
+
+    /**
+     * @brief Zwraca kanwę zasobu (tymczasowego lub importowanej tekstury).
+     * @param resource Zasób zadeklarowany w writes przebiegu.
+     * @return Kanwa.
+     */
+    sf::RenderTexture& canvas(RenderResource resource);
+
+    /**
+     * @brief Zwraca teksturę zasobu (do odczytu).
+     * @param resource Zasób zadeklarowany w reads przebiegu.
+     * @return Tekstura.
+     */
+    const sf::Texture& texture(RenderResource resource);
+};
+
+/**
+ * @struct RenderPass
+ * @brief Przebieg renderowania: zasoby czytane i zapisywane oraz praca.
+ */
+struct RenderPass {
+    std::string name;                                   ///< Nazwa (diagnostyka).
+    std::vector<RenderResource> reads;                  ///< Zasoby czytane.
+    std::vector<RenderResource> writes;                 ///< Zasoby zapisywane.
+    std::function<void(RenderPassContext&)> execute;    ///< Rysowanie.
+    std::function<bool()> changed;                      ///< Czy wynik zmieni się w tej klatce (puste = zawsze).
+};
+
+/**
+ * @struct RenderGraphStats
+ * @brief Przebiegi i tekstury ostatniej klatki grafu.
+ */
+struct RenderGraphStats {
+    std::size_t passes = 0;             ///< Zadeklarowane przebiegi.
+    std::size_t executed = 0;           ///< Wykonane w ostatniej klatce.
+    std::size_t culled = 0;             ///< Odrzucone (wynik nieużywany).
+    std::size_t skipped = 0;            ///< Pominięte (wynik niezmieniony).
+    std::size_t transientResources = 0; ///< Zasoby tymczasowe.
+    std::size_t transientTextures = 0;  ///< Tekstury tymczasowe po współdzieleniu.
+};
+
+/**
+ * @class RenderGraph
+ * @brief Deklaratywny graf przebiegów renderowania klatki.
+ *
+ * Przebiegi deklarują zasoby, które czytają i zapisują; kolejność
+ * wykonania wynika z zależności (zapis przed odczytem, kolejne zapisy
+ * tego samego zasobu w kolejności deklaracji). Kompilacja grafu:
+ * - odrzuca przebiegi, których wyniki nie trafiają do wyjść grafu,
+ * - przydziela zasobom tymczasowym tekstury z puli — zasoby
+ *   o rozłącznym czasie życia i równym rozmiarze dzielą jedną teksturę.
+ *
+ * Przebieg z funkcją changed jest pomijany, gdy ta zwraca false i żaden
+ * czytany zasób nie zmienił się w tej klatce — jego wynik pozostaje
+ * w zasobie importowanym. Zasoby tymczasowe nie przechowują zawartości
+ * między klatkami, więc ich przebiegi wykonują się zawsze.
+ *
+ * Przebieg złożenia (addComposite) czyści wyjście i rysuje na nim
+ * po jednym sprite'cie dla każdej warstwy — dodanie warstwy nie wymaga
+ * zmiany kodu rysującego.
+ */
+class RenderGraph {
+private:
+    /**
+     * @struct Resource
+     * @brief Zasób: cel importowany albo tymczasowy z puli.
+     */
+    struct Resource {
+        std::string name;                   ///< Nazwa (diagnostyka).
+        sf::RenderTarget* target = nullptr; ///< Cel importowany (nullptr dla tymczasowych).
+        sf::RenderTexture* texture = nullptr; ///< Tekstura celu (importowana lub przydzielona z puli).
+        sf::Vector2u size;                  ///< Rozmiar zasobu tymczasowego.
+        sf::Color clearColor;               ///< Kolor czyszczenia zasobu tymczasowego.
+        bool transient = false;             ///< Czy zasób jest tymczasowy.
+        bool output = false;                ///< Czy zasób jest wyjściem grafu.
+    };
+
+    /**
+     * @struct Layer
+     * @brief Warstwa przebiegu złożenia.
+     */
+    struct Layer {
+        RenderResource resource;  ///< Zasób warstwy.
+        sf::BlendMode blend;      ///< Tryb mieszania przy złożeniu.
+    };
+
+    /**
+     * @struct Pass
+     * @brief Zadeklarowany przebieg.
+     */
+    struct Pass {
+        RenderPass desc;                ///< Deklaracja.
+        std::vector<Layer> layers;      ///< Warstwy (tylko przebieg złożenia).
+        sf::Color clearColor;           ///< Kolor czyszczenia wyjścia złożenia.
+        bool composite = false;         ///< Czy to przebieg złożenia.
+    };
+
+    /**
+     * @struct PooledTexture
+     * @brief Tekstura tymczasowa w puli.
+     */
+    struct PooledTexture {
+        std::unique_ptr<sf::RenderTexture> texture; ///< Tekstura.
+        std::size_t busyUntil = 0;                  ///< Ostatni krok użycia w bieżącym przydziale.
+        bool assigned = false;                      ///< Czy przydzielona w bieżącej kompilacji.
+    };
+
+    std::vector<Resource> resources;      ///< Zasoby.
+    std::vector<Pass> passes;             ///< Przebiegi w kolejności deklaracji.
+    std::vector<std::size_t> order;       ///< Przebiegi żywe w kolejności wykonania.
+    std::vector<PooledTexture> pool;      ///< Tekstury tymczasowe.
+    std::vector<bool> dirty;              ///< Zasoby zapisane w bieżącej klatce.
+    RenderStats renderStats;              ///< Liczniki GPU ostatniej klatki.
+    RenderGraphStats stats;               ///< Przebiegi ostatniej klatki.
+    bool compiled = false;                ///< Czy order i przydział tekstur są aktualne.
+
+    friend class RenderPassContext;
+
+    /**
+     * @brief Ustala kolejność przebiegów, odrzuca nieużywane i przydziela tekstury.
+     * @return false przy cyklu zależności lub braku wyjść.
+     */
+    bool compile();
+
+    /**
+     * @brief Przydziela zasobom tymczasowym tekstury z puli.
+     */
+    void allocateTransients();
+
+    /**
+     * @brief Wykonuje przebieg złożenia.
+     * @param pass Przebieg.
+     * @param context Kontekst wykonania.
+     */
+    void executeComposite(const Pass& pass, RenderPassContext& context);
+
+public:
+    RenderGraph() = default;
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    /**
+     * @brief Destruktor — wypisuje tekstury puli z ewidencji.
+     */
+    ~RenderGraph();
+
+    /**
+     * @brief Importuje kanwę istniejącą poza grafem (zawartość trwała między klatkami).
+     * @param name Nazwa.
+     * @param texture Kanwa.
+     * @return Zasób.
+     */
+    RenderResource importTexture(const std::string& name, sf::RenderTexture& texture);
+
+    /**
+     * @brief Importuje cel tylko do zapisu (np. okno).
+     * @param name Nazwa.
+     * @param target Cel rysowania.
+     * @return Zasób.
+     */
+    RenderResource importTarget(const std::string& name, sf::RenderTarget& target);
+
+    /**
+     * @brief Deklaruje zasób tymczasowy czyszczony przed pierwszym zapisem w klatce.
+     * @param name Nazwa.
+     * @param size Rozmiar w pikselach.
+     * @param clearColor Kolor czyszczenia.
+     * @return Zasób.
+     */
+    RenderResource createTransient(const std::string& name, sf::Vector2u size, sf::Color clearColor = sf::Color::Transparent);
+
+    /**
+     * @brief Oznacza zasób jako wyjście grafu (przebiegi go tworzące nie są odrzucane).
+     * @param resource Zasób.
+     */
+    void setOutput(RenderResource resource);
+
+    /**
+     * @brief Dodaje przebieg.
+     * @param pass Przebieg.
+     * @return Indeks przebiegu.
+     */
+    std::size_t addPass(RenderPass pass);
+
+    /**
+     * @brief Dodaje przebieg złożenia warstw.
+     * @param name Nazwa.
+     * @param output Wyjście złożenia.
+     * @param clearColor Kolor czyszczenia wyjścia.
+     * @return Indeks przebiegu.
+     */
+    std::size_t addComposite(const std::string& name, RenderResource output, sf::Color clearColor = sf::Color::Black);
+
+    /**
+     * @brief Dodaje warstwę do przebiegu złożenia (na wierzch poprzednich).
+     * @param composite Indeks przebiegu złożenia.
+     * @param layer Zasób warstwy.
+     * @param blend Tryb mieszania.
+     */
+    void addLayer(std::size_t composite, RenderResource layer, sf::BlendMode blend = sf::BlendAlpha);
+
+    /**
+     * @brief Wykonuje klatkę (kompiluje graf po zmianie deklaracji).
+     * @return false, jeśli graf nie daje się skompilować.
+     */
+    bool execute();
+
+    /**
+     * @brief Zwraca nazwy przebiegów w kolejności wykonania (po kompilacji).
+     * @return Nazwy przebiegów żywych.
+     */
+    std::vector<std::string> getExecutionOrder();
+
+    /**
+     * @brief Zwraca liczniki GPU ostatniej klatki.
+     * @return Liczniki.
+     */
+    const RenderStats& getRenderStats() const { return renderStats; }
+
+    /**
+     * @brief Zwraca statystyki przebiegów ostatniej klatki.
+     * @return Statystyki.
+     */
+    const RenderGraphStats& getStats() const { return stats; }
+};
@@ -0,0 +1,71 @@
+﻿#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+
+/**
+ * @struct RenderStats
+ * @brief Liczniki pracy GPU w jednej klatce.
+ *
+ * Zbierane przez PrimitiveRenderer i RenderContext, sumowane przez
+ * Engine::render i zerowane na początku każdej klatki. Liczba pikseli
+ * jest szacunkiem (pole rysowanego obszaru, bez przycinania do kanwy).
+ */
+struct RenderStats {
+    std::size_t drawCalls = 0;   ///< Wywołania draw.
+    std::size_t vertices = 0;    ///< Wysłane wierzchołki.
+    std::size_t pixels = 0;      ///< Zamalowane piksele (szacunek).
+    std::size_t readbacks = 0;   ///< Odczyty tekstury z GPU (copyToImage).
+    std::size_t uploads = 0;     ///< Wysłania pikseli do tekstur.
+    std::size_t bytesRead = 0;   ///< Bajty odczytane z GPU.
+    std::size_t bytesUploaded = 0; ///< Bajty wysłane na GPU.
+
+    /**
+     * @brief Zeruje liczniki.
+     */
+    void reset() { *this = RenderStats{}; }
+
+    /**
+     * @brief Zlicza jedno wywołanie draw.
+     * @param vertexCount Liczba wierzchołków.
+     * @param pixelCount Liczba zamalowanych pikseli.
+     */
+    void draw(std::size_t vertexCount, std::size_t pixelCount) {
+        ++drawCalls;
+        vertices += vertexCount;
+        pixels += pixelCount;
+    }
+
+    /**
+     * @brief Zlicza odczyt obszaru z GPU.
+     * @param size Rozmiar odczytanego obszaru (RGBA).
+     */
+    void readback(sf::Vector2u size) {
+        ++readbacks;
+        bytesRead += static_cast<std::size_t>(size.x) * size.y * 4;
+    }
+
+    /**
+     * @brief Zlicza wysłanie obszaru na GPU.
+     * @param size Rozmiar wysłanego obszaru (RGBA).
+     */
+    void upload(sf::Vector2u size) {
+        ++uploads;
+        bytesUploaded += static_cast<std::size_t>(size.x) * size.y * 4;
+    }
+
+    /**
+     * @brief Dodaje liczniki innego źródła.
+     * @param other Liczniki do dodania.
+     * @return Referencja do this.
+     */
+    RenderStats& operator+=(const RenderStats& other) {
+        drawCalls += other.drawCalls;
+        vertices += other.vertices;
+        pixels += other.pixels;
+        readbacks += other.readbacks;
+        uploads += other.uploads;
+        bytesRead += other.bytesRead;
+        bytesUploaded += other.bytesUploaded;
+        return *this;
+    }
+};
@@ -0,0 +1,83 @@
+﻿#include "RenderThread.hpp"
+#include <chrono>
+
+// ------------------------------
+// Uruchamianie i zatrzymywanie
+// ------------------------------
+void RenderThread::start(std::function<void()> render, std::function<void()> begin, std::function<void()> finish) {
+    if (worker.joinable()) return;
+    frame = std::move(render);
+    stopping = false;
+    pending = false;
+    worker = std::thread(&RenderThread::workerLoop, this, std::move(begin), std::move(finish));
+}
+
+void RenderThread::stop() {
+    if (!worker.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    frameReady.notify_one();
+    worker.join();
+}
+
+void RenderThread::workerLoop(std::function<void()> begin, std::function<void()> finish) {
+    if (begin) begin();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        frameReady.wait(lock, [this] { return stopping || pending; });
+        if (!pending) break; // stopping bez zleconej klatki
+        lock.unlock();
+
+        auto start = std::chrono::steady_clock::now();
+        frame();
+        float elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        lock.lock();
+        lastFrameMs = elapsed;
+        ++frames;
+        pending = false;
+        idle.notify_all();
+    }
+    lock.unlock();
+
+    if (finish) finish();
+}
+
+// ------------------------------
+// Zlecanie klatek
+// ------------------------------
+void RenderThread::submit() {
+    if (!worker.joinable()) return;
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending = true;
+    }
+    frameReady.notify_one();
+}
+
+void RenderThread::wait() {
+    if (!worker.joinable()) return;
+    auto start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return !pending; });
+    lastWaitMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+float RenderThread::getLastFrameMs() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lastFrameMs;
+}
+
+float RenderThread::getLastWaitMs() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lastWaitMs;
+}
+
+std::uint64_t RenderThread::getFrameCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return frames;
+}
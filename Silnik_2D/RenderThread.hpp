@@ -0,0 +1,94 @@
+﻿#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * @class RenderThread
+ * @brief Wątek renderujący z jedną klatką w locie.
+ *
+ * Wątek główny przygotowuje klatkę N+1, podczas gdy wątek renderujący
+ * wykonuje klatkę N. submit() czeka na zakończenie poprzedniej klatki,
+ * więc opóźnienie obrazu względem symulacji wynosi najwyżej jedną klatkę.
+ * wait() jest barierą dla kodu wątku głównego, który musi zmienić zasoby
+ * używane przez renderowanie (kanwę, listy rysowania, tekstury).
+ */
+class RenderThread {
+private:
+    mutable std::mutex mutex;               ///< Ochrona stanu klatki.
+    std::condition_variable frameReady;     ///< Sygnał zleconej klatki.
+    std::condition_variable idle;           ///< Sygnał zakończenia klatki.
+    std::function<void()> frame;            ///< Renderowanie klatki (w wątku renderującym).
+    bool pending = false;                   ///< Czy klatka jest zlecona lub w toku.
+    bool stopping = false;                  ///< Flaga zakończenia wątku.
+    float lastFrameMs = 0.f;                ///< Czas ostatniej klatki w wątku renderującym.
+    float lastWaitMs = 0.f;                 ///< Ostatnie oczekiwanie wątku głównego.
+    std::uint64_t frames = 0;               ///< Wyrenderowane klatki.
+    std::thread worker;                     ///< Wątek renderujący.
+
+    /**
+     * @brief Pętla wątku renderującego.
+     * @param begin Wywoływane raz na początku (np. aktywacja kontekstu okna).
+     * @param finish Wywoływane raz przed zakończeniem.
+     */
+    void workerLoop(std::function<void()> begin, std::function<void()> finish);
+
+public:
+    RenderThread() = default;
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    /**
+     * @brief Kończy wątek (po zakończeniu klatki w toku).
+     */
+    ~RenderThread() { stop(); }
+
+    /**
+     * @brief Uruchamia wątek.
+     * @param render Renderowanie jednej klatki.
+     * @param begin Wywoływane w wątku renderującym przed pierwszą klatką.
+     * @param finish Wywoływane w wątku renderującym przed jego zakończeniem.
+     */
+    void start(std::function<void()> render, std::function<void()> begin = {}, std::function<void()> finish = {});
+
+    /**
+     * @brief Kończy wątek (po zakończeniu klatki w toku).
+     */
+    void stop();
+
+    /**
+     * @brief Sprawdza, czy wątek działa.
+     * @return true po start(), przed stop().
+     */
+    bool isRunning() const { return worker.joinable(); }
+
+    /**
+     * @brief Zleca kolejną klatkę (czeka na zakończenie poprzedniej).
+     */
+    void submit();
+
+    /**
+     * @brief Czeka na zakończenie klatki w toku (natychmiast, gdy wątek stoi).
+     */
+    void wait();
+
+    /**
+     * @brief Zwraca czas renderowania ostatniej klatki.
+     * @return Czas w milisekundach.
+     */
+    float getLastFrameMs() const;
+
+    /**
+     * @brief Zwraca czas ostatniego oczekiwania w submit() lub wait().
+     * @return Czas w milisekundach.
+     */
+    float getLastWaitMs() const;
+
+    /**
+     * @brief Zwraca liczbę wyrenderowanych klatek.
+     * @return Liczba klatek.
+     */
+    std::uint64_t getFrameCount() const;
+};
@@ -0,0 +1,222 @@
+﻿#include "Resampler.hpp"
+#include "PixelKernels.hpp"
+#include "TextureTracker.hpp"
+#include <algorithm>
+#include <cmath>
+#include <emmintrin.h>
+
+namespace {
+constexpr float Pi = 3.14159265358979f;
+
+float sinc(float x) {
+    if (std::fabs(x) < 1e-6f) return 1.f;
+    x *= Pi;
+    return std::sin(x) / x;
+}
+
+// Promień filtra w pikselach źródła (dla skali 1)
+float filterSupport(ResampleFilter filter) {
+    switch (filter) {
+    case ResampleFilter::Box:      return 0.5f;
+    case ResampleFilter::Bilinear: return 1.f;
+    default:                       return 3.f;
+    }
+}
+
+float filterWeight(ResampleFilter filter, float x) {
+    x = std::fabs(x);
+    switch (filter) {
+    case ResampleFilter::Box:      return x <= 0.5f ? 1.f : 0.f;
+    case ResampleFilter::Bilinear: return x < 1.f ? 1.f - x : 0.f;
+    default:                       return x < 3.f ? sinc(x) * sinc(x / 3.f) : 0.f;
+    }
+}
+} // namespace
+
+// ------------------------------
+// Wagi filtra
+// ------------------------------
+void Resampler::buildAxis(Axis& axis, unsigned int from, unsigned int to, ResampleFilter filter) {
+    axis.taps.resize(to);
+    axis.weights.clear();
+
+    const float scale = static_cast<float>(to) / from;
+    const float widen = std::max(1.f, 1.f / scale); // pomniejszanie poszerza filtr
+    const float support = filterSupport(filter) * widen;
+    const int last = static_cast<int>(from) - 1;
+
+    for (unsigned int i = 0; i < to; ++i) {
+        const float center = (i + 0.5f) / scale;
+        int left = std::max(0, static_cast<int>(std::floor(center - support)));
+        int right = std::min(last, static_cast<int>(std::ceil(center + support)));
+
+        Contributor& c = axis.taps[i];
+        c = Contributor{};
+        c.offset = axis.weights.size();
+        float sum = 0.f;
+        for (int j = left; j <= right; ++j) {
+            float w = filterWeight(filter, (j + 0.5f - center) / widen);
+            if (w == 0.f && c.count == 0) {
+                ++left; // pomijanie zer na początku
+                continue;
+            }
+            axis.weights.push_back(w);
+            ++c.count;
+            sum += w;
+        }
+        c.first = left;
+        while (c.count > 1 && axis.weights.back() == 0.f) {
+            axis.weights.pop_back();
+            --c.count;
+        }
+
+        if (c.count == 0 || sum == 0.f) {
+            // Filtr nie trafił w żaden piksel — najbliższy sąsiad
+            axis.weights.resize(c.offset);
+            axis.weights.push_back(1.f);
+            c.first = std::clamp(static_cast<int>(center), 0, last);
+            c.count = 1;
+            continue;
+        }
+        for (int k = 0; k < c.count; ++k)
+            axis.weights[c.offset + k] /= sum;
+    }
+}
+
+// ------------------------------
+// Zmiana rozmiaru
+// ------------------------------
+sf::Image Resampler::resize(const sf::Image& src, sf::Vector2u size, ResampleFilter filter) {
+    sf::Image out;
+    resize(src, out, size, filter);
+    return out;
+}
+
+void Resampler::resize(const sf::Image& src, sf::Image& dst, sf::Vector2u size, ResampleFilter filter) {
+    const sf::Vector2u from = src.getSize();
+    if (from.x == 0 || from.y == 0 || size.x == 0 || size.y == 0) {
+        dst = sf::Image();
+        return;
+    }
+    if (from == size) {
+        if (&dst != &src) dst = src;
+        return;
+    }
+
+    buildAxis(horizontal, from.x, size.x, filter);
+    buildAxis(vertical, from.y, size.y, filter);
+
+    source.resize(static_cast<std::size_t>(from.x) * from.y * 4);
+    temp.resize(static_cast<std::size_t>(size.x) * from.y * 4);
+    target.resize(static_cast<std::size_t>(size.x) * size.y * 4);
+    bytes.resize(static_cast<std::size_t>(size.x) * size.y * 4);
+    PixelKernels::bytesToFloats(src.getPixelsPtr(), source.data(), static_cast<std::size_t>(from.x) * from.y);
+
+    // Przebieg poziomy: from.x -> size.x w każdym wierszu źródła
+    const std::size_t srcStride = static_cast<std::size_t>(from.x) * 4;
+    const std::size_t dstStride = static_cast<std::size_t>(size.x) * 4;
+    for (unsigned int y = 0; y < from.y; ++y) {
+        const float* s = source.data() + y * srcStride;
+        float* d = temp.data() + y * dstStride;
+        for (unsigned int x = 0; x < size.x; ++x) {
+            const Contributor& c = horizontal.taps[x];
+            const float* w = horizontal.weights.data() + c.offset;
+            const float* p = s + static_cast<std::size_t>(c.first) * 4;
+            __m128 acc = _mm_setzero_ps();
+            for (int k = 0; k < c.count; ++k)
+                acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(w[k]), _mm_loadu_ps(p + k * 4)));
+            _mm_storeu_ps(d + x * 4, acc);
+        }
+    }
+
+    // Przebieg pionowy: całe wiersze naraz
+    for (unsigned int y = 0; y < size.y; ++y) {
+        const Contributor& c = vertical.taps[y];
+        rows.resize(c.count);
+        for (int k = 0; k < c.count; ++k)
+            rows[k] = temp.data() + (c.first + k) * dstStride;
+        PixelKernels::weightedRows(rows.data(), vertical.weights.data() + c.offset, c.count,
+            target.data() + y * dstStride, dstStride);
+    }
+
+    PixelKernels::floatsToBytes(target.data(), bytes.data(), static_cast<std::size_t>(size.x) * size.y);
+    dst.resize(size, bytes.data());
+}
+
+// ------------------------------
+// Pomniejszanie 2x
+// ------------------------------
+sf::Image Resampler::halve(const sf::Image& src) {
+    const sf::Vector2u from = src.getSize();
+    if (from.x == 0 || from.y == 0) return {};
+
+    const sf::Vector2u size{ std::max(1u, from.x / 2), std::max(1u, from.y / 2) };
+    std::vector<std::uint8_t> out(static_cast<std::size_t>(size.x) * size.y * 4);
+    const std::uint8_t* pixels = src.getPixelsPtr();
+    const std::size_t stride = static_cast<std::size_t>(from.x) * 4;
+
+    for (unsigned int y = 0; y < size.y; ++y) {
+        const std::uint8_t* r0 = pixels + std::min(2 * y, from.y - 1) * stride;
+        const std::uint8_t* r1 = pixels + std::min(2 * y + 1, from.y - 1) * stride;
+        std::uint8_t* d = out.data() + static_cast<std::size_t>(y) * size.x * 4;
+
+        unsigned int x = 0;
+        // 8 pikseli źródła (dwa rejestry) -> 4 piksele wyniku
+        for (; 2 * x + 8 <= from.x && x + 4 <= size.x; x += 4) {
+            __m128i a = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(r0 + x * 8)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(r1 + x * 8)));
+            __m128i b = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(r0 + x * 8 + 16)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(r1 + x * 8 + 16)));
+            __m128 even = _mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 odd = _mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(3, 1, 3, 1));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + x * 4),
+                _mm_avg_epu8(_mm_castps_si128(even), _mm_castps_si128(odd)));
+        }
+        for (; x < size.x; ++x) {
+            const std::size_t x0 = std::min(2 * x, from.x - 1) * 4, x1 = std::min(2 * x + 1, from.x - 1) * 4;
+            for (int ch = 0; ch < 4; ++ch)
+                d[x * 4 + ch] = static_cast<std::uint8_t>((r0[x0 + ch] + r0[x1 + ch] + r1[x0 + ch] + r1[x1 + ch] + 2) / 4);
+        }
+    }
+
+    sf::Image result;
+    result.resize(size, out.data());
+    return result;
+}
+
+// ------------------------------
+// MipPyramid
+// ------------------------------
+std::shared_ptr<const MipPyramid> MipPyramid::build(const sf::Image& base, std::shared_ptr<const sf::Texture> baseTexture,
+    ResampleFilter filter, const std::string& tag, std::size_t maxLevels)
+{
+    auto pyramid = std::make_shared<MipPyramid>();
+    pyramid->levels.push_back(std::move(baseTexture));
+
+    auto& tracker = TextureTracker::get();
+    Resampler resampler;
+    sf::Image level = base;
+    while (pyramid->levels.size() < maxLevels && (level.getSize().x > 1 || level.getSize().y > 1)) {
+        if (filter == ResampleFilter::Box) {
+            level = Resampler::halve(level);
+        }
+        else {
+            sf::Vector2u size{ std::max(1u, level.getSize().x / 2), std::max(1u, level.getSize().y / 2) };
+            resampler.resize(level, level, size, filter);
+        }
+
+        auto texture = tracker.create(tag + " (mip)");
+        if (!texture->loadFromImage(level))
+            break;
+        texture->setSmooth(true);
+        tracker.refresh(texture.get());
+        pyramid->levels.push_back(std::move(texture));
+    }
+    return pyramid;
+}
+
+std::size_t MipPyramid::selectLevel(float scale) const {
+    if (!(scale > 0.f) || scale >= 1.f) return 0;
+    std::size_t level = static_cast<std::size_t>(std::floor(std::log2(1.f / scale)));
+    return std::min(level, levels.size() - 1);
+}
@@ -0,0 +1,144 @@
+﻿#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @enum ResampleFilter
+ * @brief Filtr zmiany rozmiaru obrazu.
+ *
+ * - Box: średnia pikseli pokrytych przez piksel wynikowy (przy powiększaniu — najbliższy sąsiad).
+ * - Bilinear: filtr trójkątny (interpolacja dwuliniowa, przy pomniejszaniu poszerzona).
+ * - Lanczos: Lanczos-3 — najostrzejszy, najdroższy.
+ */
+enum class ResampleFilter : std::uint8_t { Box, Bilinear, Lanczos };
+
+/**
+ * @class Resampler
+ * @brief Zmiana rozmiaru obrazów filtrem separowalnym.
+ *
+ * Wagi filtra są liczone raz na kolumnę i wiersz wyniku, po czym obraz
+ * przechodzi przebieg poziomy (piksel float RGBA w rejestrze SSE)
+ * i pionowy (całe wiersze, SSE/AVX — PixelKernels). Przy pomniejszaniu
+ * filtr jest poszerzany, więc wynik nie ma aliasingu. Bufory pośrednie
+ * należą do obiektu i są używane ponownie przy kolejnych wywołaniach.
+ */
+class Resampler {
+private:
+    /**
+     * @struct Contributor
+     * @brief Piksele źródłowe składające się na jeden piksel wyniku.
+     */
+    struct Contributor {
+        int first = 0;           ///< Pierwszy piksel źródłowy.
+        int count = 0;           ///< Liczba pikseli źródłowych.
+        std::size_t offset = 0;  ///< Początek wag w Axis::weights.
+    };
+
+    /**
+     * @struct Axis
+     * @brief Wagi filtra dla jednej osi.
+     */
+    struct Axis {
+        std::vector<Contributor> taps; ///< Jeden wpis na piksel wyniku.
+        std::vector<float> weights;    ///< Znormalizowane wagi wszystkich wpisów.
+    };
+
+    Axis horizontal;                  ///< Wagi kolumn.
+    Axis vertical;                    ///< Wagi wierszy.
+    std::vector<float> source;        ///< Obraz źródłowy (float RGBA).
+    std::vector<float> temp;          ///< Wynik przebiegu poziomego.
+    std::vector<float> target;        ///< Wynik przebiegu pionowego.
+    std::vector<const float*> rows;   ///< Wiersze wejściowe przebiegu pionowego.
+    std::vector<std::uint8_t> bytes;  ///< Bufor wynikowy RGBA8.
+
+    /**
+     * @brief Liczy wagi filtra dla jednej osi.
+     * @param axis Wynik.
+     * @param from Rozmiar źródła.
+     * @param to Rozmiar wyniku.
+     * @param filter Filtr.
+     */
+    static void buildAxis(Axis& axis, unsigned int from, unsigned int to, ResampleFilter filter);
+
+public:
+    /**
+     * @brief Zmienia rozmiar obrazu.
+     * @param src Obraz źródłowy.
+     * @param dst Obraz wynikowy (może być tym samym obiektem co src).
+     * @param size Rozmiar wyniku.
+     * @param filter Filtr.
+     */
+    void resize(const sf::Image& src, sf::Image& dst, sf::Vector2u size, ResampleFilter filter);
+
+    /**
+     * @brief Zmienia rozmiar obrazu.
+     * @param src Obraz źródłowy.
+     * @param size Rozmiar wyniku.
+     * @param filter Filtr.
+     * @return Nowy obraz.
+     */
+    sf::Image resize(const sf::Image& src, sf::Vector2u size, ResampleFilter filter);
+
+    /**
+     * @brief Zmniejsza obraz dwukrotnie (średnia bloków 2x2 na bajtach, SSE2).
+     *
+     * Najszybsza droga budowy kolejnych poziomów piramidy mipmap.
+     * Nieparzysta ostatnia kolumna lub wiersz jest pomijana. Uśrednianie
+     * parami (_mm_avg_epu8) może zawyżyć wynik o 1.
+     *
+     * @param src Obraz źródłowy.
+     * @return Obraz o rozmiarze max(1, rozmiar / 2).
+     */
+    static sf::Image halve(const sf::Image& src);
+};
+
+/**
+ * @class MipPyramid
+ * @brief Łańcuch coraz mniejszych tekstur jednej bitmapy.
+ *
+ * Poziom 0 to tekstura oryginału, każdy kolejny ma połowę rozmiaru
+ * poprzedniego. Obiekt rysowany w pomniejszeniu wybiera poziom, którego
+ * rozdzielczość odpowiada rozmiarowi na ekranie — mniej pobieranych
+ * tekseli i brak migotania drobnych szczegółów. Piramida jest niezmienna
+ * po zbudowaniu i może być współdzielona przez wiele obiektów.
+ */
+class MipPyramid {
+private:
+    std::vector<std::shared_ptr<const sf::Texture>> levels; ///< Poziomy od największego.
+
+public:
+    /**
+     * @brief Buduje piramidę.
+     * @param base Piksele oryginału.
+     * @param baseTexture Tekstura oryginału (poziom 0).
+     * @param filter Filtr pomniejszania (Box — szybkie uśrednianie 2x2).
+     * @param tag Właściciel tekstur w TextureTracker.
+     * @param maxLevels Największa liczba poziomów (razem z poziomem 0).
+     * @return Piramida (co najmniej poziom 0).
+     */
+    static std::shared_ptr<const MipPyramid> build(const sf::Image& base, std::shared_ptr<const sf::Texture> baseTexture,
+        ResampleFilter filter, const std::string& tag, std::size_t maxLevels = 16);
+
+    /**
+     * @brief Wybiera poziom dla skali rysowania.
+     * @param scale Stosunek rozmiaru na ekranie do rozmiaru oryginału.
+     * @return Największy poziom nie mniejszy niż obraz na ekranie.
+     */
+    std::size_t selectLevel(float scale) const;
+
+    /**
+     * @brief Zwraca teksturę poziomu.
+     * @param level Numer poziomu (< getLevelCount()).
+     * @return Tekstura.
+     */
+    const sf::Texture& getLevel(std::size_t level) const { return *levels[level]; }
+
+    /**
+     * @brief Zwraca liczbę poziomów.
+     * @return Liczba poziomów.
+     */
+    std::size_t getLevelCount() const { return levels.size(); }
+};
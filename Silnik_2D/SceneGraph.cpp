@@ -0,0 +1,207 @@
+﻿#include "SceneGraph.hpp"
+#include <cmath>
+#include <stdexcept>
+
+// ------------------------------
+// Tworzenie i usuwanie węzłów
+// ------------------------------
+SceneNodeId SceneGraph::create(SceneNodeId parent) {
+    SceneNodeId id;
+    if (!freeNodes.empty()) {
+        id = freeNodes.back();
+        freeNodes.pop_back();
+        nodes[id] = SceneNode{};
+    }
+    else {
+        id = static_cast<SceneNodeId>(nodes.size());
+        nodes.emplace_back();
+        locals.emplace_back();
+        worlds.emplace_back();
+    }
+    nodes[id].alive = true;
+    link(id, parent);
+    return id;
+}
+
+void SceneGraph::destroy(SceneNodeId id) {
+    SceneNode& node = nodes[id];
+    if (!node.alive) return;
+
+    // Dzieci stają się korzeniami — ich macierze świata się zmieniają
+    SceneNodeId child = node.firstChild;
+    while (child != InvalidNode) {
+        SceneNodeId next = nodes[child].nextSibling;
+        nodes[child].parent = InvalidNode;
+        nodes[child].prevSibling = InvalidNode;
+        nodes[child].nextSibling = InvalidNode;
+        markDirty(child);
+        child = next;
+    }
+    node.firstChild = InvalidNode;
+
+    unlink(id);
+    node.alive = false;
+    freeNodes.push_back(id);
+}
+
+void SceneGraph::clear() {
+    nodes.clear();
+    locals.clear();
+    worlds.clear();
+    freeNodes.clear();
+}
+
+// ------------------------------
+// Hierarchia
+// ------------------------------
+void SceneGraph::link(SceneNodeId id, SceneNodeId parent) {
+    SceneNode& node = nodes[id];
+    node.parent = parent;
+    node.prevSibling = InvalidNode;
+    node.nextSibling = InvalidNode;
+    if (parent == InvalidNode) return;
+
+    SceneNodeId first = nodes[parent].firstChild;
+    node.nextSibling = first;
+    if (first != InvalidNode) nodes[first].prevSibling = id;
+    nodes[parent].firstChild = id;
+}
+
+void SceneGraph::unlink(SceneNodeId id) {
+    SceneNode& node = nodes[id];
+    if (node.prevSibling != InvalidNode)
+        nodes[node.prevSibling].nextSibling = node.nextSibling;
+    else if (node.parent != InvalidNode)
+        nodes[node.parent].firstChild = node.nextSibling;
+    if (node.nextSibling != InvalidNode)
+        nodes[node.nextSibling].prevSibling = node.prevSibling;
+
+    node.parent = InvalidNode;
+    node.prevSibling = InvalidNode;
+    node.nextSibling = InvalidNode;
+}
+
+void SceneGraph::setParent(SceneNodeId id, SceneNodeId parent) {
+    if (nodes[id].parent == parent) return;
+    for (SceneNodeId p = parent; p != InvalidNode; p = nodes[p].parent)
+        if (p == id)
+            throw std::runtime_error("SceneGraph: node cannot become its own descendant");
+
+    unlink(id);
+    link(id, parent);
+    markDirty(id);
+}
+
+// ------------------------------
+// Zmiana przekształceń lokalnych
+// ------------------------------
+void SceneGraph::setPosition(SceneNodeId id, sf::Vector2f position) {
+    nodes[id].position = position;
+    touch(id);
+}
+
+void SceneGraph::setRotation(SceneNodeId id, float degrees) {
+    nodes[id].rotation = degrees;
+    touch(id);
+}
+
+void SceneGraph::setScale(SceneNodeId id, sf::Vector2f scale) {
+    nodes[id].scale = scale;
+    touch(id);
+}
+
+void SceneGraph::setOrigin(SceneNodeId id, sf::Vector2f origin) {
+    nodes[id].origin = origin;
+    touch(id);
+}
+
+void SceneGraph::move(SceneNodeId id, sf::Vector2f offset) {
+    nodes[id].position += offset;
+    touch(id);
+}
+
+void SceneGraph::rotateAround(SceneNodeId id, float degrees, sf::Vector2f pivot) {
+    SceneNode& node = nodes[id];
+    float rad = degrees * 3.14159265f / 180.f;
+    float c = std::cos(rad), s = std::sin(rad);
+    sf::Vector2f d = node.position - pivot;
+    node.position = { pivot.x + d.x * c - d.y * s, pivot.y + d.x * s + d.y * c };
+    node.rotation += degrees;
+    touch(id);
+}
+
+void SceneGraph::scaleAround(SceneNodeId id, sf::Vector2f factors, sf::Vector2f pivot) {
+    SceneNode& node = nodes[id];
+    node.position = { pivot.x + (node.position.x - pivot.x) * factors.x,
+        pivot.y + (node.position.y - pivot.y) * factors.y };
+    node.scale = { node.scale.x * factors.x, node.scale.y * factors.y };
+    touch(id);
+}
+
+// ------------------------------
+// Flagi nieaktualności
+// ------------------------------
+void SceneGraph::touch(SceneNodeId id) {
+    nodes[id].localDirty = true;
+    markDirty(id);
+}
+
+void SceneGraph::markDirty(SceneNodeId id) {
+    // Oznaczony węzeł ma oznaczone całe poddrzewo — tam marsz się kończy
+    if (nodes[id].worldDirty) return;
+
+    stack.clear();
+    stack.push_back(id);
+    while (!stack.empty()) {
+        SceneNodeId n = stack.back();
+        stack.pop_back();
+        if (nodes[n].worldDirty) continue;
+        nodes[n].worldDirty = true;
+        for (SceneNodeId c = nodes[n].firstChild; c != InvalidNode; c = nodes[c].nextSibling)
+            stack.push_back(c);
+    }
+}
+
+// ------------------------------
+// Macierze lokalne i świata
+// ------------------------------
+const sf::Transform& SceneGraph::local(SceneNodeId id) {
+    SceneNode& node = nodes[id];
+    if (node.localDirty) {
+        // Jak sf::Transformable: przesunięcie * obrót * skala * (-origin)
+        float rad = node.rotation * 3.14159265f / 180.f;
+        float c = std::cos(rad), s = std::sin(rad);
+        float a00 = node.scale.x * c, a01 = -node.scale.y * s;
+        float a10 = node.scale.x * s, a11 = node.scale.y * c;
+        float tx = node.position.x - (a00 * node.origin.x + a01 * node.origin.y);
+        float ty = node.position.y - (a10 * node.origin.x + a11 * node.origin.y);
+        locals[id] = sf::Transform(a00, a01, tx, a10, a11, ty, 0.f, 0.f, 1.f);
+        node.localDirty = false;
+    }
+    return locals[id];
+}
+
+const sf::Transform& SceneGraph::getWorld(SceneNodeId id) {
+    if (!nodes[id].worldDirty) return worlds[id];
+
+    // Łańcuch nieaktualnych przodków, przeliczany od góry
+    stack.clear();
+    for (SceneNodeId n = id; n != InvalidNode && nodes[n].worldDirty; n = nodes[n].parent)
+        stack.push_back(n);
+
+    while (!stack.empty()) {
+        SceneNodeId n = stack.back();
+        stack.pop_back();
+        SceneNodeId parent = nodes[n].parent;
+        worlds[n] = parent == InvalidNode ? local(n) : worlds[parent] * local(n);
+        nodes[n].worldDirty = false;
+        ++worldUpdates;
+    }
+    return worlds[id];
+}
+
+void SceneGraph::updateWorld() {
+    for (SceneNodeId id = 0; id < nodes.size(); ++id)
+        if (nodes[id].alive && nodes[id].worldDirty)
+            getWorld(id);
+}
@@ -0,0 +1,175 @@
+﻿#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+
+using SceneNodeId = std::uint32_t; ///< Identyfikator węzła w SceneGraph.
+
+constexpr SceneNodeId InvalidNode = 0xFFFFFFFF; ///< Brak węzła (np. rodzic korzenia).
+
+/**
+ * @struct SceneNode
+ * @brief Węzeł grafu sceny: lokalne przekształcenie i powiązania z rodziną.
+ *
+ * Przekształcenie lokalne przechowywane jest w składowych (jak w
+ * sf::Transformable) i składane do macierzy dopiero przy odczycie.
+ */
+struct SceneNode {
+    sf::Vector2f position{ 0.f, 0.f }; ///< Położenie względem rodzica.
+    sf::Vector2f origin{ 0.f, 0.f };   ///< Punkt odniesienia obrotu i skali (układ lokalny).
+    sf::Vector2f scale{ 1.f, 1.f };    ///< Skala.
+    float rotation = 0.f;              ///< Obrót w stopniach (zgodnie ze wskazówkami zegara w SFML).
+
+    SceneNodeId parent = InvalidNode;      ///< Rodzic.
+    SceneNodeId firstChild = InvalidNode;  ///< Pierwsze dziecko.
+    SceneNodeId nextSibling = InvalidNode; ///< Następne rodzeństwo.
+    SceneNodeId prevSibling = InvalidNode; ///< Poprzednie rodzeństwo.
+
+    bool localDirty = true; ///< Czy macierz lokalna wymaga przeliczenia.
+    bool worldDirty = true; ///< Czy macierz świata wymaga przeliczenia.
+    bool alive = false;     ///< Czy miejsce jest zajęte.
+};
+
+/**
+ * @class SceneGraph
+ * @brief Hierarchia przekształceń z leniwie liczonymi macierzami świata.
+ *
+ * Każdy węzeł ma przekształcenie lokalne (względem rodzica); macierz świata
+ * jest iloczynem macierzy przodków i liczona jest dopiero przy getWorld().
+ * Zmiana węzła oznacza jako nieaktualne tylko jego poddrzewo, a marsz
+ * zatrzymuje się na węzłach już oznaczonych — nieaktualny węzeł ma zawsze
+ * nieaktualnych wszystkich potomków. Przesunięcie rodzica z tysiącami dzieci
+ * kosztuje więc jedną zmianę składowych i przejście ustawiające flagi.
+ */
+class SceneGraph {
+private:
+    std::vector<SceneNode> nodes;       ///< Węzły (indeksowane identyfikatorem).
+    std::vector<sf::Transform> locals;  ///< Macierze lokalne (pamięć podręczna).
+    std::vector<sf::Transform> worlds;  ///< Macierze świata (pamięć podręczna).
+    std::vector<SceneNodeId> freeNodes; ///< Zwolnione miejsca do ponownego użycia.
+    std::vector<SceneNodeId> stack;     ///< Bufor roboczy przejść po drzewie.
+    std::size_t worldUpdates = 0;       ///< Liczba przeliczonych macierzy świata.
+
+    /**
+     * @brief Oznacza lokalną macierz węzła i macierze świata poddrzewa jako nieaktualne.
+     * @param id Węzeł.
+     */
+    void touch(SceneNodeId id);
+
+    /**
+     * @brief Oznacza macierze świata poddrzewa jako nieaktualne.
+     * @param id Korzeń poddrzewa.
+     */
+    void markDirty(SceneNodeId id);
+
+    /**
+     * @brief Dopina węzeł na początek listy dzieci rodzica.
+     * @param id Węzeł (bez rodzica).
+     * @param parent Rodzic (InvalidNode — brak).
+     */
+    void link(SceneNodeId id, SceneNodeId parent);
+
+    /**
+     * @brief Wypina węzeł z listy dzieci rodzica.
+     * @param id Węzeł.
+     */
+    void unlink(SceneNodeId id);
+
+    /**
+     * @brief Zwraca macierz lokalną, przeliczając ją w razie potrzeby.
+     * @param id Węzeł.
+     * @return Macierz lokalna.
+     */
+    const sf::Transform& local(SceneNodeId id);
+
+public:
+    /**
+     * @brief Tworzy węzeł z przekształceniem tożsamościowym.
+     * @param parent Rodzic (InvalidNode — korzeń).
+     * @return Identyfikator węzła.
+     */
+    SceneNodeId create(SceneNodeId parent = InvalidNode);
+
+    /**
+     * @brief Usuwa węzeł; jego dzieci stają się korzeniami (z zachowaniem przekształceń lokalnych).
+     * @param id Węzeł.
+     */
+    void destroy(SceneNodeId id);
+
+    /**
+     * @brief Przepina węzeł pod innego rodzica.
+     * @param id Węzeł.
+     * @param parent Nowy rodzic (InvalidNode — korzeń).
+     * @throws std::runtime_error jeśli powstałby cykl.
+     */
+    void setParent(SceneNodeId id, SceneNodeId parent);
+
+    /**
+     * @brief Zwraca rodzica węzła.
+     * @param id Węzeł.
+     * @return Rodzic lub InvalidNode.
+     */
+    SceneNodeId getParent(SceneNodeId id) const { return nodes[id].parent; }
+
+    /**
+     * @brief Zwraca składowe przekształcenia lokalnego.
+     * @param id Węzeł.
+     * @return Węzeł (tylko do odczytu).
+     */
+    const SceneNode& getNode(SceneNodeId id) const { return nodes[id]; }
+
+    void setPosition(SceneNodeId id, sf::Vector2f position); ///< Ustawia położenie względem rodzica.
+    void setRotation(SceneNodeId id, float degrees);         ///< Ustawia obrót.
+    void setScale(SceneNodeId id, sf::Vector2f scale);       ///< Ustawia skalę.
+    void setOrigin(SceneNodeId id, sf::Vector2f origin);     ///< Ustawia punkt odniesienia.
+    void move(SceneNodeId id, sf::Vector2f offset);          ///< Przesuwa węzeł.
+
+    /**
+     * @brief Obraca węzeł wokół punktu w układzie rodzica.
+     * @param id Węzeł.
+     * @param degrees Kąt w stopniach.
+     * @param pivot Punkt obrotu.
+     */
+    void rotateAround(SceneNodeId id, float degrees, sf::Vector2f pivot);
+
+    /**
+     * @brief Skaluje węzeł względem punktu w układzie rodzica.
+     *
+     * Dokładne dla skali jednorodnej lub węzła bez obrotu; w pozostałych
+     * przypadkach skala stosowana jest w osiach węzła (bez ścinania).
+     *
+     * @param id Węzeł.
+     * @param factors Współczynniki skali.
+     * @param pivot Punkt skalowania.
+     */
+    void scaleAround(SceneNodeId id, sf::Vector2f factors, sf::Vector2f pivot);
+
+    /**
+     * @brief Zwraca macierz świata, przeliczając nieaktualnych przodków.
+     * @param id Węzeł.
+     * @return Macierz świata.
+     */
+    const sf::Transform& getWorld(SceneNodeId id);
+
+    /**
+     * @brief Przelicza wszystkie nieaktualne macierze świata.
+     */
+    void updateWorld();
+
+    /**
+     * @brief Usuwa wszystkie węzły.
+     */
+    void clear();
+
+    /**
+     * @brief Zwraca liczbę żywych węzłów.
+     * @return Liczba węzłów.
+     */
+    std::size_t getNodeCount() const { return nodes.size() - freeNodes.size(); }
+
+    /**
+     * @brief Zwraca łączną liczbę przeliczeń macierzy świata (diagnostyka).
+     * @return Liczba przeliczeń.
+     */
+    std::size_t getWorldUpdateCount() const { return worldUpdates; }
+};
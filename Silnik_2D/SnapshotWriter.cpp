@@ -0,0 +1,277 @@
+﻿#include "SnapshotWriter.hpp"
+#include <fstream>
+#include <chrono>
+#include <array>
+#include <algorithm>
+#include <string_view>
+
+// ------------------------------
+// Pomocnicze funkcje kodowania
+// ------------------------------
+namespace {
+
+// Zapis liczby 32-bitowej w kolejności big-endian
+void putU32BE(std::vector<std::uint8_t>& out, std::uint32_t v) {
+    out.push_back(static_cast<std::uint8_t>(v >> 24));
+    out.push_back(static_cast<std::uint8_t>(v >> 16));
+    out.push_back(static_cast<std::uint8_t>(v >> 8));
+    out.push_back(static_cast<std::uint8_t>(v));
+}
+
+// Tablica CRC32 wykorzystywana przez fragmenty PNG
+const std::array<std::uint32_t, 256>& crcTable() {
+    static const std::array<std::uint32_t, 256> table = [] {
+        std::array<std::uint32_t, 256> t{};
+        for (std::uint32_t n = 0; n < 256; ++n) {
+            std::uint32_t c = n;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[n] = c;
+        }
+        return t;
+    }();
+    return table;
+}
+
+// Dopisanie fragmentu PNG (długość, typ, dane, CRC)
+void putPngChunk(std::vector<std::uint8_t>& out, const char type[4], const std::uint8_t* data, std::size_t size) {
+    putU32BE(out, static_cast<std::uint32_t>(size));
+    std::size_t crcStart = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data, data + size);
+
+    std::uint32_t crc = 0xFFFFFFFFu;
+    for (std::size_t i = crcStart; i < out.size(); ++i)
+        crc = crcTable()[(crc ^ out[i]) & 0xFF] ^ (crc >> 8);
+    putU32BE(out, crc ^ 0xFFFFFFFFu);
+}
+
+bool writeBytes(const std::string& filename, const std::vector<std::uint8_t>& bytes) {
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return static_cast<bool>(file);
+}
+
+// Kodowanie koderem SFML wskazanym jawnie (niezależnie od rozszerzenia pliku)
+bool writeEncoded(const sf::Image& image, const std::string& filename, std::string_view encoder) {
+    auto bytes = image.saveToMemory(encoder);
+    return bytes && writeBytes(filename, *bytes);
+}
+
+} // namespace
+
+// ------------------------------
+// Wątek roboczy
+// ------------------------------
+SnapshotWriter::SnapshotWriter()
+    : worker(&SnapshotWriter::workerLoop, this) {
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobReady.notify_one();
+    if (worker.joinable())
+        worker.join();
+}
+
+void SnapshotWriter::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        jobReady.wait(lock, [this] { return stopping || !jobs.empty(); });
+        if (jobs.empty()) break; // stopping i pusta kolejka
+
+        Job job = std::move(jobs.front());
+        jobs.pop_front();
+        busy = true;
+        lock.unlock();
+
+        auto start = std::chrono::steady_clock::now();
+        bool ok = write(job.image, job.filename, job.format);
+        float elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+
+        lock.lock();
+        results.push_back({ job.filename, job.format, ok, elapsed });
+        busy = false;
+        if (jobs.empty())
+            idle.notify_all();
+    }
+    idle.notify_all();
+}
+
+bool SnapshotWriter::write(const sf::Image& image, const std::string& filename, SnapshotFormat format) {
+    switch (format) {
+    case SnapshotFormat::Qoi:
+        return writeBytes(filename, encodeQoi(image));
+    case SnapshotFormat::PngUncompressed:
+        return writeBytes(filename, encodePngUncompressed(image));
+    case SnapshotFormat::Png:
+        return writeEncoded(image, filename, "png");
+    case SnapshotFormat::Bmp:
+        return writeEncoded(image, filename, "bmp");
+    }
+    return false;
+}
+
+// ------------------------------
+// Kolejka zleceń
+// ------------------------------
+void SnapshotWriter::submit(sf::Image image, const std::string& filename, SnapshotFormat format) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back({ std::move(image), filename, format });
+    }
+    jobReady.notify_one();
+}
+
+std::vector<SnapshotResult> SnapshotWriter::collectResults() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<SnapshotResult> out;
+    out.swap(results);
+    return out;
+}
+
+void SnapshotWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return jobs.empty() && !busy; });
+}
+
+std::size_t SnapshotWriter::pending() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return jobs.size() + (busy ? 1 : 0);
+}
+
+// ------------------------------
+// Koder QOI (https://qoiformat.org)
+// ------------------------------
+std::vector<std::uint8_t> SnapshotWriter::encodeQoi(const sf::Image& image) {
+    const sf::Vector2u size = image.getSize();
+    const std::uint8_t* px = image.getPixelsPtr();
+    const std::size_t count = static_cast<std::size_t>(size.x) * size.y;
+
+    std::vector<std::uint8_t> out;
+    out.reserve(14 + count * 2 + 8);
+    out.insert(out.end(), { 'q', 'o', 'i', 'f' });
+    putU32BE(out, size.x);
+    putU32BE(out, size.y);
+    out.push_back(4); // RGBA
+    out.push_back(0); // sRGB z liniową alfą
+
+    // Specyfikacja wymaga indeksu wyzerowanego (0, 0, 0, 0) — sf::Color domyślnie ma alfę 255
+    std::array<sf::Color, 64> index;
+    index.fill(sf::Color(0, 0, 0, 0));
+    sf::Color prev(0, 0, 0, 255);
+    int run = 0;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::uint8_t* p = px + i * 4;
+        sf::Color c(p[0], p[1], p[2], p[3]);
+
+        if (c == prev) {
+            if (++run == 62 || i + 1 == count) {
+                out.push_back(static_cast<std::uint8_t>(0xC0 | (run - 1)));
+                run = 0;
+            }
+            continue;
+        }
+        if (run > 0) {
+            out.push_back(static_cast<std::uint8_t>(0xC0 | (run - 1)));
+            run = 0;
+        }
+
+        int hash = (c.r * 3 + c.g * 5 + c.b * 7 + c.a * 11) % 64;
+        if (index[hash] == c) {
+            out.push_back(static_cast<std::uint8_t>(hash));
+        }
+        else {
+            index[hash] = c;
+            if (c.a == prev.a) {
+                int dr = static_cast<std::int8_t>(c.r - prev.r);
+                int dg = static_cast<std::int8_t>(c.g - prev.g);
+                int db = static_cast<std::int8_t>(c.b - prev.b);
+                int drg = dr - dg;
+                int dbg = db - dg;
+
+                if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                    out.push_back(static_cast<std::uint8_t>(0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+                }
+                else if (dg >= -32 && dg <= 31 && drg >= -8 && drg <= 7 && dbg >= -8 && dbg <= 7) {
+                    out.push_back(static_cast<std::uint8_t>(0x80 | (dg + 32)));
+                    out.push_back(static_cast<std::uint8_t>((drg + 8) << 4 | (dbg + 8)));
+                }
+                else {
+                    out.insert(out.end(), { 0xFE, c.r, c.g, c.b });
+                }
+            }
+            else {
+                out.insert(out.end(), { 0xFF, c.r, c.g, c.b, c.a });
+            }
+        }
+        prev = c;
+    }
+
+    out.insert(out.end(), { 0, 0, 0, 0, 0, 0, 0, 1 });
+    return out;
+}
+
+// ------------------------------
+// Koder PNG bez kompresji
+// ------------------------------
+std::vector<std::uint8_t> SnapshotWriter::encodePngUncompressed(const sf::Image& image) {
+    const sf::Vector2u size = image.getSize();
+    const std::uint8_t* px = image.getPixelsPtr();
+    const std::size_t rowBytes = static_cast<std::size_t>(size.x) * 4;
+
+    // Surowe dane: bajt filtra (0 = brak) + wiersz pikseli
+    std::vector<std::uint8_t> raw;
+    raw.reserve((rowBytes + 1) * size.y);
+    for (unsigned int y = 0; y < size.y; ++y) {
+        raw.push_back(0);
+        raw.insert(raw.end(), px + y * rowBytes, px + (y + 1) * rowBytes);
+    }
+
+    // Strumień zlib z blokami "stored" (maks. 65535 bajtów na blok)
+    std::vector<std::uint8_t> zlib;
+    zlib.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+    zlib.push_back(0x78);
+    zlib.push_back(0x01);
+    std::size_t offset = 0;
+    do {
+        std::size_t len = std::min<std::size_t>(65535, raw.size() - offset);
+        bool last = offset + len == raw.size();
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back(static_cast<std::uint8_t>(len));
+        zlib.push_back(static_cast<std::uint8_t>(len >> 8));
+        zlib.push_back(static_cast<std::uint8_t>(~len));
+        zlib.push_back(static_cast<std::uint8_t>(~len >> 8));
+        zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + len);
+        offset += len;
+    } while (offset < raw.size());
+
+    // Adler-32 — modulo liczone co 5552 bajty (maksimum bez przepełnienia)
+    std::uint32_t a = 1, b = 0;
+    for (std::size_t i = 0; i < raw.size();) {
+        std::size_t end = std::min(raw.size(), i + 5552);
+        for (; i < end; ++i) {
+            a += raw[i];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    putU32BE(zlib, (b << 16) | a);
+
+    std::vector<std::uint8_t> out = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    std::vector<std::uint8_t> ihdr;
+    putU32BE(ihdr, size.x);
+    putU32BE(ihdr, size.y);
+    ihdr.insert(ihdr.end(), { 8, 6, 0, 0, 0 }); // 8 bitów, RGBA, deflate, bez filtra, bez przeplotu
+
+    putPngChunk(out, "IHDR", ihdr.data(), ihdr.size());
+    putPngChunk(out, "IDAT", zlib.data(), zlib.size());
+    putPngChunk(out, "IEND", nullptr, 0);
+    return out;
+}
@@ -0,0 +1,136 @@
+﻿#pragma once
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+#include <deque>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/**
+ * @enum SnapshotFormat
+ * @brief Format zapisywanego zrzutu.
+ *
+ * Format wybiera koder niezależnie od rozszerzenia nazwy pliku. Poziomu
+ * kompresji deflate nie da się ustawić — koder PNG z SFML go nie udostępnia;
+ * kompromis rozmiar/czas wybiera się formatem:
+ * - Png: PNG z kompresją SFML — najmniejszy plik, najwolniejsze kodowanie.
+ * - PngUncompressed: PNG z blokami deflate typu "stored" (poziom 0) — czytelny
+ *   przez każdy program, kodowanie praktycznie sprowadza się do memcpy.
+ * - Qoi: format QOI — bardzo szybkie kodowanie, umiarkowana kompresja.
+ *   Przeznaczony do częstych, cyklicznych zrzutów.
+ * - Bmp: surowa bitmapa bez kompresji.
+ */
+enum class SnapshotFormat { Png, PngUncompressed, Qoi, Bmp };
+
+/**
+ * @struct SnapshotResult
+ * @brief Wynik zakończonego zapisu zrzutu, raportowany przez SnapshotWriter.
+ */
+struct SnapshotResult {
+    std::string filename;   ///< Nazwa zapisanego pliku.
+    SnapshotFormat format;  ///< Użyty format.
+    bool success = false;   ///< Czy zapis się powiódł.
+    float encodeSeconds = 0.f; ///< Czas kodowania i zapisu w sekundach.
+};
+
+/**
+ * @class SnapshotWriter
+ * @brief Kodowanie i zapis zrzutów canvasu w wątku tła.
+ *
+ * Wątek główny jedynie przechwytuje piksele (sf::Image) i przekazuje je
+ * do kolejki. Wątek roboczy koduje obraz w wybranym formacie i zapisuje
+ * go na dysk, a wyniki odkłada do listy odbieranej przez collectResults().
+ */
+class SnapshotWriter {
+private:
+    /**
+     * @struct Job
+     * @brief Pojedyncze zlecenie zapisu.
+     */
+    struct Job {
+        sf::Image image;       ///< Przechwycone piksele.
+        std::string filename;  ///< Plik docelowy.
+        SnapshotFormat format; ///< Format zapisu.
+    };
+
+    mutable std::mutex mutex;            ///< Ochrona kolejki i wyników.
+    std::condition_variable jobReady;    ///< Sygnał pojawienia się zlecenia.
+    std::condition_variable idle;        ///< Sygnał opróżnienia kolejki.
+    std::deque<Job> jobs;                ///< Oczekujące zlecenia.
+    std::vector<SnapshotResult> results; ///< Zakończone zapisy do odebrania.
+    bool busy = false;                   ///< Czy wątek przetwarza zlecenie.
+    bool stopping = false;               ///< Flaga zakończenia wątku.
+    std::thread worker;                  ///< Wątek kodujący (inicjalizowany jako ostatni).
+
+    /**
+     * @brief Pętla wątku roboczego.
+     */
+    void workerLoop();
+
+public:
+    /**
+     * @brief Uruchamia wątek kodujący.
+     */
+    SnapshotWriter();
+
+    /**
+     * @brief Zapisuje wszystkie oczekujące zrzuty i kończy wątek.
+     */
+    ~SnapshotWriter();
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    /**
+     * @brief Dodaje obraz do kolejki zapisu.
+     *
+     * Obraz jest przenoszony — wywołanie nie kopiuje pikseli ani nie czeka na zapis.
+     *
+     * @param image Przechwycone piksele.
+     * @param filename Plik docelowy.
+     * @param format Format zapisu.
+     */
+    void submit(sf::Image image, const std::string& filename, SnapshotFormat format = SnapshotFormat::Png);
+
+    /**
+     * @brief Odbiera wyniki zapisów zakończonych od poprzedniego wywołania.
+     * @return Lista wyników.
+     */
+    std::vector<SnapshotResult> collectResults();
+
+    /**
+     * @brief Blokuje do momentu zapisania wszystkich zleceń z kolejki.
+     */
+    void flush();
+
+    /**
+     * @brief Zwraca liczbę zleceń oczekujących lub w trakcie zapisu.
+     * @return Liczba zleceń.
+     */
+    std::size_t pending() const;
+
+    /**
+     * @brief Koduje i zapisuje obraz w zadanym formacie (synchronicznie, w bieżącym wątku).
+     * @param image Obraz.
+     * @param filename Plik docelowy.
+     * @param format Format zapisu.
+     * @return true jeśli zapis się powiódł.
+     */
+    static bool write(const sf::Image& image, const std::string& filename, SnapshotFormat format);
+
+    /**
+     * @brief Koduje obraz w formacie QOI.
+     * @param image Obraz źródłowy.
+     * @return Zakodowane bajty pliku.
+     */
+    static std::vector<std::uint8_t> encodeQoi(const sf::Image& image);
+
+    /**
+     * @brief Koduje obraz jako PNG bez kompresji (deflate "stored").
+     * @param image Obraz źródłowy.
+     * @return Zakodowane bajty pliku.
+     */
+    static std::vector<std::uint8_t> encodePngUncompressed(const sf::Image& image);
+};
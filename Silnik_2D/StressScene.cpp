@@ -0,0 +1,252 @@
+﻿#include "StressScene.hpp"
+#include "Engine.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+namespace {
+/**
+ * @class RotatingShape
+ * @brief Kształt bez własnej logiki obracany wokół punktu w każdej klatce.
+ */
+template <typename Shape>
+class RotatingShape : public UpdatableObject, public DrawableObject {
+private:
+    Shape shape;          ///< Obracany kształt.
+    sf::Vector2f pivot;   ///< Punkt obrotu.
+    float degPerSec;      ///< Prędkość obrotowa.
+
+public:
+    RotatingShape(Shape s, sf::Vector2f p, float speed) : shape(std::move(s)), pivot(p), degPerSec(speed) {}
+    void update(float dt) override { shape.rotate(degPerSec * dt, pivot); }
+    void draw(PrimitiveRenderer& renderer) override { shape.draw(renderer); }
+};
+
+/**
+ * @class SpinningNode
+ * @brief Koło w grafie sceny obracane wokół własnego środka — dzieci krążą razem z nim.
+ */
+class SpinningNode : public SceneCircle {
+private:
+    float degPerSec; ///< Prędkość obrotowa.
+
+public:
+    SpinningNode(SceneGraph& graph, float r, sf::Color col, float speed, SceneNodeId parent = InvalidNode)
+        : SceneCircle(graph, r, col, parent), degPerSec(speed) {}
+    void update(float dt) override { scene.setRotation(node, scene.getNode(node).rotation + degPerSec * dt); }
+};
+
+/**
+ * @brief Zachowanie skryptowane: długie przerwy i krótkie przesunięcia.
+ *
+ * Przez większość czasu korutyna śpi w budziku harmonogramu i nie jest
+ * wznawiana; kończy się, gdy obiekt przestanie istnieć.
+ */
+Behaviour wander(Engine& engine, ObjectHandle handle, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> pause(0.5f, 3.f), angle(0.f, 6.2831853f);
+    for (;;) {
+        co_await Sleep{ pause(rng) };
+        const float a = angle(rng);
+        for (float moved = 0.f; moved < 0.25f;) {
+            const float dt = co_await NextFrame{};
+            auto* circle = dynamic_cast<Okreg*>(engine.getObject(handle));
+            if (!circle) co_return;
+            circle->translate(std::cos(a) * 80.f * dt, std::sin(a) * 80.f * dt);
+            moved += dt;
+        }
+    }
+}
+
+using Clock = std::chrono::steady_clock;
+
+double ms(Clock::duration d) {
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+} // namespace
+
+// ------------------------------
+// Konstruktor i nazwy populacji
+// ------------------------------
+StressScene::StressScene(Engine& e, StressConfig c) : engine(e), config(std::move(c)) {
+}
+
+const char* StressScene::name(StressPopulation population) {
+    switch (population) {
+    case StressPopulation::Movers:  return "movers";
+    case StressPopulation::Circles: return "circles";
+    case StressPopulation::Lines:   return "lines";
+    case StressPopulation::Sprites: return "sprites";
+    case StressPopulation::Scripted: return "scripted";
+    case StressPopulation::Hierarchy: return "hierarchy";
+    case StressPopulation::Fills:   return "fills";
+    }
+    return "unknown";
+}
+
+// ------------------------------
+// Budowa sceny
+// ------------------------------
+void StressScene::build(StressPopulation population, unsigned int count, unsigned int seed) {
+    const sf::Vector2f size(engine.getCanvasSize());
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> x(0.f, size.x), y(0.f, size.y);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    auto color = [&] { return sf::Color(rng() & 0xFF, rng() & 0xFF, rng() & 0xFF); };
+
+    switch (population) {
+    case StressPopulation::Movers:
+        for (unsigned int i = 0; i < count; ++i)
+            engine.execute(DrawCommand::spawnOkreg({ x(rng), y(rng) }, 4.f + 12.f * unit(rng), color(),
+                20.f + 80.f * unit(rng), 6.2831853f * unit(rng), 180.f * unit(rng)));
+        break;
+
+    case StressPopulation::Circles:
+        for (unsigned int i = 0; i < count; ++i) {
+            sf::Vector2f c(x(rng), y(rng));
+            engine.spawn<RotatingShape<CircleShapeObject>>(CircleShapeObject(c, 4.f + 12.f * unit(rng), color()),
+                c + sf::Vector2f(10.f, 0.f), 90.f);
+        }
+        break;
+
+    case StressPopulation::Lines:
+        for (unsigned int i = 0; i < count; ++i) {
+            sf::Vector2f a(x(rng), y(rng));
+            sf::Vector2f b = a + sf::Vector2f(64.f * unit(rng) - 32.f, 64.f * unit(rng) - 32.f);
+            engine.spawn<RotatingShape<Line>>(Line(a, b, color()), (a + b) / 2.f, 45.f);
+        }
+        break;
+
+    case StressPopulation::Sprites: {
+        // Wspólny klip z czterech jednolitych klatek, tworzony przy pierwszej
+        // budowie (AnimationSystem nie zwalnia klipów). Kolory są losowane
+        // zawsze, aby układ sceny dla danego ziarna się nie zmieniał.
+        std::vector<sf::Color> tints(4);
+        for (auto& tint : tints) tint = color();
+        if (spriteClip == InvalidClip) {
+            std::vector<BitmapHandler> frames(tints.size());
+            for (std::size_t i = 0; i < frames.size(); ++i) frames[i].create(24, 24, tints[i]);
+            spriteClip = engine.getAnimations().createClip(frames, 0.1f);
+        }
+        for (unsigned int i = 0; i < count; ++i) {
+            ObjectHandle h = engine.spawn<SpriteObject>(engine.getAnimations(), spriteClip, 0.5f + unit(rng));
+            if (auto* sprite = dynamic_cast<SpriteObject*>(engine.getObject(h)))
+                sprite->translate(x(rng), y(rng));
+        }
+        break;
+    }
+
+    case StressPopulation::Scripted:
+        for (unsigned int i = 0; i < count; ++i) {
+            ObjectHandle h = engine.spawn<Okreg>(sf::Vector2f{ x(rng), y(rng) }, 4.f + 12.f * unit(rng), color());
+            engine.getBehaviours().start(wander(engine, h, seed + i));
+        }
+        break;
+
+    case StressPopulation::Hierarchy:
+        // Piasty po 8 węzłów: obracająca się piasta i siedmiu krążących satelitów
+        for (unsigned int i = 0; i < count; i += 8) {
+            ObjectHandle hub = engine.spawn<SpinningNode>(engine.getScene(), 6.f + 6.f * unit(rng), color(),
+                45.f + 90.f * unit(rng));
+            auto* parent = dynamic_cast<SceneObject*>(engine.getObject(hub));
+            if (!parent) break;
+            parent->translate(x(rng), y(rng));
+            for (unsigned int c = 1; c < 8 && i + c < count; ++c) {
+                ObjectHandle child = engine.spawn<SceneCircle>(engine.getScene(), 3.f + 3.f * unit(rng), color(),
+                    parent->getNode());
+                if (auto* satellite = dynamic_cast<SceneObject*>(engine.getObject(child)))
+                    satellite->translate(20.f + 20.f * unit(rng), 0.f);
+            }
+        }
+        break;
+
+    case StressPopulation::Fills:
+        break; // praca zlecana co klatkę w perFrame()
+    }
+}
+
+void StressScene::perFrame(StressPopulation population, unsigned int count, int frame) {
+    if (population != StressPopulation::Fills) return;
+
+    // Kanwa dzielona losowymi odcinkami na obszary, potem N losowych wypełnień
+    const sf::Vector2f size(engine.getCanvasSize());
+    std::mt19937 rng(config.seed + frame);
+    std::uniform_real_distribution<float> x(0.f, size.x), y(0.f, size.y);
+    const sf::Color palette[] = { sf::Color::Red, sf::Color::Green, sf::Color::Blue,
+        sf::Color::Yellow, sf::Color::Cyan, sf::Color::Magenta };
+
+    engine.execute(DrawCommand::clearCanvas());
+    for (unsigned int i = 0; i < std::max(1u, count / 8); ++i)
+        engine.execute(DrawCommand::line({ x(rng), y(rng) }, { x(rng), y(rng) }));
+    for (unsigned int i = 0; i < count; ++i)
+        engine.execute(DrawCommand::fill({ x(rng), y(rng) }, palette[i % 6]));
+}
+
+// ------------------------------
+// Przebieg pomiarowy
+// ------------------------------
+bool StressScene::run() {
+    std::ofstream csv(config.output);
+    if (!csv) {
+        std::cerr << "Nie udało się otworzyć pliku: " << config.output << std::endl;
+        return false;
+    }
+    csv << "population,n,frames,frame_ms,frame_p95_ms,update_ms,render_ms,frame_ratio\n";
+
+    engine.init();
+    engine.setTargetFps(0); // bez limitu — mierzymy koszt, nie tempo
+    const float dt = 1.f / 60.f; // stały krok, niezależny od obciążenia
+
+    for (StressPopulation population : config.populations) {
+        unsigned int limit = population == StressPopulation::Fills ? std::min(config.maxCount, config.maxFillCount)
+            : config.maxCount;
+        double previousFrame = 0.0;
+
+        for (unsigned int n = config.minCount; n <= limit; n *= 2) {
+            engine.clearObjects();
+            engine.execute(DrawCommand::clearCanvas());
+            build(population, n, config.seed + n);
+
+            std::vector<double> frameTimes;
+            double updateSum = 0.0, renderSum = 0.0;
+            for (int f = 0; f < config.warmupFrames + config.measuredFrames; ++f) {
+                if (!engine.isOpen()) return false;
+
+                Clock::time_point start = Clock::now();
+                engine.handleInput();
+                perFrame(population, n, f);
+                Clock::time_point afterInput = Clock::now();
+                engine.update(dt);
+                Clock::time_point afterUpdate = Clock::now();
+                engine.render();
+                Clock::time_point end = Clock::now();
+
+                if (f >= config.warmupFrames) {
+                    frameTimes.push_back(ms(end - start));
+                    updateSum += ms(afterUpdate - afterInput);
+                    renderSum += ms(end - afterUpdate);
+                }
+            }
+
+            if (frameTimes.empty()) continue;
+            double mean = 0.0;
+            for (double t : frameTimes) mean += t;
+            mean /= frameTimes.size();
+            std::sort(frameTimes.begin(), frameTimes.end());
+            double p95 = frameTimes[std::min(frameTimes.size() - 1, frameTimes.size() * 95 / 100)];
+            double ratio = previousFrame > 0.0 ? mean / previousFrame : 1.0;
+            previousFrame = mean;
+
+            csv << name(population) << "," << n << "," << frameTimes.size() << "," << mean << "," << p95 << ","
+                << updateSum / frameTimes.size() << "," << renderSum / frameTimes.size() << "," << ratio << "\n";
+            std::cout << "[Stress] " << name(population) << " n=" << n << ": " << mean << " ms"
+                << (ratio > 2.5 ? "  (superlinear)" : "") << "\n";
+        }
+    }
+
+    engine.clearObjects();
+    return static_cast<bool>(csv);
+}
@@ -0,0 +1,92 @@
+﻿#pragma once
+#include "Animation.hpp"
+#include <string>
+#include <vector>
+
+class Engine;
+
+/**
+ * @enum StressPopulation
+ * @brief Rodzaje populacji generowanych przez StressScene.
+ */
+enum class StressPopulation {
+    Movers,  ///< Ruchome okręgi Okreg (setMovement + setRotation).
+    Circles, ///< Obracające się CircleShapeObject.
+    Lines,   ///< Obracające się odcinki Line.
+    Sprites, ///< Animowane SpriteObject ze wspólnym klipem.
+    Scripted, ///< Okreg sterowane korutynami (głównie uśpione, krótkie ruchy).
+    Hierarchy, ///< Obracające się węzły SceneCircle z dziećmi w grafie sceny.
+    Fills    ///< Losowe wypełnienia warstwy statycznej w każdej klatce.
+};
+
+/**
+ * @struct StressConfig
+ * @brief Parametry przebiegu testu obciążeniowego.
+ */
+struct StressConfig {
+    std::string output = "stress.csv";  ///< Plik wynikowy CSV.
+    unsigned int minCount = 16;         ///< Najmniejsze N (potęga dwójki).
+    unsigned int maxCount = 16384;      ///< Największe N.
+    unsigned int maxFillCount = 1024;   ///< Największe N dla wypełnień (każde wymaga pracy na CPU).
+    int warmupFrames = 10;              ///< Klatki pomijane po zmianie populacji.
+    int measuredFrames = 60;            ///< Klatki mierzone dla każdego N.
+    unsigned int seed = 1234;           ///< Ziarno generatora sceny.
+    std::vector<StressPopulation> populations = {
+        StressPopulation::Movers, StressPopulation::Circles, StressPopulation::Lines,
+        StressPopulation::Sprites, StressPopulation::Scripted, StressPopulation::Hierarchy,
+        StressPopulation::Fills };
+};
+
+/**
+ * @class StressScene
+ * @brief Generator syntetycznych scen do badania skalowania podsystemów.
+ *
+ * Dla każdej populacji zwiększa N w potęgach dwójki, buduje scenę od zera,
+ * odrzuca klatki rozgrzewające i mierzy czas klatki, aktualizacji
+ * i renderowania. Wyniki trafiają do pliku CSV — kolumna frame_ratio
+ * (czas klatki względem poprzedniego N) powyżej ~2 wskazuje miejsce,
+ * w którym podsystem przestaje skalować się liniowo.
+ */
+class StressScene {
+private:
+    Engine& engine;      ///< Silnik, w którym budowana jest scena.
+    StressConfig config; ///< Parametry przebiegu.
+    ClipId spriteClip = InvalidClip; ///< Klip populacji Sprites (tworzony raz, używany przez kolejne budowy).
+
+    /**
+     * @brief Tworzy populację N obiektów danego rodzaju.
+     * @param population Rodzaj populacji.
+     * @param count Liczba obiektów.
+     * @param seed Ziarno generatora.
+     */
+    void build(StressPopulation population, unsigned int count, unsigned int seed);
+
+    /**
+     * @brief Zleca pracę wykonywaną co klatkę (wypełnienia).
+     * @param population Rodzaj populacji.
+     * @param count Liczba obiektów.
+     * @param frame Numer klatki (ziarno).
+     */
+    void perFrame(StressPopulation population, unsigned int count, int frame);
+
+public:
+    /**
+     * @brief Konstruktor.
+     * @param engine Silnik.
+     * @param config Parametry przebiegu.
+     */
+    StressScene(Engine& engine, StressConfig config = {});
+
+    /**
+     * @brief Wykonuje cały przebieg i zapisuje CSV.
+     * @return true jeśli zapis się powiódł i przebieg nie został przerwany.
+     */
+    bool run();
+
+    /**
+     * @brief Nazwa populacji (kolumna CSV).
+     * @param population Rodzaj populacji.
+     * @return Nazwa tekstowa.
+     */
+    static const char* name(StressPopulation population);
+};
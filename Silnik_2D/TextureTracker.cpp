@@ -0,0 +1,179 @@
+﻿#include "TextureTracker.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <iostream>
+
+namespace {
+std::size_t textureBytes(const sf::Texture* texture) {
+    const sf::Vector2u size = texture->getSize();
+    return static_cast<std::size_t>(size.x) * size.y * 4;
+}
+
+std::string megabytes(std::size_t bytes) {
+    std::ostringstream s;
+    s << std::fixed << std::setprecision(2) << bytes / (1024.0 * 1024.0) << " MB";
+    return s.str();
+}
+} // namespace
+
+TextureTracker& TextureTracker::get() {
+    static TextureTracker tracker;
+    return tracker;
+}
+
+// ------------------------------
+// Rejestracja tekstur
+// ------------------------------
+std::shared_ptr<sf::Texture> TextureTracker::create(const std::string& tag) {
+    auto texture = std::shared_ptr<sf::Texture>(new sf::Texture(), Deleter{});
+    track(texture.get(), tag);
+    return texture;
+}
+
+TextureTracker::UniqueTexture TextureTracker::createUnique(const std::string& tag) {
+    UniqueTexture texture(new sf::Texture());
+    track(texture.get(), tag);
+    return texture;
+}
+
+void TextureTracker::track(const sf::Texture* texture, const std::string& tag) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = textures.find(texture);
+        if (it != textures.end())
+            account(it->second.tag, -static_cast<std::ptrdiff_t>(it->second.bytes), -1);
+        std::size_t bytes = textureBytes(texture);
+        textures[texture] = { tag, bytes };
+        account(tag, static_cast<std::ptrdiff_t>(bytes), 1);
+    }
+    enforceBudget();
+}
+
+void TextureTracker::untrack(const sf::Texture* texture) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = textures.find(texture);
+    if (it == textures.end()) return;
+    account(it->second.tag, -static_cast<std::ptrdiff_t>(it->second.bytes), -1);
+    textures.erase(it);
+}
+
+void TextureTracker::refresh(const sf::Texture* texture) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = textures.find(texture);
+        if (it == textures.end()) return;
+        std::size_t bytes = textureBytes(texture);
+        account(it->second.tag, static_cast<std::ptrdiff_t>(bytes) - static_cast<std::ptrdiff_t>(it->second.bytes), 0);
+        it->second.bytes = bytes;
+    }
+    enforceBudget();
+}
+
+std::string TextureTracker::getTag(const sf::Texture* texture) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = textures.find(texture);
+    return it == textures.end() ? std::string() : it->second.tag;
+}
+
+void TextureTracker::account(const std::string& tag, std::ptrdiff_t deltaBytes, int deltaCount) {
+    TextureTagUsage& usage = tags[tag];
+    usage.bytes = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(usage.bytes) + deltaBytes);
+    usage.count = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(usage.count) + deltaCount);
+    usage.peakBytes = std::max(usage.peakBytes, usage.bytes);
+
+    stats.currentBytes = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(stats.currentBytes) + deltaBytes);
+    stats.textureCount = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(stats.textureCount) + deltaCount);
+    stats.peakBytes = std::max(stats.peakBytes, stats.currentBytes);
+}
+
+// ------------------------------
+// Budżet i wywłaszczanie
+// ------------------------------
+void TextureTracker::setBudget(std::size_t bytes, TextureBudgetPolicy onExceed) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.budgetBytes = bytes;
+        policy = onExceed;
+        overBudgetReported = false;
+    }
+    enforceBudget();
+}
+
+int TextureTracker::addEvictor(const std::string& name, std::function<std::size_t(std::size_t)> evict) {
+    std::lock_guard<std::mutex> lock(mutex);
+    evictors.push_back({ nextEvictorId, name, std::move(evict) });
+    return nextEvictorId++;
+}
+
+void TextureTracker::removeEvictor(int id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    evictors.erase(std::remove_if(evictors.begin(), evictors.end(),
+        [id](const Evictor& e) { return e.id == id; }), evictors.end());
+}
+
+void TextureTracker::enforceBudget() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (stats.budgetBytes == 0 || stats.currentBytes <= stats.budgetBytes) {
+        overBudgetReported = false;
+        return;
+    }
+    if (evicting) return;
+
+    if (policy == TextureBudgetPolicy::Evict) {
+        // Funkcje zwalniające niszczą tekstury (untrack), więc wołane są bez blokady
+        evicting = true;
+        std::vector<Evictor> candidates = evictors;
+        for (const auto& evictor : candidates) {
+            std::size_t excess = stats.currentBytes - stats.budgetBytes;
+            lock.unlock();
+            std::size_t freed = evictor.evict(excess);
+            lock.lock();
+            stats.evictions += freed;
+            if (stats.currentBytes <= stats.budgetBytes) break;
+        }
+        evicting = false;
+        if (stats.currentBytes <= stats.budgetBytes) {
+            overBudgetReported = false;
+            return;
+        }
+    }
+
+    if (!overBudgetReported) {
+        overBudgetReported = true;
+        std::cerr << "[TextureTracker] Texture memory " << megabytes(stats.currentBytes)
+            << " exceeds budget " << megabytes(stats.budgetBytes) << "\n";
+    }
+}
+
+// ------------------------------
+// Raporty
+// ------------------------------
+TextureMemoryStats TextureTracker::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+std::vector<std::pair<std::string, TextureTagUsage>> TextureTracker::getTagUsage() const {
+    std::vector<std::pair<std::string, TextureTagUsage>> result;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        result.assign(tags.begin(), tags.end());
+    }
+    std::sort(result.begin(), result.end(),
+        [](const auto& a, const auto& b) { return a.second.peakBytes > b.second.peakBytes; });
+    return result;
+}
+
+void TextureTracker::dump(std::ostream& out) const {
+    TextureMemoryStats s = getStats();
+    out << "Texture memory: current " << megabytes(s.currentBytes) << ", peak " << megabytes(s.peakBytes)
+        << ", textures " << s.textureCount;
+    if (s.budgetBytes) out << ", budget " << megabytes(s.budgetBytes) << ", evicted " << megabytes(s.evictions);
+    out << "\n";
+
+    for (const auto& [tag, usage] : getTagUsage()) {
+        out << "  " << tag << ": " << megabytes(usage.bytes) << " in " << usage.count
+            << (usage.count == 1 ? " texture" : " textures") << " (peak " << megabytes(usage.peakBytes) << ")\n";
+    }
+}
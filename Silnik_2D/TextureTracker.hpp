@@ -0,0 +1,192 @@
+﻿#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @enum TextureBudgetPolicy
+ * @brief Reakcja na przekroczenie budżetu pamięci tekstur.
+ *
+ * - Warn: komunikat przy przekroczeniu (raz na każde przekroczenie).
+ * - Evict: wywołanie zarejestrowanych pamięci podręcznych, aż zużycie
+ *   spadnie poniżej budżetu; komunikat, jeśli to nie wystarczy.
+ */
+enum class TextureBudgetPolicy { Warn, Evict };
+
+/**
+ * @struct TextureTagUsage
+ * @brief Zużycie pamięci tekstur przez jednego właściciela (tag).
+ */
+struct TextureTagUsage {
+    std::size_t bytes = 0;     ///< Bieżąca liczba bajtów.
+    std::size_t peakBytes = 0; ///< Największa liczba bajtów.
+    std::size_t count = 0;     ///< Liczba żywych tekstur.
+};
+
+/**
+ * @struct TextureMemoryStats
+ * @brief Podsumowanie pamięci tekstur.
+ */
+struct TextureMemoryStats {
+    std::size_t currentBytes = 0; ///< Bieżące zużycie.
+    std::size_t peakBytes = 0;    ///< Największe zużycie.
+    std::size_t textureCount = 0; ///< Liczba żywych tekstur.
+    std::size_t budgetBytes = 0;  ///< Budżet (0 = brak).
+    std::size_t evictions = 0;    ///< Łączna liczba bajtów zwolnionych przez wywłaszczanie.
+};
+
+/**
+ * @class TextureTracker
+ * @brief Globalna ewidencja pamięci tekstur z podziałem na właścicieli.
+ *
+ * Każda śledzona tekstura ma tag (np. nazwę pliku lub właściciela),
+ * a jej rozmiar liczony jest jako szerokość * wysokość * 4 bajty.
+ * Tekstury tworzone przez create()/createUnique() same wypisują się
+ * z ewidencji przy zniszczeniu. Pamięci podręczne mogą zarejestrować
+ * funkcję zwalniającą, wywoływaną przy przekroczeniu budżetu.
+ */
+class TextureTracker {
+private:
+    struct Entry {
+        std::string tag;        ///< Właściciel tekstury.
+        std::size_t bytes = 0;  ///< Rozmiar tekstury.
+    };
+
+    struct Evictor {
+        int id;                                      ///< Identyfikator rejestracji.
+        std::string name;                            ///< Nazwa pamięci podręcznej.
+        std::function<std::size_t(std::size_t)> evict; ///< Zwalnia co najmniej N bajtów, zwraca ile zwolniono.
+    };
+
+    mutable std::mutex mutex;
+    std::unordered_map<const sf::Texture*, Entry> textures; ///< Żywe tekstury.
+    std::unordered_map<std::string, TextureTagUsage> tags;  ///< Zużycie wg tagu.
+    std::vector<Evictor> evictors;                          ///< Zarejestrowane pamięci podręczne.
+    int nextEvictorId = 1;                                  ///< Kolejny identyfikator rejestracji.
+    TextureMemoryStats stats;                               ///< Sumy globalne.
+    TextureBudgetPolicy policy = TextureBudgetPolicy::Warn; ///< Reakcja na przekroczenie budżetu.
+    bool overBudgetReported = false;                        ///< Czy bieżące przekroczenie zostało zgłoszone.
+    bool evicting = false;                                  ///< Czy trwa wywłaszczanie (bez rekurencji).
+
+    TextureTracker() = default;
+
+    /**
+     * @brief Zmienia zużycie tagu i sum globalnych (wywoływane pod blokadą).
+     */
+    void account(const std::string& tag, std::ptrdiff_t deltaBytes, int deltaCount);
+
+    /**
+     * @brief Sprawdza budżet i reaguje zgodnie z polityką.
+     */
+    void enforceBudget();
+
+public:
+    /**
+     * @brief Usuwa teksturę z ewidencji (deleter dla tekstur z create()).
+     */
+    struct Deleter {
+        void operator()(sf::Texture* texture) const {
+            TextureTracker::get().untrack(texture);
+            delete texture;
+        }
+    };
+
+    using UniqueTexture = std::unique_ptr<sf::Texture, Deleter>; ///< Śledzona tekstura na wyłączność.
+
+    /**
+     * @brief Zwraca globalną instancję.
+     * @return Referencja do ewidencji.
+     */
+    static TextureTracker& get();
+
+    TextureTracker(const TextureTracker&) = delete;
+    TextureTracker& operator=(const TextureTracker&) = delete;
+
+    /**
+     * @brief Tworzy pustą, śledzoną teksturę współdzieloną.
+     *
+     * Po wczytaniu lub zmianie rozmiaru należy wywołać refresh().
+     *
+     * @param tag Właściciel tekstury.
+     * @return Tekstura wypisywana z ewidencji przy zniszczeniu.
+     */
+    std::shared_ptr<sf::Texture> create(const std::string& tag);
+
+    /**
+     * @brief Tworzy pustą, śledzoną teksturę na wyłączność.
+     * @param tag Właściciel tekstury.
+     * @return Tekstura wypisywana z ewidencji przy zniszczeniu.
+     */
+    UniqueTexture createUnique(const std::string& tag);
+
+    /**
+     * @brief Dopisuje istniejącą teksturę (np. RenderTexture) do ewidencji.
+     * @param texture Tekstura.
+     * @param tag Właściciel tekstury.
+     */
+    void track(const sf::Texture* texture, const std::string& tag);
+
+    /**
+     * @brief Usuwa teksturę z ewidencji.
+     * @param texture Tekstura.
+     */
+    void untrack(const sf::Texture* texture);
+
+    /**
+     * @brief Aktualizuje rozmiar tekstury po wczytaniu lub zmianie rozmiaru.
+     * @param texture Tekstura.
+     */
+    void refresh(const sf::Texture* texture);
+
+    /**
+     * @brief Zwraca tag tekstury.
+     * @param texture Tekstura.
+     * @return Tag lub pusty napis, jeśli tekstura nie jest śledzona.
+     */
+    std::string getTag(const sf::Texture* texture) const;
+
+    /**
+     * @brief Ustawia budżet pamięci tekstur.
+     * @param bytes Budżet w bajtach (0 = brak).
+     * @param onExceed Reakcja na przekroczenie.
+     */
+    void setBudget(std::size_t bytes, TextureBudgetPolicy onExceed);
+
+    /**
+     * @brief Rejestruje pamięć podręczną, którą można opróżnić przy przekroczeniu budżetu.
+     * @param name Nazwa (do raportów).
+     * @param evict Funkcja zwalniająca co najmniej podaną liczbę bajtów; zwraca liczbę zwolnionych.
+     * @return Identyfikator rejestracji.
+     */
+    int addEvictor(const std::string& name, std::function<std::size_t(std::size_t)> evict);
+
+    /**
+     * @brief Wyrejestrowuje pamięć podręczną.
+     * @param id Identyfikator z addEvictor().
+     */
+    void removeEvictor(int id);
+
+    /**
+     * @brief Zwraca sumy globalne.
+     * @return Bieżące i szczytowe zużycie, liczba tekstur, budżet.
+     */
+    TextureMemoryStats getStats() const;
+
+    /**
+     * @brief Zwraca zużycie wg tagów, od największego.
+     * @return Lista par (tag, zużycie).
+     */
+    std::vector<std::pair<std::string, TextureTagUsage>> getTagUsage() const;
+
+    /**
+     * @brief Wypisuje raport zużycia.
+     * @param out Strumień wyjściowy.
+     */
+    void dump(std::ostream& out) const;
+};
@@ -0,0 +1,549 @@
+﻿#include "TiledCanvas.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#define NOMINMAX
+#include <Windows.h>
+
+namespace {
+/**
+ * @brief Nagłówek trwałego pliku danych kanwy.
+ *
+ * Plik otwarty ponownie zachowuje kafle tylko wtedy, gdy nagłówek zgadza się
+ * z tworzoną kanwą — inny rozmiar lub bok kafla zmieniłby układ kafli w pliku.
+ */
+struct BackingHeader {
+    std::uint32_t magic;    ///< BackingMagic.
+    std::uint32_t version;  ///< BackingVersion.
+    std::uint32_t width;    ///< Szerokość kanwy.
+    std::uint32_t height;   ///< Wysokość kanwy.
+    std::uint32_t tileSize; ///< Bok kafla.
+};
+
+constexpr std::uint32_t BackingMagic = 0x54443253;  ///< "S2DT" (little-endian).
+constexpr std::uint32_t BackingVersion = 1;         ///< Wersja układu pliku.
+constexpr std::uint64_t BackingHeaderBytes = 4096;  ///< Miejsce na nagłówek (strona — kafle pozostają wyrównane do stron).
+
+// Odczyt pliku porcjami — dekodery strumieniowe nie trzymają całego pliku w pamięci
+class ByteReader {
+public:
+    explicit ByteReader(const std::string& filename)
+        : in(filename, std::ios::binary), buffer(1 << 16) {
+    }
+
+    // Kolejny bajt lub -1 na końcu pliku
+    int get() {
+        if (pos == end && !refill()) {
+            exhausted = true;
+            return -1;
+        }
+        return buffer[pos++];
+    }
+
+    std::size_t read(std::uint8_t* out, std::size_t count) {
+        std::size_t done = 0;
+        while (done < count && (pos < end || refill())) {
+            const std::size_t n = std::min(count - done, end - pos);
+            std::memcpy(out + done, buffer.data() + pos, n);
+            pos += n;
+            done += n;
+        }
+        if (done < count) exhausted = true;
+        return done;
+    }
+
+    void seek(std::uint64_t offset) {
+        in.clear();
+        in.seekg(static_cast<std::streamoff>(offset));
+        pos = end = 0;
+        exhausted = false;
+    }
+
+    bool skip(std::size_t count) {
+        while (count-- > 0)
+            if (get() < 0) return false;
+        return true;
+    }
+
+    bool failed() const { return exhausted; }
+
+private:
+    bool refill() {
+        if (!in) return false;
+        in.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        end = static_cast<std::size_t>(in.gcount());
+        pos = 0;
+        return end > 0;
+    }
+
+    std::ifstream in;
+    std::vector<std::uint8_t> buffer;
+    std::size_t pos = 0, end = 0;
+    bool exhausted = false;
+};
+
+std::uint32_t readBE32(const std::uint8_t* p) { return std::uint32_t(p[0]) << 24 | std::uint32_t(p[1]) << 16 | std::uint32_t(p[2]) << 8 | p[3]; }
+std::uint32_t readBE16(const std::uint8_t* p) { return std::uint32_t(p[0]) << 8 | p[1]; }
+std::uint32_t readLE32(const std::uint8_t* p) { return std::uint32_t(p[3]) << 24 | std::uint32_t(p[2]) << 16 | std::uint32_t(p[1]) << 8 | p[0]; }
+std::uint32_t readLE16(const std::uint8_t* p) { return std::uint32_t(p[1]) << 8 | p[0]; }
+
+// Wysokość BMP: ujemna oznacza wiersze od góry
+std::uint32_t bmpRows(std::uint32_t height) { return static_cast<std::int32_t>(height) < 0 ? 0u - height : height; }
+
+// Dekoder QOI (https://qoiformat.org); reader ustawiony za nagłówkiem
+template <typename Row>
+bool decodeQoi(ByteReader& in, sf::Vector2u size, Row row) {
+    std::array<sf::Color, 64> index;
+    index.fill(sf::Color(0, 0, 0, 0));
+    sf::Color px(0, 0, 0, 255);
+    std::vector<std::uint8_t> line(static_cast<std::size_t>(size.x) * 4);
+    int run = 0;
+
+    for (unsigned int y = 0; y < size.y; ++y) {
+        for (unsigned int x = 0; x < size.x; ++x) {
+            if (run > 0) {
+                --run;
+            }
+            else {
+                const int op = in.get();
+                if (op == 0xFE || op == 0xFF) {
+                    px.r = static_cast<std::uint8_t>(in.get());
+                    px.g = static_cast<std::uint8_t>(in.get());
+                    px.b = static_cast<std::uint8_t>(in.get());
+                    if (op == 0xFF) px.a = static_cast<std::uint8_t>(in.get());
+                }
+                else if ((op & 0xC0) == 0x00) {
+                    px = index[op & 0x3F];
+                }
+                else if ((op & 0xC0) == 0x40) {
+                    px.r = static_cast<std::uint8_t>(px.r + ((op >> 4) & 3) - 2);
+                    px.g = static_cast<std::uint8_t>(px.g + ((op >> 2) & 3) - 2);
+                    px.b = static_cast<std::uint8_t>(px.b + (op & 3) - 2);
+                }
+                else if ((op & 0xC0) == 0x80) {
+                    const int second = in.get();
+                    const int dg = (op & 0x3F) - 32;
+                    px.r = static_cast<std::uint8_t>(px.r + dg - 8 + ((second >> 4) & 0x0F));
+                    px.g = static_cast<std::uint8_t>(px.g + dg);
+                    px.b = static_cast<std::uint8_t>(px.b + dg - 8 + (second & 0x0F));
+                }
+                else {
+                    run = op & 0x3F;
+                }
+                index[(px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11) % 64] = px;
+            }
+            std::uint8_t* out = line.data() + static_cast<std::size_t>(x) * 4;
+            out[0] = px.r;
+            out[1] = px.g;
+            out[2] = px.b;
+            out[3] = px.a;
+        }
+        if (in.failed()) return false;
+        row(y, line.data());
+    }
+    return true;
+}
+
+// Nieskompresowany 24-bitowy BMP (BGR, wiersze wyrównane do 4 bajtów); reader ustawiony na pikselach
+template <typename Row>
+bool decodeBmp24(ByteReader& in, sf::Vector2u size, bool bottomUp, Row row) {
+    const std::size_t stride = (static_cast<std::size_t>(size.x) * 3 + 3) & ~std::size_t(3);
+    std::vector<std::uint8_t> src(stride), line(static_cast<std::size_t>(size.x) * 4);
+
+    for (unsigned int i = 0; i < size.y; ++i) {
+        if (in.read(src.data(), stride) != stride) return false;
+        for (unsigned int x = 0; x < size.x; ++x) {
+            line[x * 4] = src[x * 3 + 2];
+            line[x * 4 + 1] = src[x * 3 + 1];
+            line[x * 4 + 2] = src[x * 3];
+            line[x * 4 + 3] = 255;
+        }
+        row(bottomUp ? size.y - 1 - i : i, line.data());
+    }
+    return true;
+}
+} // namespace
+
+// ------------------------------
+// Mapowanie pliku w pamięć
+// ------------------------------
+bool TiledCanvas::map(const std::filesystem::path& path, std::uint64_t bytes, bool temporary) {
+    DWORD attributes = temporary ? (FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE) : FILE_ATTRIBUTE_NORMAL;
+    HANDLE file = ::CreateFileW(path.wstring().c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+        temporary ? CREATE_ALWAYS : OPEN_ALWAYS, attributes, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    bool existed = !temporary && ::GetLastError() == ERROR_ALREADY_EXISTS;
+    const std::uint64_t total = BackingHeaderBytes + bytes;
+    LARGE_INTEGER fileSize{};
+    if (existed && (!::GetFileSizeEx(file, &fileSize) || static_cast<std::uint64_t>(fileSize.QuadPart) < total))
+        existed = false; // plik krótszy niż kanwa — nie zawiera wszystkich kafli
+
+    // Mapowanie powiększa plik do wymaganego rozmiaru
+    HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READWRITE,
+        static_cast<DWORD>(total >> 32), static_cast<DWORD>(total & 0xFFFFFFFFu), nullptr);
+    if (!mapping) {
+        ::CloseHandle(file);
+        return false;
+    }
+
+    void* view = ::MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    if (!view) {
+        ::CloseHandle(mapping);
+        ::CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    mappedView = view;
+    pixels = static_cast<std::uint8_t*>(view) + BackingHeaderBytes;
+
+    // Istniejący plik danych zachowuje zawartość z poprzedniej sesji, jeśli
+    // opisuje kanwę o tym samym układzie; w przeciwnym razie jest traktowany jak nowy
+    BackingHeader* header = static_cast<BackingHeader*>(view);
+    const BackingHeader expected{ BackingMagic, BackingVersion, size.x, size.y, tileSize };
+    if (existed && std::memcmp(header, &expected, sizeof(expected)) == 0)
+        std::fill(tileWritten.begin(), tileWritten.end(), std::uint8_t(1));
+    else if (existed)
+        std::cout << "WARNING: Tiled canvas file does not match the canvas, starting fresh: " << path.string() << "\n";
+    std::memcpy(header, &expected, sizeof(expected));
+    return true;
+}
+
+void TiledCanvas::unmap() {
+    if (mappedView) ::UnmapViewOfFile(mappedView);
+    if (mappingHandle) ::CloseHandle(mappingHandle);
+    if (fileHandle) ::CloseHandle(fileHandle);
+    mappedView = nullptr;
+    pixels = nullptr;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+}
+
+TiledCanvas::TiledCanvas() {
+    evictorId = TextureTracker::get().addEvictor("TiledCanvas",
+        [this](std::size_t bytes) { return evictTiles(bytes); });
+}
+
+TiledCanvas::~TiledCanvas() {
+    TextureTracker::get().removeEvictor(evictorId);
+    clear();
+}
+
+// ------------------------------
+// Tworzenie i wczytywanie kanwy
+// ------------------------------
+bool TiledCanvas::create(unsigned int w, unsigned int h, sf::Color color,
+    const std::filesystem::path& backingFile, unsigned int tile)
+{
+    clear();
+    if (w == 0 || h == 0 || tile == 0)
+        return false;
+
+    size = { w, h };
+    tileSize = tile;
+    tileCount = { (w + tile - 1) / tile, (h + tile - 1) / tile };
+    fillColor = color;
+
+    const std::size_t tiles = static_cast<std::size_t>(tileCount.x) * tileCount.y;
+    const std::uint64_t tileBytes = static_cast<std::uint64_t>(tile) * tile * 4;
+    tileWritten.assign(tiles, 0);
+
+    solidTile.resize(static_cast<std::size_t>(tileBytes));
+    for (std::size_t i = 0; i < solidTile.size(); i += 4) {
+        solidTile[i] = color.r;
+        solidTile[i + 1] = color.g;
+        solidTile[i + 2] = color.b;
+        solidTile[i + 3] = color.a;
+    }
+
+    bool temporary = backingFile.empty();
+    std::filesystem::path path = backingFile;
+    if (temporary) {
+        path = std::filesystem::temp_directory_path()
+            / ("silnik2d_tiles_" + std::to_string(reinterpret_cast<std::uintptr_t>(this)) + ".bin");
+    }
+
+    if (!map(path, tileBytes * tiles, temporary)) {
+        std::cout << "ERROR: Cannot map tiled canvas file: " << path.string() << "\n";
+        clear();
+        return false;
+    }
+    return true;
+}
+
+bool TiledCanvas::loadFromFile(const std::string& filename) {
+    ByteReader in(filename);
+    std::uint8_t header[34] = {};
+    const std::size_t got = in.read(header, sizeof(header));
+
+    sf::Vector2u imgSize;
+    auto writeRow = [this, &imgSize](unsigned int y, const std::uint8_t* row) {
+        writePixels(row, { imgSize.x, 1 }, { 0, static_cast<int>(y) });
+    };
+
+    // Formaty strumieniowe — wiersze trafiają prosto do kafli
+    if (got >= 14 && std::memcmp(header, "qoif", 4) == 0) {
+        imgSize = { readBE32(header + 4), readBE32(header + 8) };
+        if (!create(imgSize.x, imgSize.y, sf::Color::Transparent))
+            return false;
+        in.seek(14);
+        if (decodeQoi(in, imgSize, writeRow))
+            return true;
+        std::cout << "ERROR: Truncated QOI file: " << filename << "\n";
+        clear();
+        return false;
+    }
+
+    const std::int32_t bmpWidth = static_cast<std::int32_t>(readLE32(header + 18));
+    const std::int32_t bmpHeight = static_cast<std::int32_t>(readLE32(header + 22));
+    if (got >= 34 && header[0] == 'B' && header[1] == 'M' && readLE16(header + 28) == 24
+        && readLE32(header + 30) == 0 && bmpWidth > 0 && bmpHeight != 0) {
+        imgSize = { static_cast<unsigned int>(bmpWidth), bmpRows(readLE32(header + 22)) };
+        if (!create(imgSize.x, imgSize.y, sf::Color::Transparent))
+            return false;
+        in.seek(readLE32(header + 10));
+        if (decodeBmp24(in, imgSize, bmpHeight > 0, writeRow))
+            return true;
+        std::cout << "ERROR: Truncated BMP file: " << filename << "\n";
+        clear();
+        return false;
+    }
+
+    // Pozostałe formaty (PNG, JPEG, ...) dekoduje SFML — cały obraz naraz
+    sf::Image image;
+    if (!image.loadFromFile(filename))
+        return false;
+
+    imgSize = image.getSize();
+    if (!create(imgSize.x, imgSize.y, sf::Color::Transparent))
+        return false;
+
+    writeImage(image, { 0, 0 });
+    return true;
+}
+
+std::optional<sf::Vector2u> TiledCanvas::probeImageSize(const std::string& filename) {
+    ByteReader in(filename);
+    std::uint8_t header[26] = {};
+    const std::size_t got = in.read(header, sizeof(header));
+
+    if (got >= 24 && std::memcmp(header, "\x89PNG\r\n\x1A\n", 8) == 0)
+        return sf::Vector2u(readBE32(header + 16), readBE32(header + 20));
+    if (got >= 12 && std::memcmp(header, "qoif", 4) == 0)
+        return sf::Vector2u(readBE32(header + 4), readBE32(header + 8));
+    if (got >= 26 && header[0] == 'B' && header[1] == 'M')
+        return sf::Vector2u(readLE32(header + 18), bmpRows(readLE32(header + 22)));
+    if (got >= 10 && std::memcmp(header, "GIF", 3) == 0)
+        return sf::Vector2u(readLE16(header + 6), readLE16(header + 8));
+
+    // JPEG: segmenty aż do nagłówka ramki SOFn (bez DHT, JPG i DAC)
+    if (got >= 4 && header[0] == 0xFF && header[1] == 0xD8) {
+        in.seek(2);
+        while (in.get() == 0xFF) {
+            int marker = in.get();
+            while (marker == 0xFF) marker = in.get();
+            std::uint8_t length[2];
+            if (marker < 0 || in.read(length, 2) != 2) break;
+            if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+                std::uint8_t frame[5];
+                if (in.read(frame, 5) != 5) break;
+                return sf::Vector2u(readBE16(frame + 3), readBE16(frame + 1));
+            }
+            if (readBE16(length) < 2 || !in.skip(readBE16(length) - 2)) break;
+        }
+    }
+    return std::nullopt;
+}
+
+void TiledCanvas::clear() {
+    lru.clear();
+    resident.clear();
+    unmap();
+    tileWritten.clear();
+    solidTile.clear();
+    solidTile.shrink_to_fit();
+    size = {};
+    tileCount = {};
+}
+
+// ------------------------------
+// Dostęp do pikseli kafli
+// ------------------------------
+std::uint8_t* TiledCanvas::writableTile(std::size_t index) {
+    std::uint8_t* tile = pixels + index * solidTile.size();
+    if (!tileWritten[index]) {
+        std::memcpy(tile, solidTile.data(), solidTile.size());
+        tileWritten[index] = 1;
+    }
+    return tile;
+}
+
+void TiledCanvas::writeImage(const sf::Image& image, sf::Vector2i position) {
+    writePixels(image.getPixelsPtr(), image.getSize(), position);
+}
+
+void TiledCanvas::writePixels(const std::uint8_t* src, sf::Vector2u srcSize, sf::Vector2i position) {
+    if (!pixels) return;
+
+    // Część źródła leżąca na kanwie
+    const int x0 = std::max(0, position.x), y0 = std::max(0, position.y);
+    const int x1 = static_cast<int>(std::min<std::int64_t>(size.x, std::int64_t(position.x) + srcSize.x));
+    const int y1 = static_cast<int>(std::min<std::int64_t>(size.y, std::int64_t(position.y) + srcSize.y));
+    if (x0 >= x1 || y0 >= y1) return;
+
+    const int ts = static_cast<int>(tileSize);
+    for (int ty = y0 / ts; ty * ts < y1; ++ty) {
+        for (int tx = x0 / ts; tx * ts < x1; ++tx) {
+            const std::size_t index = static_cast<std::size_t>(ty) * tileCount.x + tx;
+            std::uint8_t* tile = writableTile(index);
+
+            const int ox = tx * ts, oy = ty * ts;
+            const int sx0 = std::max(x0, ox), sx1 = std::min(x1, ox + ts);
+            const int sy0 = std::max(y0, oy), sy1 = std::min(y1, oy + ts);
+
+            for (int y = sy0; y < sy1; ++y) {
+                const std::uint8_t* row = src + (static_cast<std::size_t>(y - position.y) * srcSize.x + (sx0 - position.x)) * 4;
+                std::memcpy(tile + (static_cast<std::size_t>(y - oy) * tileSize + (sx0 - ox)) * 4, row, static_cast<std::size_t>(sx1 - sx0) * 4);
+            }
+
+            auto it = resident.find(index);
+            if (it != resident.end())
+                it->second->stale = true;
+        }
+    }
+}
+
+sf::Image TiledCanvas::readImage(const sf::IntRect& area, sf::Color outside) const {
+    const sf::Vector2u imgSize(static_cast<unsigned int>(std::max(0, area.size.x)), static_cast<unsigned int>(std::max(0, area.size.y)));
+    std::vector<std::uint8_t> buffer(static_cast<std::size_t>(imgSize.x) * imgSize.y * 4);
+    for (std::size_t i = 0; i < buffer.size(); i += 4) {
+        buffer[i] = outside.r;
+        buffer[i + 1] = outside.g;
+        buffer[i + 2] = outside.b;
+        buffer[i + 3] = outside.a;
+    }
+
+    // Część fragmentu leżąca na kanwie
+    const int x0 = std::max(0, area.position.x), y0 = std::max(0, area.position.y);
+    const int x1 = std::min(static_cast<int>(size.x), area.position.x + area.size.x);
+    const int y1 = std::min(static_cast<int>(size.y), area.position.y + area.size.y);
+
+    std::uint8_t* dst = buffer.data();
+    const int ts = static_cast<int>(tileSize);
+    for (int ty = y0 / ts; pixels && x0 < x1 && ty * ts < y1; ++ty) {
+        for (int tx = x0 / ts; tx * ts < x1; ++tx) {
+            const std::size_t index = static_cast<std::size_t>(ty) * tileCount.x + tx;
+            const std::uint8_t* tile = tileWritten[index] ? pixels + index * solidTile.size() : solidTile.data();
+
+            const int ox = tx * ts, oy = ty * ts;
+            const int sx0 = std::max(x0, ox), sx1 = std::min(x1, ox + ts);
+            const int sy0 = std::max(y0, oy), sy1 = std::min(y1, oy + ts);
+            for (int y = sy0; y < sy1; ++y) {
+                std::memcpy(dst + (static_cast<std::size_t>(y - area.position.y) * area.size.x + (sx0 - area.position.x)) * 4,
+                    tile + (static_cast<std::size_t>(y - oy) * tileSize + (sx0 - ox)) * 4, static_cast<std::size_t>(sx1 - sx0) * 4);
+            }
+        }
+    }
+
+    sf::Image image;
+    image.resize(imgSize, buffer.data());
+    return image;
+}
+
+// ------------------------------
+// Pula kafli na GPU (LRU)
+// ------------------------------
+const sf::Texture& TiledCanvas::acquireTile(std::size_t index) {
+    const std::uint8_t* data = tileWritten[index] ? pixels + index * solidTile.size() : solidTile.data();
+
+    auto it = resident.find(index);
+    if (it != resident.end()) {
+        auto node = it->second;
+        lru.splice(lru.begin(), lru, node);
+        if (node->stale) {
+            node->texture->update(data);
+            node->stale = false;
+            ++uploadCount;
+        }
+        node->lastUsedFrame = frame;
+        return *node->texture;
+    }
+
+    // Odzysk najdawniej używanej tekstury, o ile nie jest potrzebna w tej klatce
+    TextureTracker::UniqueTexture texture;
+    if (lru.size() >= maxResidentTiles && lru.back().lastUsedFrame != frame) {
+        texture = std::move(lru.back().texture);
+        resident.erase(lru.back().index);
+        lru.pop_back();
+    }
+    else {
+        texture = TextureTracker::get().createUnique("TiledCanvas tiles");
+        if (!texture->resize({ tileSize, tileSize }))
+            std::cout << "ERROR: Cannot allocate tile texture\n";
+        TextureTracker::get().refresh(texture.get());
+    }
+
+    texture->update(data);
+    ++uploadCount;
+
+    lru.push_front({ index, std::move(texture), frame, false });
+    resident[index] = lru.begin();
+    return *lru.front().texture;
+}
+
+std::size_t TiledCanvas::evictTiles(std::size_t bytes) {
+    const std::size_t tileBytes = static_cast<std::size_t>(tileSize) * tileSize * 4;
+    std::size_t freed = 0;
+    while (freed < bytes && !lru.empty() && lru.back().lastUsedFrame != frame) {
+        resident.erase(lru.back().index);
+        lru.pop_back();
+        freed += tileBytes;
+    }
+    return freed;
+}
+
+// ------------------------------
+// Rysowanie widocznych kafli
+// ------------------------------
+void TiledCanvas::draw(sf::RenderTarget& target, const sf::View& view) {
+    if (!pixels) return;
+    ++frame;
+
+    const sf::Vector2f topLeft = view.getCenter() - view.getSize() / 2.f;
+    const sf::Vector2f bottomRight = topLeft + view.getSize();
+    const float ts = static_cast<float>(tileSize);
+
+    const int tx0 = std::max(0, static_cast<int>(std::floor(topLeft.x / ts)));
+    const int ty0 = std::max(0, static_cast<int>(std::floor(topLeft.y / ts)));
+    const int tx1 = std::min(static_cast<int>(tileCount.x) - 1, static_cast<int>(std::floor(bottomRight.x / ts)));
+    const int ty1 = std::min(static_cast<int>(tileCount.y) - 1, static_cast<int>(std::floor(bottomRight.y / ts)));
+    if (tx0 > tx1 || ty0 > ty1) return;
+
+    const sf::View previous = target.getView();
+    target.setView(view);
+
+    for (int ty = ty0; ty <= ty1; ++ty) {
+        for (int tx = tx0; tx <= tx1; ++tx) {
+            const std::size_t index = static_cast<std::size_t>(ty) * tileCount.x + tx;
+            const int w = static_cast<int>(std::min(tileSize, size.x - tx * tileSize));
+            const int h = static_cast<int>(std::min(tileSize, size.y - ty * tileSize));
+
+            sf::Sprite sprite(acquireTile(index), sf::IntRect({ 0, 0 }, { w, h }));
+            sprite.setPosition({ tx * ts, ty * ts });
+            target.draw(sprite, sf::BlendNone);
+        }
+    }
+
+    target.setView(previous);
+
+    // Zwolnienie nadmiarowych kafli, które nie były potrzebne w tej klatce
+    while (lru.size() > maxResidentTiles && lru.back().lastUsedFrame != frame) {
+        resident.erase(lru.back().index);
+        lru.pop_back();
+    }
+}
@@ -0,0 +1,232 @@
+﻿#pragma once
+#include <SFML/Graphics.hpp>
+#include "TextureTracker.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class TiledCanvas
+ * @brief Wirtualna kanwa kafelkowa dla obrazów większych niż limit tekstury GPU.
+ *
+ * Piksele przechowywane są w pliku mapowanym w pamięć, w układzie
+ * "kafel po kaflu" (każdy kafel zajmuje ciągły fragment pliku), dzięki
+ * czemu system operacyjny sam decyduje, które fragmenty obrazu są w RAM.
+ * Na GPU trzymana jest jedynie ograniczona pula kafli (LRU) — wysyłane są
+ * tylko kafle przecinające bieżący widok.
+ *
+ * Kafle, do których jeszcze nic nie zapisano, traktowane są jako
+ * jednolity kolor tła i nie zajmują stron pliku.
+ *
+ * QOI i nieskompresowany 24-bitowy BMP wczytywane są strumieniowo —
+ * wiersz po wierszu prosto do kafli, bez obrazu w pamięci.
+ */
+class TiledCanvas {
+public:
+    static constexpr unsigned int DefaultTileSize = 512;       ///< Domyślny bok kafla w pikselach.
+    static constexpr std::size_t DefaultMaxResidentTiles = 64; ///< Domyślny rozmiar puli kafli na GPU.
+
+private:
+    /**
+     * @struct ResidentTile
+     * @brief Kafel obecny w pamięci GPU.
+     */
+    struct ResidentTile {
+        std::size_t index;                   ///< Indeks kafla.
+        TextureTracker::UniqueTexture texture; ///< Tekstura kafla.
+        std::uint64_t lastUsedFrame = 0;     ///< Numer klatki ostatniego użycia.
+        bool stale = false;                  ///< Czy dane w pliku zmieniły się od wysłania.
+    };
+
+    sf::Vector2u size{};        ///< Rozmiar całej kanwy.
+    sf::Vector2u tileCount{};   ///< Liczba kafli w poziomie i pionie.
+    unsigned int tileSize = DefaultTileSize; ///< Bok kafla.
+    sf::Color fillColor;        ///< Kolor kafli, do których nic nie zapisano.
+
+    void* fileHandle = nullptr;    ///< Uchwyt pliku (HANDLE).
+    void* mappingHandle = nullptr; ///< Uchwyt mapowania (HANDLE).
+    void* mappedView = nullptr;    ///< Początek zmapowanego widoku (nagłówek pliku).
+    std::uint8_t* pixels = nullptr; ///< Piksele kafli (za nagłówkiem pliku).
+
+    std::vector<std::uint8_t> tileWritten; ///< Czy kafel ma własne dane w pliku.
+    std::vector<std::uint8_t> solidTile;   ///< Bufor jednolitego kafla do wysyłki.
+
+    std::size_t maxResidentTiles = DefaultMaxResidentTiles; ///< Limit kafli na GPU.
+    std::list<ResidentTile> lru;                            ///< Kafle na GPU, od najświeższego.
+    std::unordered_map<std::size_t, std::list<ResidentTile>::iterator> resident; ///< Indeks kafla -> pozycja w LRU.
+    std::uint64_t frame = 0;     ///< Licznik wywołań draw().
+    std::size_t uploadCount = 0; ///< Łączna liczba wysłanych kafli.
+    int evictorId = 0;           ///< Rejestracja w TextureTracker.
+
+    /**
+     * @brief Tworzy i mapuje plik o zadanym rozmiarze.
+     *
+     * Plik zaczyna się nagłówkiem z rozmiarem kanwy i bokiem kafla.
+     * Istniejący plik z pasującym nagłówkiem zachowuje kafle; inny
+     * (lub za krótki) jest traktowany jak nowy.
+     *
+     * @param path Ścieżka pliku.
+     * @param bytes Rozmiar danych kafli w bajtach (bez nagłówka).
+     * @param temporary Czy plik ma zostać usunięty po zamknięciu.
+     * @return true jeśli mapowanie się powiodło.
+     */
+    bool map(const std::filesystem::path& path, std::uint64_t bytes, bool temporary);
+
+    /**
+     * @brief Zwalnia mapowanie i zamyka plik.
+     */
+    void unmap();
+
+    /**
+     * @brief Zwraca wskaźnik do pikseli kafla w pliku (materializując go w razie potrzeby).
+     * @param index Indeks kafla.
+     * @return Wskaźnik do tileSize * tileSize pikseli RGBA.
+     */
+    std::uint8_t* writableTile(std::size_t index);
+
+    /**
+     * @brief Kopiuje piksele do kafli (część poza kanwą jest pomijana).
+     * @param src Piksele RGBA, wiersz po wierszu.
+     * @param srcSize Rozmiar źródła.
+     * @param position Lewy górny róg docelowego obszaru.
+     */
+    void writePixels(const std::uint8_t* src, sf::Vector2u srcSize, sf::Vector2i position);
+
+    /**
+     * @brief Zwraca teksturę kafla, wysyłając go na GPU jeśli to konieczne.
+     * @param index Indeks kafla.
+     * @return Tekstura kafla.
+     */
+    const sf::Texture& acquireTile(std::size_t index);
+
+    /**
+     * @brief Zwalnia kafle nieużyte w bieżącej klatce (przekroczenie budżetu tekstur).
+     * @param bytes Liczba bajtów do zwolnienia.
+     * @return Liczba zwolnionych bajtów.
+     */
+    std::size_t evictTiles(std::size_t bytes);
+
+public:
+    TiledCanvas();
+    ~TiledCanvas();
+
+    TiledCanvas(const TiledCanvas&) = delete;
+    TiledCanvas& operator=(const TiledCanvas&) = delete;
+
+    /**
+     * @brief Tworzy pustą kanwę wypełnioną kolorem.
+     *
+     * Nie alokuje pikseli — plik jest tylko rezerwowany, a kafle
+     * materializują się przy pierwszym zapisie.
+     *
+     * @param w Szerokość.
+     * @param h Wysokość.
+     * @param color Kolor tła.
+     * @param backingFile Plik danych (istniejący, utworzony dla tego samego rozmiaru
+     *                    i boku kafla, zachowuje zawartość); pusty — plik tymczasowy
+     *                    usuwany po zamknięciu.
+     * @param tile Bok kafla.
+     * @return true jeśli udało się utworzyć kanwę.
+     */
+    bool create(unsigned int w, unsigned int h, sf::Color color,
+        const std::filesystem::path& backingFile = {}, unsigned int tile = DefaultTileSize);
+
+    /**
+     * @brief Wczytuje obraz z pliku do nowej kanwy kafelkowej.
+     *
+     * QOI i nieskompresowany 24-bitowy BMP dekodowane są wierszami prosto
+     * do kafli; pozostałe formaty dekoduje SFML do jednego sf::Image.
+     *
+     * @param filename Ścieżka do pliku graficznego.
+     * @return true jeśli wczytano poprawnie.
+     */
+    bool loadFromFile(const std::string& filename);
+
+    /**
+     * @brief Odczytuje rozmiar obrazu z nagłówka pliku (bez dekodowania pikseli).
+     *
+     * Obsługuje PNG, JPEG, BMP, GIF i QOI.
+     *
+     * @param filename Ścieżka do pliku graficznego.
+     * @return Rozmiar lub brak, jeśli format nie został rozpoznany.
+     */
+    static std::optional<sf::Vector2u> probeImageSize(const std::string& filename);
+
+    /**
+     * @brief Kopiuje obraz do kanwy w zadanym miejscu.
+     * @param image Obraz źródłowy.
+     * @param position Lewy górny róg docelowego obszaru; część poza kanwą jest pomijana.
+     */
+    void writeImage(const sf::Image& image, sf::Vector2i position);
+
+    /**
+     * @brief Kopiuje fragment kanwy do obrazu (z pliku, bez odczytu z GPU).
+     * @param area Fragment kanwy; może wychodzić poza jej granice.
+     * @param outside Kolor pikseli poza kanwą.
+     * @return Obraz o rozmiarze fragmentu.
+     */
+    sf::Image readImage(const sf::IntRect& area, sf::Color outside) const;
+
+    /**
+     * @brief Rysuje kafle widoczne w podanym widoku.
+     *
+     * Widok jest ustawiany na czas rysowania i przywracany po nim. Kafle są
+     * kopiowane bez mieszania, więc cel zawiera dokładnie piksele kafli
+     * (także przezroczyste) — to samo, co zwraca readImage().
+     *
+     * @param target Cel renderowania.
+     * @param view Widok określający widoczny fragment kanwy.
+     */
+    void draw(sf::RenderTarget& target, const sf::View& view);
+
+    /**
+     * @brief Zwalnia kanwę, kafle na GPU i plik danych.
+     */
+    void clear();
+
+    /**
+     * @brief Ustawia limit kafli przechowywanych na GPU.
+     * @param count Maksymalna liczba kafli.
+     */
+    void setMaxResidentTiles(std::size_t count) { maxResidentTiles = count; }
+
+    /**
+     * @brief Sprawdza, czy kanwa jest utworzona.
+     * @return true jeśli kanwa zawiera obraz.
+     */
+    bool isActive() const { return pixels != nullptr; }
+
+    /**
+     * @brief Zwraca rozmiar kanwy.
+     * @return Rozmiar w pikselach.
+     */
+    sf::Vector2u getSize() const { return size; }
+
+    /**
+     * @brief Zwraca liczbę kafli obecnie przechowywanych na GPU.
+     * @return Liczba kafli.
+     */
+    std::size_t getResidentTileCount() const { return lru.size(); }
+
+    /**
+     * @brief Zwraca łączną liczbę wysłanych kafli.
+     * @return Liczba wysyłek.
+     */
+    std::size_t getUploadCount() const { return uploadCount; }
+
+    /**
+     * @brief Sprawdza, czy obraz zmieści się w pojedynczej teksturze GPU.
+     * @param w Szerokość.
+     * @param h Wysokość.
+     * @return true jeśli nie przekracza limitu tekstury.
+     */
+    static bool fitsInTexture(unsigned int w, unsigned int h) {
+        const unsigned int limit = sf::Texture::getMaximumSize();
+        return w <= limit && h <= limit;
+    }
+};